@@ -0,0 +1,57 @@
+package com.twilio.video.app.benchmark
+
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import com.twilio.video.NetworkQualityLevel
+import com.twilio.video.app.participant.ParticipantManager
+import com.twilio.video.app.participant.ParticipantViewState
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+
+const val PARTICIPANT_COUNT = 50
+
+fun remoteParticipants() = (0 until PARTICIPANT_COUNT).map {
+    ParticipantViewState("PA$it", "Participant $it")
+}
+
+/**
+ * Drives [ParticipantManager] with the churn of a large room. Run with
+ * ./gradlew connectedCommunityBenchmarkAndroidTest -PtestBuildType=benchmark
+ * -Pandroid.testInstrumentationRunnerArguments.package=com.twilio.video.app.benchmark
+ */
+@RunWith(AndroidJUnit4::class)
+@LargeTest
+class ParticipantManagerBenchmark {
+
+    @get:Rule
+    val benchmarkRule = BenchmarkRule()
+
+    private val participants = remoteParticipants()
+    private val networkQualityLevels = NetworkQualityLevel.values()
+
+    @Test
+    fun joinAndLeaveOfAllParticipants() = benchmarkRule.measureRepeated {
+        val participantManager = runWithTimingDisabled { ParticipantManager() }
+        participants.forEach { participantManager.addParticipant(it) }
+        participants.forEach { participantManager.removeParticipant(it.sid!!) }
+    }
+
+    @Test
+    fun updatesOfAllParticipants() {
+        val participantManager = ParticipantManager().apply {
+            participants.forEach { addParticipant(it) }
+        }
+        benchmarkRule.measureRepeated {
+            participants.forEachIndexed { index, participant ->
+                val sid = participant.sid!!
+                participantManager.changeDominantSpeaker(sid)
+                participantManager.muteParticipant(sid, index % 2 == 0)
+                participantManager.updateNetworkQuality(sid,
+                        networkQualityLevels[index % networkQualityLevels.size])
+            }
+        }
+    }
+}
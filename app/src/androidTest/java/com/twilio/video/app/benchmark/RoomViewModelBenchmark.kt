@@ -0,0 +1,127 @@
+package com.twilio.video.app.benchmark
+
+import androidx.arch.core.executor.testing.InstantTaskExecutorRule
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import com.twilio.audioswitch.AudioSwitch
+import com.twilio.video.NetworkQualityLevel
+import com.twilio.video.app.data.Settings
+import com.twilio.video.app.data.api.TokenService
+import com.twilio.video.app.participant.ParticipantManager
+import com.twilio.video.app.sdk.CaptureProfileStore
+import com.twilio.video.app.sdk.ConnectOptionsFactory
+import com.twilio.video.app.sdk.JoinTracer
+import com.twilio.video.app.sdk.RoomManager
+import com.twilio.video.app.sdk.VideoClient
+import com.twilio.video.app.ui.room.RoomEvent
+import com.twilio.video.app.ui.room.RoomEvent.DominantSpeakerChanged
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.MuteRemoteParticipant
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.NetworkQualityLevelChange
+import com.twilio.video.app.ui.room.RoomEventPacing
+import com.twilio.video.app.ui.room.RoomViewModel
+import com.twilio.video.app.util.PermissionUtil
+import com.twilio.video.app.util.getSharedPreferences
+import com.twilio.video.app.util.getTargetContext
+import dagger.Lazy
+import io.uniflow.test.rule.UniflowTestDispatchersRule
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.test.TestCoroutineDispatcher
+import org.junit.After
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+
+private const val EVENT_BURST_SIZE = 1000
+private const val EVENT_WINDOW_MILLIS = 16L
+
+/**
+ * Sends a burst of [EVENT_BURST_SIZE] participant events for [PARTICIPANT_COUNT] participants
+ * through [RoomManager] and measures how long [RoomViewModel] takes to reduce them into a view
+ * state. The room events are dispatched on a [TestCoroutineDispatcher], as in the unit tests, so
+ * the whole burst is processed within the measured block.
+ */
+@ExperimentalCoroutinesApi
+@RunWith(AndroidJUnit4::class)
+@LargeTest
+class RoomViewModelBenchmark {
+
+    @get:Rule
+    val benchmarkRule = BenchmarkRule()
+
+    @get:Rule
+    val instantTaskExecutorRule = InstantTaskExecutorRule()
+
+    private val testDispatcher = TestCoroutineDispatcher()
+    @get:Rule
+    val dispatchersRule = UniflowTestDispatchersRule(testDispatcher)
+
+    private val context = getTargetContext()
+    private val sharedPreferences = getSharedPreferences(context)
+    private val captureProfileStore = CaptureProfileStore(context, sharedPreferences)
+    private val settings = MutableStateFlow(Settings())
+    private val roomManager = RoomManager(
+            context,
+            lazyOf(VideoClient(context,
+                    ConnectOptionsFactory(context, sharedPreferences, UnusedTokenService,
+                            settings, captureProfileStore),
+                    JoinTracer())),
+            testDispatcher,
+            settings = settings,
+            captureProfileStore = captureProfileStore)
+    private val participants = remoteParticipants()
+    private val networkQualityLevels = NetworkQualityLevel.values()
+    private val roomEvents = List(EVENT_BURST_SIZE) { index ->
+        val sid = participants[index % PARTICIPANT_COUNT].sid!!
+        when (index % 3) {
+            0 -> NetworkQualityLevelChange(sid, networkQualityLevels[index % networkQualityLevels.size])
+            1 -> MuteRemoteParticipant(sid, index % 2 == 0)
+            else -> DominantSpeakerChanged(sid)
+        }
+    }
+    private var viewModel: RoomViewModel? = null
+
+    @After
+    fun tearDown() {
+        viewModel?.onCleared()
+    }
+
+    @Test
+    fun coalescedEventBurst() {
+        createViewModel(RoomEventPacing.Window(EVENT_WINDOW_MILLIS))
+        benchmarkRule.measureRepeated {
+            sendRoomEvents(roomEvents)
+            testDispatcher.advanceTimeBy(EVENT_WINDOW_MILLIS)
+        }
+    }
+
+    @Test
+    fun eventBurst() {
+        createViewModel(RoomEventPacing.Immediate)
+        benchmarkRule.measureRepeated {
+            sendRoomEvents(roomEvents)
+        }
+    }
+
+    private fun createViewModel(roomEventPacing: RoomEventPacing) {
+        val participantManager = ParticipantManager().apply {
+            participants.forEach { addParticipant(it) }
+        }
+        viewModel = RoomViewModel(
+                roomManager,
+                Lazy { AudioSwitch(context) },
+                PermissionUtil(context),
+                participantManager,
+                roomEventPacing = roomEventPacing)
+    }
+
+    private fun sendRoomEvents(roomEvents: List<RoomEvent>) =
+            roomEvents.forEach { roomManager.sendRoomEvent(it) }
+
+    private object UnusedTokenService : TokenService {
+        override suspend fun getToken(identity: String?, roomName: String?): String =
+                throw UnsupportedOperationException()
+    }
+}
@@ -22,6 +22,7 @@ import dagger.Module
 import dagger.Provides
 import dagger.hilt.InstallIn
 import dagger.hilt.components.SingletonComponent
+import javax.inject.Provider
 import javax.inject.Singleton
 
 @Module
@@ -32,8 +33,8 @@ class CommunityAuthModule {
     fun providesCommunityAuthenticator(
         preferences: SharedPreferences,
         securePreferences: SecurePreferences,
-        tokenService: TokenService
+        tokenService: Provider<TokenService>
     ): Authenticator {
-        return CommunityAuthenticator(preferences, securePreferences, tokenService)
+        return CommunityAuthenticator(preferences, securePreferences, lazy { tokenService.get() })
     }
 }
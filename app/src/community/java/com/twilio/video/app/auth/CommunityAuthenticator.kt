@@ -34,10 +34,13 @@ import timber.log.Timber
 class CommunityAuthenticator constructor(
     private val sharedPreferences: SharedPreferences,
     private val securePreferences: SecurePreferences,
-    private val tokenService: TokenService,
+    tokenService: Lazy<TokenService>,
     private val coroutineContext: CoroutineContext = Dispatchers.IO
 ) : Authenticator {
 
+    /** Only built on login, so that checking the login state at startup stays cheap. */
+    private val tokenService by tokenService
+
     override fun login(loginEventObservable: Observable<LoginEvent>): Observable<LoginResult> {
         return Observable.empty()
     }
@@ -41,7 +41,8 @@ const val URL_SUFFIX = "-dev.twil.io/token"
 class AuthServiceRepository(
     private val authService: AuthService,
     private val securePreferences: SecurePreferences,
-    private val sharedPreferences: SharedPreferencesWrapper
+    private val sharedPreferences: SharedPreferencesWrapper,
+    private val tokenCache: TokenCache = TokenCache()
 ) : TokenService {
     override suspend fun getToken(identity: String?, roomName: String?): String {
         return getToken(identity, roomName, passcode = null)
@@ -49,21 +50,28 @@ class AuthServiceRepository(
 
     override suspend fun getToken(identity: String?, roomName: String?, passcode: String?): String {
         getPasscode(passcode)?.let { password ->
-            val (requestBody, url) = buildRequest(password, identity, roomName)
-
-            try {
-                authService.getToken(url, requestBody).let { response ->
-                    return handleResponse(response)
-                            ?: throw AuthServiceException(message = "Token cannot be null")
-                }
-            } catch (httpException: HttpException) {
-                handleException(httpException)
+            return tokenCache.getToken(password, identity, roomName) {
+                requestToken(password, identity, roomName)
             }
         }
 
         throw IllegalArgumentException("Passcode cannot be null")
     }
 
+    private suspend fun requestToken(passcode: String, identity: String?, roomName: String?): String {
+        val (requestBody, url) = buildRequest(passcode, identity, roomName)
+
+        try {
+            authService.getToken(url, requestBody).let { response ->
+                return handleResponse(response)
+                        ?: throw AuthServiceException(message = "Token cannot be null")
+            }
+        } catch (httpException: HttpException) {
+            handleException(httpException)
+        }
+        throw AuthServiceException(message = "Token cannot be null")
+    }
+
     private fun buildRequest(
         passcode: String,
         identity: String?,
@@ -20,6 +20,7 @@ import android.app.Application;
 import android.content.Context;
 import com.google.android.gms.auth.api.signin.GoogleSignInOptions;
 import com.twilio.video.app.R;
+import dagger.Lazy;
 import dagger.Module;
 import dagger.Provides;
 import dagger.hilt.InstallIn;
@@ -27,6 +28,7 @@ import dagger.hilt.components.SingletonComponent;
 import java.util.ArrayList;
 import java.util.List;
 import javax.inject.Singleton;
+import kotlin.LazyKt;
 
 @Module
 @InstallIn(SingletonComponent.class)
@@ -34,7 +36,15 @@ public class AuthModule {
 
     @Provides
     @Singleton
-    Authenticator providesAuthenticator(FirebaseWrapper firebaseWrapper, Application application) {
+    Authenticator providesAuthenticator(
+            FirebaseWrapper firebaseWrapper, Lazy<List<AuthenticationProvider>> authProviders) {
+        return new FirebaseAuthenticator(firebaseWrapper, LazyKt.lazy(authProviders::get));
+    }
+
+    @Provides
+    @Singleton
+    List<AuthenticationProvider> providesAuthProviders(
+            FirebaseWrapper firebaseWrapper, Application application) {
         Context context = application.getApplicationContext();
         List<AuthenticationProvider> authProviders = new ArrayList<>();
         String acceptedDomain = "twilio.com";
@@ -49,7 +59,7 @@ public class AuthModule {
                 GoogleAuthProvider.Companion.newInstance(
                         context, googleSignInOptions, acceptedDomain));
         authProviders.add(new EmailAuthProvider(firebaseWrapper));
-        return new FirebaseAuthenticator(firebaseWrapper, authProviders);
+        return authProviders;
     }
 
     @Provides
@@ -0,0 +1,31 @@
+package com.twilio.video.app
+
+import android.content.Context
+import android.os.Process
+import androidx.startup.Initializer
+import com.twilio.video.LogLevel
+import com.twilio.video.Video
+import com.twilio.video.app.util.getSharedPreferences
+import com.twilio.video.app.util.isDebugLoggingEnabled
+import kotlin.concurrent.thread
+
+/**
+ * Runs the startup work that the first frame of the splash screen does not wait on. App Startup
+ * creates it before [VideoApplication.onCreate] and the work runs on a background thread, so it
+ * overlaps with the creation of the first activity instead of delaying it.
+ */
+class DeferredStartupInitializer : Initializer<Unit> {
+
+    override fun create(context: Context) {
+        val applicationContext = context.applicationContext
+        thread(name = "DeferredStartup") {
+            Process.setThreadPriority(Process.THREAD_PRIORITY_BACKGROUND)
+            // Loads the preferences from disk before the splash screen and the lobby read them
+            getSharedPreferences(applicationContext)
+            // The first call into the Video SDK, kept off the main thread
+            if (isDebugLoggingEnabled) Video.setLogLevel(LogLevel.DEBUG)
+        }
+    }
+
+    override fun dependencies(): List<Class<out Initializer<*>>> = emptyList()
+}
@@ -16,10 +16,8 @@
 
 package com.twilio.video.app;
 
-import com.twilio.video.LogLevel;
-import com.twilio.video.Video;
-import com.twilio.video.app.util.BuildConfigUtilsKt;
 import com.twilio.video.app.util.CrashlyticsTreeRanger;
+import com.twilio.video.app.util.DebugLogKt;
 import com.twilio.video.app.util.DebugTree;
 import com.twilio.video.app.util.ReleaseTree;
 import dagger.Module;
@@ -35,11 +33,12 @@ public class TreeModule {
     @Provides
     @Singleton
     Timber.Tree providesTree(CrashlyticsTreeRanger treeRanger) {
-        if (BuildConfig.DEBUG || BuildConfigUtilsKt.isInternalFlavor()) {
-            Video.setLogLevel(LogLevel.DEBUG);
+        if (DebugLogKt.isDebugLoggingEnabled()) {
             return new DebugTree(treeRanger);
         } else {
-            return new ReleaseTree(treeRanger);
+            ReleaseTree releaseTree = new ReleaseTree(treeRanger);
+            releaseTree.installUncaughtExceptionHandler();
+            return releaseTree;
         }
     }
 }
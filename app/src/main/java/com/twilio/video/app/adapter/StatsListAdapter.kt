@@ -16,26 +16,31 @@
 
 package com.twilio.video.app.adapter
 
-import android.annotation.SuppressLint
 import android.content.Context
 import android.os.Handler
 import android.os.Looper
 import android.view.LayoutInflater
 import android.view.View
 import android.view.ViewGroup
+import androidx.recyclerview.widget.DiffUtil
+import androidx.recyclerview.widget.ListAdapter
 import androidx.recyclerview.widget.RecyclerView
-import com.twilio.video.RemoteAudioTrack
-import com.twilio.video.RemoteParticipant
-import com.twilio.video.RemoteVideoTrack
 import com.twilio.video.app.R
 import com.twilio.video.app.databinding.StatsViewBinding
 import com.twilio.video.app.model.StatsListItem
 import com.twilio.video.app.sdk.RoomStats
+import com.twilio.video.app.sdk.TrackStatsRates
+import java.util.EnumSet
+import java.util.concurrent.Executor
+import java.util.concurrent.Executors
 
-class StatsListAdapter(private val context: Context) : RecyclerView.Adapter<StatsListAdapter.ViewHolder>() {
+class StatsListAdapter(
+    private val context: Context,
+    private val statsExecutor: Executor = sharedStatsExecutor
+) : ListAdapter<StatsListItem, StatsListAdapter.ViewHolder>(StatsDiffCallback()) {
 
-    private val statsListItems = ArrayList<StatsListItem>()
     private val handler: Handler = Handler(Looper.getMainLooper())
+    private var roomStats: RoomStats? = null
 
     class ViewHolder(internal val binding: StatsViewBinding) : RecyclerView.ViewHolder(binding.root)
 
@@ -46,7 +51,7 @@ class StatsListAdapter(private val context: Context) : RecyclerView.Adapter<Stat
     }
 
     override fun onBindViewHolder(holder: ViewHolder, position: Int) {
-        val item = statsListItems[position]
+        val item = getItem(position)
         val binding = holder.binding
         binding.trackName.text = item.trackName
         binding.trackSid.text = item.trackSid
@@ -76,30 +81,80 @@ class StatsListAdapter(private val context: Context) : RecyclerView.Adapter<Stat
             binding.jitterRow.visibility = View.GONE
             binding.audioLevelRow.visibility = View.GONE
         }
+        val rates = item.rates
+        val rateRowsVisibility = if (rates != null) View.VISIBLE else View.GONE
+        binding.bitrateRow.visibility = rateRowsVisibility
+        binding.packetLossRow.visibility = rateRowsVisibility
+        binding.jitterP95Row.visibility = if (item.isAudioTrack) rateRowsVisibility else View.GONE
+        binding.framerateTrendRow.visibility = if (item.isAudioTrack) View.GONE else rateRowsVisibility
+        rates?.let { bindRates(binding, it) }
     }
 
-    override fun getItemCount(): Int {
-        return statsListItems.size
+    private fun bindRates(binding: StatsViewBinding, rates: TrackStatsRates) {
+        binding.bitrate.text = context.getString(R.string.stats_bitrate_value, rates.bitrateKbps)
+        binding.packetLoss.text = context.getString(R.string.stats_packet_loss_value,
+                rates.packetLossPercent)
+        binding.jitterP95.text = rates.jitterP95.toString()
+        binding.framerateTrend.text = rates.frameRateTrend.toString()
     }
 
-    /* because every stats notification resets the data set, suppress lint warning */
-    @SuppressLint("NotifyDataSetChanged")
+    /*
+     * Only the fields reported by the diff callback are rebound, the row layout of a track never
+     * changes between two stats reports.
+     */
+    override fun onBindViewHolder(holder: ViewHolder, position: Int, payloads: MutableList<Any>) {
+        if (payloads.isEmpty()) {
+            onBindViewHolder(holder, position)
+            return
+        }
+        val item = getItem(position)
+        val binding = holder.binding
+        payloads.forEach { payload ->
+            @Suppress("UNCHECKED_CAST")
+            (payload as Set<StatsField>).forEach { field ->
+                when (field) {
+                    StatsField.TRACK_NAME -> binding.trackName.text = item.trackName
+                    StatsField.CODEC -> binding.codec.text = item.codec
+                    StatsField.PACKETS_LOST -> binding.packetsLost.text = item.packetsLost.toString()
+                    StatsField.BYTES -> binding.bytes.text = item.bytes.toString()
+                    StatsField.RTT -> binding.rtt.text = item.rtt.toString()
+                    StatsField.DIMENSIONS -> binding.dimensions.text = item.dimensions
+                    StatsField.FRAMERATE -> binding.framerate.text = item.framerate.toString()
+                    StatsField.JITTER -> binding.jitter.text = item.jitter.toString()
+                    StatsField.AUDIO_LEVEL -> binding.audioLevel.text = item.audioLevel.toString()
+                    StatsField.RATES -> item.rates?.let { bindRates(binding, it) }
+                }
+            }
+        }
+    }
+
+    /**
+     * Builds the stats items on a background executor and submits them to be diffed against the
+     * current items, which [ListAdapter] also does off the main thread.
+     */
     fun updateStatsData(roomStats: RoomStats?) {
-        /*
-         * Generate new items on a separate list to ensure statsListItems changes are only
-         * performed on the UI thread to meet the threading requirement of RecyclerView.Adapter.
-         */
+        if (roomStats === this.roomStats) return
+        this.roomStats = roomStats
+        statsExecutor.execute {
+            val statsItemList = buildStatsItems(roomStats)
+            handler.post { submitList(statsItemList) }
+        }
+    }
+
+    private fun buildStatsItems(roomStats: RoomStats?): List<StatsListItem> {
         val statsItemList = mutableListOf<StatsListItem>()
 
         // Generate stats items list from reports
         var localTracksAdded = false
         roomStats?.statsReports?.let { statsReports ->
+            val trackIdentities = roomStats.remoteTrackIdentities
             for (report in statsReports) {
                 if (!localTracksAdded) {
                     // go trough local tracks
                     for (localAudioTrackStats in report.localAudioTrackStats) {
                         val item = StatsListItem.Builder()
                                 .baseTrackInfo(localAudioTrackStats)
+                                .rates(roomStats.trackRates[localAudioTrackStats.trackSid])
                                 .bytes(localAudioTrackStats.bytesSent)
                                 .rtt(localAudioTrackStats.roundTripTime)
                                 .jitter(localAudioTrackStats.jitter)
@@ -117,6 +172,7 @@ class StatsListAdapter(private val context: Context) : RecyclerView.Adapter<Stat
                         }
                         val item = StatsListItem.Builder()
                                 .baseTrackInfo(localVideoTrackStats)
+                                .rates(roomStats.trackRates[localVideoTrackStats.trackSid])
                                 .bytes(localVideoTrackStats.bytesSent)
                                 .rtt(localVideoTrackStats.roundTripTime)
                                 .dimensions(localVideoTrackStats.dimensions.toString())
@@ -131,13 +187,14 @@ class StatsListAdapter(private val context: Context) : RecyclerView.Adapter<Stat
                 }
                 var trackCount = 0
                 for (remoteAudioTrackStats in report.remoteAudioTrackStats) {
-                    val trackName = (getParticipantName(remoteAudioTrackStats.trackSid, true, roomStats.remoteParticipants) +
+                    val trackName = ((trackIdentities[remoteAudioTrackStats.trackSid] ?: "") +
                             " " +
                             context.getString(R.string.audio_track) +
                             " " +
                             trackCount)
                     val item = StatsListItem.Builder()
                             .baseTrackInfo(remoteAudioTrackStats)
+                            .rates(roomStats.trackRates[remoteAudioTrackStats.trackSid])
                             .bytes(remoteAudioTrackStats.bytesReceived)
                             .jitter(remoteAudioTrackStats.jitter)
                             .audioLevel(remoteAudioTrackStats.audioLevel)
@@ -150,14 +207,14 @@ class StatsListAdapter(private val context: Context) : RecyclerView.Adapter<Stat
                 }
                 trackCount = 0
                 for (remoteVideoTrackStats in report.remoteVideoTrackStats) {
-                    val trackName = (getParticipantName(
-                            remoteVideoTrackStats.trackSid, false, roomStats.remoteParticipants) +
+                    val trackName = ((trackIdentities[remoteVideoTrackStats.trackSid] ?: "") +
                             " " +
                             context.getString(R.string.video_track) +
                             " " +
                             trackCount)
                     val item = StatsListItem.Builder()
                             .baseTrackInfo(remoteVideoTrackStats)
+                            .rates(roomStats.trackRates[remoteVideoTrackStats.trackSid])
                             .bytes(remoteVideoTrackStats.bytesReceived)
                             .dimensions(remoteVideoTrackStats.dimensions.toString())
                             .framerate(remoteVideoTrackStats.frameRate)
@@ -170,55 +227,41 @@ class StatsListAdapter(private val context: Context) : RecyclerView.Adapter<Stat
                 }
             }
         }
-
-        handler.post {
-            statsListItems.clear()
-            statsListItems.addAll(statsItemList.toList())
-            notifyDataSetChanged()
-        }
+        return statsItemList
     }
 
-    private fun getParticipantName(
-        trackSid: String,
-        isAudioTrack: Boolean,
-        remoteParticipants: List<RemoteParticipant>
-    ): String {
-        for (remoteParticipant in remoteParticipants) {
-            if (isAudioTrack) {
-                val remoteAudioTrack = getAudioTrack(remoteParticipant, trackSid)
-                if (remoteAudioTrack != null) {
-                    return remoteParticipant.identity
-                }
-            } else {
-                val remoteVideoTrack = getRemoteVideoTrack(remoteParticipant, trackSid)
-                if (remoteVideoTrack != null) {
-                    return remoteParticipant.identity
-                }
-            }
-        }
-        return ""
+    internal enum class StatsField {
+        TRACK_NAME, CODEC, PACKETS_LOST, BYTES, RTT, DIMENSIONS, FRAMERATE, JITTER, AUDIO_LEVEL, RATES
     }
 
-    private fun getAudioTrack(remoteParticipant: RemoteParticipant, trackSid: String): RemoteAudioTrack? {
-        for (remoteAudioTrackPublication in remoteParticipant.remoteAudioTracks) {
-            if (remoteAudioTrackPublication.trackSid == trackSid) {
-                return remoteAudioTrackPublication.remoteAudioTrack
-            }
-        }
+    internal class StatsDiffCallback : DiffUtil.ItemCallback<StatsListItem>() {
+        override fun areItemsTheSame(oldItem: StatsListItem, newItem: StatsListItem): Boolean =
+                oldItem.trackSid == newItem.trackSid
 
-        return null
-    }
+        override fun areContentsTheSame(oldItem: StatsListItem, newItem: StatsListItem): Boolean =
+                oldItem == newItem
 
-    private fun getRemoteVideoTrack(
-        remoteParticipant: RemoteParticipant,
-        trackSid: String
-    ): RemoteVideoTrack? {
-        for (remoteVideoTrackPublication in remoteParticipant.remoteVideoTracks) {
-            if (remoteVideoTrackPublication.trackSid == trackSid) {
-                return remoteVideoTrackPublication.remoteVideoTrack
-            }
+        override fun getChangePayload(oldItem: StatsListItem, newItem: StatsListItem): Any? {
+            // A different kind of track or the first rates need a full rebind of the row visibilities
+            if (oldItem.isLocalTrack != newItem.isLocalTrack ||
+                    oldItem.isAudioTrack != newItem.isAudioTrack ||
+                    (oldItem.rates == null) != (newItem.rates == null)) return null
+            val changedFields = EnumSet.noneOf(StatsField::class.java)
+            if (oldItem.trackName != newItem.trackName) changedFields.add(StatsField.TRACK_NAME)
+            if (oldItem.codec != newItem.codec) changedFields.add(StatsField.CODEC)
+            if (oldItem.packetsLost != newItem.packetsLost) changedFields.add(StatsField.PACKETS_LOST)
+            if (oldItem.bytes != newItem.bytes) changedFields.add(StatsField.BYTES)
+            if (oldItem.rtt != newItem.rtt) changedFields.add(StatsField.RTT)
+            if (oldItem.dimensions != newItem.dimensions) changedFields.add(StatsField.DIMENSIONS)
+            if (oldItem.framerate != newItem.framerate) changedFields.add(StatsField.FRAMERATE)
+            if (oldItem.jitter != newItem.jitter) changedFields.add(StatsField.JITTER)
+            if (oldItem.audioLevel != newItem.audioLevel) changedFields.add(StatsField.AUDIO_LEVEL)
+            if (oldItem.rates != newItem.rates) changedFields.add(StatsField.RATES)
+            return changedFields
         }
+    }
 
-        return null
+    companion object {
+        private val sharedStatsExecutor: Executor by lazy { Executors.newSingleThreadExecutor() }
     }
 }
@@ -4,9 +4,12 @@ import io.reactivex.Observable
 
 class FirebaseAuthenticator(
     private val firebaseWrapper: FirebaseWrapper,
-    private val authenticationProviders: List<AuthenticationProvider>
+    authenticationProviders: Lazy<List<AuthenticationProvider>>
 ) : Authenticator {
 
+    /** Only built to log in or out, checking the login state at startup does not need them. */
+    private val authenticationProviders by authenticationProviders
+
     override fun login(loginEventObservable: Observable<LoginEvent>): Observable<LoginResult> {
         // TODO Figure out a better way to only subscribe to one authenticator at a time
         val observables: MutableList<Observable<LoginResult>> = mutableListOf()
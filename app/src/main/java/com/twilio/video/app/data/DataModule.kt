@@ -23,6 +23,7 @@ import dagger.Module
 import dagger.Provides
 import dagger.hilt.InstallIn
 import dagger.hilt.components.SingletonComponent
+import javax.inject.Singleton
 
 @Module
 @InstallIn(SingletonComponent::class)
@@ -31,4 +32,11 @@ class DataModule {
     internal fun provideSharedPreferences(app: Application): SharedPreferences {
         return getSharedPreferences(app)
     }
+
+    @Provides
+    @Singleton
+    fun providesSettingsStore(sharedPreferences: SharedPreferences): SettingsStore {
+        sharedPreferences.migrateVideoCaptureResolution()
+        return SettingsStore(sharedPreferences)
+    }
 }
@@ -22,6 +22,7 @@ import com.twilio.video.VideoDimensions
 import com.twilio.video.Vp8Codec
 import com.twilio.video.app.BuildConfig
 import com.twilio.video.app.data.api.dto.Topology
+import com.twilio.video.app.sdk.LowBandwidthMode
 
 object Preferences {
     const val INTERNAL = "pref_internal"
@@ -46,7 +47,20 @@ object Preferences {
             VideoDimensions.HD_1080P_VIDEO_DIMENSIONS
     )
     const val VIDEO_CAPTURE_RESOLUTION = "pref_video_capture_resolution"
-    const val VIDEO_CAPTURE_RESOLUTION_DEFAULT = "1"
+    const val VIDEO_CAPTURE_RESOLUTION_AUTOMATIC = "automatic"
+    const val VIDEO_CAPTURE_RESOLUTION_DEFAULT = VIDEO_CAPTURE_RESOLUTION_AUTOMATIC
+    const val VIDEO_CAPTURE_RESOLUTION_VERSION = "pref_video_capture_resolution_version"
+    const val CAPTURE_PROFILE = "pref_capture_profile"
+    const val KEEP_CAMERA_ALIVE = "pref_keep_camera_alive"
+    const val KEEP_CAMERA_ALIVE_DEFAULT = true
+    const val SCREEN_SHARE_CONTENT = "pref_screen_share_content"
+    const val SCREEN_SHARE_CONTENT_TEXT = "text"
+    const val SCREEN_SHARE_CONTENT_MOTION = "motion"
+    const val SCREEN_SHARE_CONTENT_DEFAULT = SCREEN_SHARE_CONTENT_TEXT
+    const val LOW_BANDWIDTH_MODE = "pref_low_bandwidth_mode"
+    val LOW_BANDWIDTH_MODE_DEFAULT = LowBandwidthMode.AUTOMATIC.name
+    const val LOW_BANDWIDTH_KEEP_DOMINANT_SPEAKER = "pref_low_bandwidth_keep_dominant_speaker"
+    const val LOW_BANDWIDTH_KEEP_DOMINANT_SPEAKER_DEFAULT = true
     const val VERSION_NAME = "pref_version_name"
     const val VIDEO_LIBRARY_VERSION = "pref_video_library_version"
     const val LOGOUT = "pref_logout"
@@ -59,7 +73,11 @@ object Preferences {
     const val ENABLE_AUTOMATIC_TRACK_SUBSCRIPTION_DEFAULT = true
     const val ENABLE_DOMINANT_SPEAKER = "pref_enable_dominant_speaker"
     const val ENABLE_DOMINANT_SPEAKER_DEFAULT = true
+    const val ENABLE_SPEAKER_DETECTION = "pref_enable_speaker_detection"
+    const val ENABLE_SPEAKER_DETECTION_DEFAULT = false
     const val ENABLE_INSIGHTS_DEFAULT = true
+    const val ENABLE_QUALITY_TELEMETRY = "pref_enable_quality_telemetry"
+    const val ENABLE_QUALITY_TELEMETRY_DEFAULT = true
     const val VIDEO_CODEC = "pref_video_codecs"
     const val VIDEO_CODEC_DEFAULT = Vp8Codec.NAME
     const val VP8_SIMULCAST = "pref_vp8_simulcast"
@@ -0,0 +1,172 @@
+package com.twilio.video.app.data
+
+import android.content.SharedPreferences
+import androidx.core.content.edit
+import com.twilio.video.app.data.Preferences.AUDIO_ACOUSTIC_ECHO_CANCELER
+import com.twilio.video.app.data.Preferences.AUDIO_ACOUSTIC_ECHO_CANCELER_DEFAULT
+import com.twilio.video.app.data.Preferences.AUDIO_ACOUSTIC_NOISE_SUPRESSOR
+import com.twilio.video.app.data.Preferences.AUDIO_ACOUSTIC_NOISE_SUPRESSOR_DEFAULT
+import com.twilio.video.app.data.Preferences.AUDIO_AUTOMATIC_GAIN_CONTROL
+import com.twilio.video.app.data.Preferences.AUDIO_AUTOMATIC_GAIN_CONTROL_DEFAULT
+import com.twilio.video.app.data.Preferences.AUDIO_CODEC
+import com.twilio.video.app.data.Preferences.AUDIO_CODEC_DEFAULT
+import com.twilio.video.app.data.Preferences.AUDIO_OPEN_SLES_USAGE
+import com.twilio.video.app.data.Preferences.AUDIO_OPEN_SLES_USAGE_DEFAULT
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_DOMINANT_SPEAKER_PRIORITY
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_DOMINANT_SPEAKER_PRIORITY_DEFAULT
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_MAX_SUBSCRIPTION_BITRATE
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_MAX_SUBSCRIPTION_BITRATE_DEFAULT
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_MODE
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_MODE_DEFAULT
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_CONTROL
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_CONTROL_DEFAULT
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_MODE
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_MODE_DEFAULT
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_VIDEO_CONTENT_PREFERENCES_MODE
+import com.twilio.video.app.data.Preferences.BANDWIDTH_PROFILE_VIDEO_CONTENT_PREFERENCES_MODE_DEFAULT
+import com.twilio.video.app.data.Preferences.ENABLE_AUTOMATIC_TRACK_SUBSCRIPTION
+import com.twilio.video.app.data.Preferences.ENABLE_AUTOMATIC_TRACK_SUBSCRIPTION_DEFAULT
+import com.twilio.video.app.data.Preferences.ENABLE_DOMINANT_SPEAKER
+import com.twilio.video.app.data.Preferences.ENABLE_DOMINANT_SPEAKER_DEFAULT
+import com.twilio.video.app.data.Preferences.ENABLE_INSIGHTS
+import com.twilio.video.app.data.Preferences.ENABLE_INSIGHTS_DEFAULT
+import com.twilio.video.app.data.Preferences.ENABLE_NETWORK_QUALITY_LEVEL
+import com.twilio.video.app.data.Preferences.ENABLE_NETWORK_QUALITY_LEVEL_DEFAULT
+import com.twilio.video.app.data.Preferences.ENABLE_QUALITY_TELEMETRY
+import com.twilio.video.app.data.Preferences.ENABLE_QUALITY_TELEMETRY_DEFAULT
+import com.twilio.video.app.data.Preferences.ENABLE_SPEAKER_DETECTION
+import com.twilio.video.app.data.Preferences.ENABLE_SPEAKER_DETECTION_DEFAULT
+import com.twilio.video.app.data.Preferences.ENABLE_STATS
+import com.twilio.video.app.data.Preferences.ENABLE_STATS_DEFAULT
+import com.twilio.video.app.data.Preferences.ENVIRONMENT
+import com.twilio.video.app.data.Preferences.ENVIRONMENT_DEFAULT
+import com.twilio.video.app.data.Preferences.KEEP_CAMERA_ALIVE
+import com.twilio.video.app.data.Preferences.KEEP_CAMERA_ALIVE_DEFAULT
+import com.twilio.video.app.data.Preferences.LOW_BANDWIDTH_KEEP_DOMINANT_SPEAKER
+import com.twilio.video.app.data.Preferences.LOW_BANDWIDTH_KEEP_DOMINANT_SPEAKER_DEFAULT
+import com.twilio.video.app.data.Preferences.LOW_BANDWIDTH_MODE
+import com.twilio.video.app.data.Preferences.LOW_BANDWIDTH_MODE_DEFAULT
+import com.twilio.video.app.data.Preferences.MAX_AUDIO_BITRATE
+import com.twilio.video.app.data.Preferences.MAX_AUDIO_BITRATE_DEFAULT
+import com.twilio.video.app.data.Preferences.MAX_VIDEO_BITRATE
+import com.twilio.video.app.data.Preferences.MAX_VIDEO_BITRATE_DEFAULT
+import com.twilio.video.app.data.Preferences.SCREEN_SHARE_CONTENT
+import com.twilio.video.app.data.Preferences.SCREEN_SHARE_CONTENT_DEFAULT
+import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION
+import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION_AUTOMATIC
+import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION_DEFAULT
+import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION_VERSION
+import com.twilio.video.app.data.Preferences.VIDEO_CODEC
+import com.twilio.video.app.data.Preferences.VIDEO_CODEC_DEFAULT
+import com.twilio.video.app.data.Preferences.VP8_SIMULCAST
+import com.twilio.video.app.data.Preferences.VP8_SIMULCAST_DEFAULT
+import com.twilio.video.app.util.get
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.StateFlow
+
+/**
+ * The [Preferences] read while connecting to a room, capturing the local tracks and rendering the
+ * room, as plain fields. Every property defaults to the default of its preference.
+ */
+data class Settings(
+    val environment: String = ENVIRONMENT_DEFAULT,
+    val enableInsights: Boolean = ENABLE_INSIGHTS_DEFAULT,
+    val enableQualityTelemetry: Boolean = ENABLE_QUALITY_TELEMETRY_DEFAULT,
+    val enableAutomaticTrackSubscription: Boolean = ENABLE_AUTOMATIC_TRACK_SUBSCRIPTION_DEFAULT,
+    val enableDominantSpeaker: Boolean = ENABLE_DOMINANT_SPEAKER_DEFAULT,
+    val enableSpeakerDetection: Boolean = ENABLE_SPEAKER_DETECTION_DEFAULT,
+    val enableNetworkQualityLevel: Boolean = ENABLE_NETWORK_QUALITY_LEVEL_DEFAULT,
+    val enableStats: Boolean = ENABLE_STATS_DEFAULT,
+    val videoCodec: String = VIDEO_CODEC_DEFAULT,
+    val vp8Simulcast: Boolean = VP8_SIMULCAST_DEFAULT,
+    val audioCodec: String = AUDIO_CODEC_DEFAULT,
+    val maxAudioBitrate: Int = MAX_AUDIO_BITRATE_DEFAULT,
+    val maxVideoBitrate: Int = MAX_VIDEO_BITRATE_DEFAULT,
+    val videoCaptureResolution: String = VIDEO_CAPTURE_RESOLUTION_DEFAULT,
+    val keepCameraAlive: Boolean = KEEP_CAMERA_ALIVE_DEFAULT,
+    val screenShareContent: String = SCREEN_SHARE_CONTENT_DEFAULT,
+    val lowBandwidthMode: String = LOW_BANDWIDTH_MODE_DEFAULT,
+    val lowBandwidthKeepDominantSpeaker: Boolean = LOW_BANDWIDTH_KEEP_DOMINANT_SPEAKER_DEFAULT,
+    val bandwidthProfileMode: String = BANDWIDTH_PROFILE_MODE_DEFAULT,
+    val maxSubscriptionBitrate: Int = BANDWIDTH_PROFILE_MAX_SUBSCRIPTION_BITRATE_DEFAULT,
+    val dominantSpeakerPriority: String = BANDWIDTH_PROFILE_DOMINANT_SPEAKER_PRIORITY_DEFAULT,
+    val trackSwitchOffMode: String = BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_MODE_DEFAULT,
+    val trackSwitchOffControl: String = BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_CONTROL_DEFAULT,
+    val videoContentPreferencesMode: String = BANDWIDTH_PROFILE_VIDEO_CONTENT_PREFERENCES_MODE_DEFAULT,
+    val acousticEchoCanceler: Boolean = AUDIO_ACOUSTIC_ECHO_CANCELER_DEFAULT,
+    val noiseSuppressor: Boolean = AUDIO_ACOUSTIC_NOISE_SUPRESSOR_DEFAULT,
+    val automaticGainControl: Boolean = AUDIO_AUTOMATIC_GAIN_CONTROL_DEFAULT,
+    val openSLESUsage: Boolean = AUDIO_OPEN_SLES_USAGE_DEFAULT
+)
+
+fun SharedPreferences.readSettings() = Settings(
+        environment = getString(ENVIRONMENT, null) ?: ENVIRONMENT_DEFAULT,
+        enableInsights = get(ENABLE_INSIGHTS, ENABLE_INSIGHTS_DEFAULT),
+        enableQualityTelemetry = get(ENABLE_QUALITY_TELEMETRY, ENABLE_QUALITY_TELEMETRY_DEFAULT),
+        enableAutomaticTrackSubscription = get(ENABLE_AUTOMATIC_TRACK_SUBSCRIPTION,
+                ENABLE_AUTOMATIC_TRACK_SUBSCRIPTION_DEFAULT),
+        enableDominantSpeaker = get(ENABLE_DOMINANT_SPEAKER, ENABLE_DOMINANT_SPEAKER_DEFAULT),
+        enableSpeakerDetection = get(ENABLE_SPEAKER_DETECTION, ENABLE_SPEAKER_DETECTION_DEFAULT),
+        enableNetworkQualityLevel = get(ENABLE_NETWORK_QUALITY_LEVEL, ENABLE_NETWORK_QUALITY_LEVEL_DEFAULT),
+        enableStats = get(ENABLE_STATS, ENABLE_STATS_DEFAULT),
+        videoCodec = getString(VIDEO_CODEC, null) ?: VIDEO_CODEC_DEFAULT,
+        vp8Simulcast = get(VP8_SIMULCAST, VP8_SIMULCAST_DEFAULT),
+        audioCodec = getString(AUDIO_CODEC, null) ?: AUDIO_CODEC_DEFAULT,
+        maxAudioBitrate = get(MAX_AUDIO_BITRATE, MAX_AUDIO_BITRATE_DEFAULT),
+        maxVideoBitrate = get(MAX_VIDEO_BITRATE, MAX_VIDEO_BITRATE_DEFAULT),
+        videoCaptureResolution = getString(VIDEO_CAPTURE_RESOLUTION, null) ?: VIDEO_CAPTURE_RESOLUTION_DEFAULT,
+        keepCameraAlive = get(KEEP_CAMERA_ALIVE, KEEP_CAMERA_ALIVE_DEFAULT),
+        screenShareContent = getString(SCREEN_SHARE_CONTENT, null) ?: SCREEN_SHARE_CONTENT_DEFAULT,
+        lowBandwidthMode = getString(LOW_BANDWIDTH_MODE, null) ?: LOW_BANDWIDTH_MODE_DEFAULT,
+        lowBandwidthKeepDominantSpeaker = get(LOW_BANDWIDTH_KEEP_DOMINANT_SPEAKER,
+                LOW_BANDWIDTH_KEEP_DOMINANT_SPEAKER_DEFAULT),
+        bandwidthProfileMode = getString(BANDWIDTH_PROFILE_MODE, null) ?: BANDWIDTH_PROFILE_MODE_DEFAULT,
+        maxSubscriptionBitrate = get(BANDWIDTH_PROFILE_MAX_SUBSCRIPTION_BITRATE,
+                BANDWIDTH_PROFILE_MAX_SUBSCRIPTION_BITRATE_DEFAULT),
+        dominantSpeakerPriority = getString(BANDWIDTH_PROFILE_DOMINANT_SPEAKER_PRIORITY, null)
+                ?: BANDWIDTH_PROFILE_DOMINANT_SPEAKER_PRIORITY_DEFAULT,
+        trackSwitchOffMode = getString(BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_MODE, null)
+                ?: BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_MODE_DEFAULT,
+        trackSwitchOffControl = getString(BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_CONTROL, null)
+                ?: BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_CONTROL_DEFAULT,
+        videoContentPreferencesMode = getString(BANDWIDTH_PROFILE_VIDEO_CONTENT_PREFERENCES_MODE, null)
+                ?: BANDWIDTH_PROFILE_VIDEO_CONTENT_PREFERENCES_MODE_DEFAULT,
+        acousticEchoCanceler = get(AUDIO_ACOUSTIC_ECHO_CANCELER, AUDIO_ACOUSTIC_ECHO_CANCELER_DEFAULT),
+        noiseSuppressor = get(AUDIO_ACOUSTIC_NOISE_SUPRESSOR, AUDIO_ACOUSTIC_NOISE_SUPRESSOR_DEFAULT),
+        automaticGainControl = get(AUDIO_AUTOMATIC_GAIN_CONTROL, AUDIO_AUTOMATIC_GAIN_CONTROL_DEFAULT),
+        openSLESUsage = get(AUDIO_OPEN_SLES_USAGE, AUDIO_OPEN_SLES_USAGE_DEFAULT))
+
+/*
+ * Index 1 used to be the default capture resolution, written by the settings screen and by the
+ * token service for group rooms, until the default became the automatic resolution under the same
+ * index. A stored index 1 is therefore read as automatic once, and from then on means CIF again.
+ */
+internal fun SharedPreferences.migrateVideoCaptureResolution() {
+    if (getInt(VIDEO_CAPTURE_RESOLUTION_VERSION, 1) >= 2) return
+    edit {
+        if (getString(VIDEO_CAPTURE_RESOLUTION, null) == "1") {
+            putString(VIDEO_CAPTURE_RESOLUTION, VIDEO_CAPTURE_RESOLUTION_AUTOMATIC)
+        }
+        putInt(VIDEO_CAPTURE_RESOLUTION_VERSION, 2)
+    }
+}
+
+/**
+ * Holds the [Settings] of [sharedPreferences], read once when the store is created and read again
+ * whenever a preference changes, so that callers on the connect, capture and render paths read
+ * [settings] without touching the preferences. The settings screens keep writing the preferences.
+ */
+class SettingsStore(sharedPreferences: SharedPreferences) {
+
+    private val mutableSettings = MutableStateFlow(sharedPreferences.readSettings())
+    val settings: StateFlow<Settings> = mutableSettings
+
+    // Held by the store since the preferences only keep a weak reference to their listeners
+    private val listener = SharedPreferences.OnSharedPreferenceChangeListener { preferences, _ ->
+        mutableSettings.value = preferences.readSettings()
+    }
+
+    init {
+        sharedPreferences.registerOnSharedPreferenceChangeListener(listener)
+    }
+}
@@ -33,12 +33,17 @@ class InternalTokenService(
     private val sharedPreferences: SharedPreferences,
     private val internalDevTokenApi: InternalTokenApi,
     private val internalStageTokenApi: InternalTokenApi,
-    private val internalProdTokenApi: InternalTokenApi
+    private val internalProdTokenApi: InternalTokenApi,
+    private val tokenCache: TokenCache = TokenCache()
 ) : TokenService {
 
     override suspend fun getToken(identity: String?, roomName: String?): String {
         val env = sharedPreferences.getString(ENVIRONMENT, ENVIRONMENT_DEFAULT)
-        val authService = resolveAuthService(env!!)
+        return tokenCache.getToken(env, identity, roomName) { requestToken(env!!, identity, roomName) }
+    }
+
+    private suspend fun requestToken(env: String, identity: String?, roomName: String?): String {
+        val authService = resolveAuthService(env)
         val requestMsg = if (null != roomName)
             AuthServiceRequestDTO(null, identity, roomName, true)
         else AuthServiceRequestDTO(null, identity)
@@ -83,7 +88,6 @@ class InternalTokenService(
                         putString(Preferences.VIDEO_CODEC, Vp8Codec.NAME)
                         putBoolean(Preferences.VP8_SIMULCAST, enableSimulcast)
                         putString(Preferences.VIDEO_CAPTURE_RESOLUTION, videoDimensionsIndex)
-                        commit()
                     }
                 }
             }
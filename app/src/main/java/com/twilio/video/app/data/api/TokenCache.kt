@@ -0,0 +1,61 @@
+package com.twilio.video.app.data.api
+
+import com.google.gson.Gson
+import com.google.gson.JsonParseException
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.TimeUnit
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import okio.ByteString
+import timber.log.Timber
+
+val TOKEN_EXPIRY_MARGIN_MILLIS = TimeUnit.MINUTES.toMillis(1)
+
+/**
+ * Reuses access tokens until shortly before the expiry stored in their `exp` claim so that a token
+ * prefetched in the lobby is used by the following connect instead of a new request. Tokens
+ * without a readable expiry are never cached. Concurrent requests for the same token wait for the
+ * first one instead of issuing a second request, requests for other tokens do not wait.
+ */
+class TokenCache(
+    private val expiryMarginMillis: Long = TOKEN_EXPIRY_MARGIN_MILLIS,
+    private val clock: () -> Long = System::currentTimeMillis
+) {
+    private val mutexes = ConcurrentHashMap<Key, Mutex>()
+    private val tokens = ConcurrentHashMap<Key, CachedToken>()
+
+    suspend fun getToken(vararg keyParts: String?, fetchToken: suspend () -> String): String {
+        val key = Key(keyParts.toList())
+        return mutexes.getOrPut(key) { Mutex() }.withLock {
+            tokens[key]?.let { cachedToken ->
+                if (clock() < cachedToken.expiresAtMillis - expiryMarginMillis) {
+                    Timber.d("Reusing cached token")
+                    return@withLock cachedToken.token
+                }
+                tokens.remove(key)
+            }
+            fetchToken().also { token ->
+                parseExpiryMillis(token)?.let { tokens[key] = CachedToken(token, it) }
+            }
+        }
+    }
+
+    private fun parseExpiryMillis(token: String): Long? {
+        val payload = token.split('.').takeIf { it.size == 3 }?.get(1) ?: return null
+        return try {
+            ByteString.decodeBase64(payload)?.utf8()
+                    ?.let { Gson().fromJson(it, TokenClaims::class.java) }
+                    ?.exp
+                    ?.let { TimeUnit.SECONDS.toMillis(it) }
+        } catch (e: JsonParseException) {
+            Timber.w(e, "Unable to read the expiry of the token")
+            null
+        }
+    }
+
+    private data class Key(val parts: List<String?>)
+
+    private class CachedToken(val token: String, val expiresAtMillis: Long)
+
+    private class TokenClaims(val exp: Long?)
+}
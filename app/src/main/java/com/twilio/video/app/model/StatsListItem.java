@@ -16,7 +16,10 @@
 
 package com.twilio.video.app.model;
 
+import androidx.annotation.Nullable;
 import com.twilio.video.BaseTrackStats;
+import com.twilio.video.app.sdk.TrackStatsRates;
+import java.util.Objects;
 
 public class StatsListItem {
     public final String trackSid;
@@ -31,6 +34,7 @@ public class StatsListItem {
     public final int audioLevel;
     public final boolean isLocalTrack;
     public final boolean isAudioTrack;
+    @Nullable public final TrackStatsRates rates;
 
     private StatsListItem(Builder builder) {
         this.trackSid = builder.trackSid;
@@ -45,6 +49,45 @@ public class StatsListItem {
         this.audioLevel = builder.audioLevel;
         this.isLocalTrack = builder.isLocalTrack;
         this.isAudioTrack = builder.isAudioTrack;
+        this.rates = builder.rates;
+    }
+
+    @Override
+    public boolean equals(@Nullable Object o) {
+        if (this == o) return true;
+        if (o == null || getClass() != o.getClass()) return false;
+        StatsListItem that = (StatsListItem) o;
+        return packetsLost == that.packetsLost
+                && bytes == that.bytes
+                && rtt == that.rtt
+                && framerate == that.framerate
+                && jitter == that.jitter
+                && audioLevel == that.audioLevel
+                && isLocalTrack == that.isLocalTrack
+                && isAudioTrack == that.isAudioTrack
+                && Objects.equals(trackSid, that.trackSid)
+                && Objects.equals(trackName, that.trackName)
+                && Objects.equals(codec, that.codec)
+                && Objects.equals(dimensions, that.dimensions)
+                && Objects.equals(rates, that.rates);
+    }
+
+    @Override
+    public int hashCode() {
+        return Objects.hash(
+                trackSid,
+                trackName,
+                codec,
+                packetsLost,
+                bytes,
+                rtt,
+                dimensions,
+                framerate,
+                jitter,
+                audioLevel,
+                isLocalTrack,
+                isAudioTrack,
+                rates);
     }
 
     public static class Builder {
@@ -60,6 +103,7 @@ public class StatsListItem {
         private int audioLevel;
         private boolean isLocalTrack;
         private boolean isAudioTrack;
+        private TrackStatsRates rates;
 
         public Builder() {}
 
@@ -108,6 +152,11 @@ public class StatsListItem {
             return this;
         }
 
+        public Builder rates(@Nullable TrackStatsRates rates) {
+            this.rates = rates;
+            return this;
+        }
+
         public Builder baseTrackInfo(BaseTrackStats trackStats) {
             this.codec = trackStats.codec;
             this.packetsLost = trackStats.packetsLost;
@@ -1,59 +1,96 @@
 package com.twilio.video.app.participant
 
 import com.twilio.video.NetworkQualityLevel
+import com.twilio.video.RemoteVideoTrack
 import com.twilio.video.TrackPriority.HIGH
+import com.twilio.video.TrackPriority.LOW
+import com.twilio.video.VideoTrack
+import com.twilio.video.app.sdk.QualityLevel
 import com.twilio.video.app.sdk.VideoTrackViewState
+import com.twilio.video.app.util.debugLog
 import timber.log.Timber
 
 class ParticipantManager {
 
-    private val mutableParticipants = mutableListOf<ParticipantViewState>()
-    val participantThumbnails: List<ParticipantViewState> get() = mutableParticipants.toList()
+    private val participantStore = ParticipantStore()
+    private var localParticipantSid: String? = null
+    private val lowPriorityTracks = HashSet<RemoteVideoTrack>()
+    /*
+     * A rejoined room does not know its dominant speaker yet, until it reports one the video of the
+     * participant who was speaking before is subscribed at [HIGH] priority so that it comes back first.
+     */
+    private var rejoinedSpeakerSid: String? = null
+    /*
+     * The speaker predicted from the audio levels takes the primary view until the room reports its
+     * dominant speaker, without reordering the thumbnails. The video of the participant likely to
+     * speak next is subscribed at [HIGH] priority ahead of the switch.
+     */
+    private var predictedSpeakerSid: String? = null
+    private var prewarmedVideoTrack: RemoteVideoTrack? = null
+    val participantThumbnails: List<ParticipantViewState> get() = participantStore.thumbnails
     var primaryParticipant: ParticipantViewState
         private set
 
+    /**
+     * From [QualityLevel.REDUCED_SUBSCRIPTION] on the video tracks of the thumbnails are
+     * subscribed at [LOW] priority so that the bandwidth left is spent on the primary participant.
+     */
+    var qualityLevel = QualityLevel.FULL
+        set(value) {
+            if (field == value) return
+            field = value
+            Timber.d("Quality level changed to %s", value)
+            updateThumbnailPriorities()
+        }
+
     init {
         val localParticipant = ParticipantViewState(isLocalParticipant = true)
-        mutableParticipants.add(localParticipant)
+        participantStore.add(localParticipant)
         primaryParticipant = localParticipant
     }
 
     fun addParticipant(participantViewState: ParticipantViewState) {
         Timber.d("Adding participant: %s", participantViewState)
-        mutableParticipants.add(participantViewState)
+        participantStore.add(participantViewState)
+        updatePrimaryParticipant()
+    }
+
+    /**
+     * Replaces the remote participants with the [participants] of a rejoined room. Participants that
+     * are still in the room keep their position, pin and dominant speaker state, so the layout does
+     * not change, the others are removed.
+     */
+    fun rejoinRemoteParticipants(participants: List<ParticipantViewState>) {
+        val sids = participants.mapTo(HashSet()) { it.sid }
+        participantStore.removeAll { !it.isLocalParticipant && it.sid !in sids }
+        rejoinedSpeakerSid = participantStore.dominantSpeaker?.sid
+        for (participant in participants) {
+            val previous = getParticipant(participant.sid)
+            participantStore.add(previous?.let {
+                participant.copy(isPinned = it.isPinned, isDominantSpeaker = it.isDominantSpeaker)
+            } ?: participant)
+        }
         updatePrimaryParticipant()
     }
 
     fun updateLocalParticipantVideoTrack(videoTrack: VideoTrackViewState?) =
-            mutableParticipants.find { it.isLocalParticipant }?.copy(
+            participantStore[localParticipantSid]?.copy(
                     videoTrack = videoTrack)?.let { updateLocalParticipant(it) }
 
     fun updateLocalParticipantSid(sid: String) =
-            mutableParticipants.find { it.isLocalParticipant }?.copy(
+            participantStore[localParticipantSid]?.copy(
                     sid = sid)?.let { updateLocalParticipant(it) }
 
-    fun updateParticipant(
-        participantViewState: ParticipantViewState,
-        participantMatchPredicate: (ParticipantViewState) -> Boolean = {
-            it.sid == participantViewState.sid }
-    ) {
-
-        mutableParticipants.indexOfFirst(participantMatchPredicate).let { index ->
-            if (index > -1) {
-                Timber.d("Updating participant: %s", participantViewState)
-                mutableParticipants[index] = participantViewState
-                updatePrimaryParticipant()
-            }
-        }
-    }
+    fun updateParticipant(participantViewState: ParticipantViewState) =
+            updateParticipant(participantViewState.sid, participantViewState)
 
     fun removeParticipant(sid: String) {
         Timber.d("Removing participant: %s", sid)
-        mutableParticipants.removeAll { it.sid == sid }
+        participantStore.remove(sid)
         updatePrimaryParticipant()
     }
 
-    fun getParticipant(sid: String): ParticipantViewState? = mutableParticipants.find { it.sid == sid }
+    fun getParticipant(sid: String): ParticipantViewState? = participantStore[sid]
 
     fun updateNetworkQuality(sid: String, networkQualityLevel: NetworkQualityLevel) {
         getParticipant(sid)?.copy(networkQualityLevel = networkQualityLevel)?.let {
@@ -62,13 +99,34 @@ class ParticipantManager {
     }
 
     fun updateParticipantVideoTrack(sid: String, videoTrack: VideoTrackViewState?) {
-        mutableParticipants.find { it.sid == sid }?.copy(
-                videoTrack = videoTrack)?.let { updateParticipant(it) }
+        getParticipant(sid)?.let {
+            updateParticipant(it.copy(videoTrack = videoTrack, isVideoDegraded = it.isVideoDegraded &&
+                    it.videoTrack?.videoTrack == videoTrack?.videoTrack))
+        }
+        if (sid == rejoinedSpeakerSid) getParticipant(sid)?.getRemoteVideoTrack()?.priority = HIGH
     }
 
     fun updateParticipantScreenTrack(sid: String, screenTrack: VideoTrackViewState?) {
-        mutableParticipants.find { it.sid == sid }?.copy(
-                screenTrack = screenTrack)?.let { updateParticipant(it) }
+        getParticipant(sid)?.let {
+            updateParticipant(it.copy(screenTrack = screenTrack, isVideoDegraded = it.isVideoDegraded &&
+                    it.screenTrack?.videoTrack == screenTrack?.videoTrack))
+        }
+    }
+
+    /**
+     * Marks the participant rendering [videoTrack] as having degraded video, see
+     * com.twilio.video.app.ui.room.RenderQualityMonitor. Degraded thumbnails are subscribed at
+     * [LOW] priority like those of a [QualityLevel.REDUCED_SUBSCRIPTION], so a stuck track stops
+     * competing with the primary participant for the bandwidth. Returns whether anything changed.
+     */
+    fun updateRenderQuality(videoTrack: VideoTrack, isDegraded: Boolean): Boolean {
+        val participant = participantStore.thumbnails.firstOrNull {
+            it.videoTrack?.videoTrack == videoTrack || it.screenTrack?.videoTrack == videoTrack
+        } ?: return false
+        if (participant.isVideoDegraded == isDegraded) return false
+        Timber.d("Video of participant with sid %s degraded: %b", participant.sid, isDegraded)
+        updateParticipant(participant.copy(isVideoDegraded = isDegraded))
+        return true
     }
 
     fun muteParticipant(sid: String, mute: Boolean) {
@@ -78,7 +136,7 @@ class ParticipantManager {
     }
 
     fun changePinnedParticipant(sid: String) {
-        val existingPin = mutableParticipants.find { it.isPinned }?.copy(
+        val existingPin = participantStore.pinnedParticipant?.copy(
             isPinned = false)
         existingPin?.let { updateParticipant(it) }
 
@@ -89,8 +147,21 @@ class ParticipantManager {
         }
     }
 
+    /** Applies a [com.twilio.video.app.sdk.SpeakerPrediction]. */
+    fun changePredictedSpeaker(speakerSid: String?, nextSpeakerSid: String?) {
+        if (predictedSpeakerSid != speakerSid) {
+            debugLog { "Predicted speaker with sid: $speakerSid" }
+            predictedSpeakerSid = speakerSid
+            updatePrimaryParticipant()
+        }
+        prewarmVideoTrack(nextSpeakerSid)
+    }
+
     fun changeDominantSpeaker(newDominantSpeakerSid: String?) {
         Timber.d("new dominant speaker with sid: %s", newDominantSpeakerSid)
+        clearRejoinedSpeaker()
+        val predictedSpeakerSid = predictedSpeakerSid
+        this.predictedSpeakerSid = null
         newDominantSpeakerSid?.let { _ ->
             clearDominantSpeaker()
 
@@ -99,44 +170,84 @@ class ParticipantManager {
         } ?: run {
             clearDominantSpeaker()
         }
+        // The room is the authority, the primary view follows it even if the prediction was wrong
+        if (predictedSpeakerSid != null) updatePrimaryParticipant()
+        prewarmVideoTrack(null)
     }
 
-    internal fun updateLocalParticipant(participantViewState: ParticipantViewState) =
-            updateParticipant(participantViewState) { it.isLocalParticipant }
+    internal fun updateLocalParticipant(participantViewState: ParticipantViewState) {
+        val sid = localParticipantSid
+        if (sid in participantStore) localParticipantSid = participantViewState.sid
+        updateParticipant(sid, participantViewState)
+    }
+
+    private fun updateParticipant(sid: String?, participantViewState: ParticipantViewState) {
+        if (participantStore.replace(sid, participantViewState)) {
+            Timber.d("Updating participant: %s", participantViewState)
+            updatePrimaryParticipant()
+        }
+    }
 
     private fun moveDominantSpeakerToTop(newDominantSpeaker: ParticipantViewState) {
-        if (mutableParticipants.size > 1) {
-            mutableParticipants.removeAll { it.sid == newDominantSpeaker.sid }
-            mutableParticipants.add(1, newDominantSpeaker)
+        if (participantStore.size > 1) {
+            participantStore.replace(newDominantSpeaker.sid, newDominantSpeaker)
+            participantStore.move(newDominantSpeaker.sid, 1)
             updatePrimaryParticipant()
         }
     }
 
+    /*
+     * A prewarmed track is subscribed at [HIGH] priority even while it is lowered by
+     * updateThumbnailPriorities, and falls back to the priority it has there once it is no
+     * longer prewarmed.
+     */
+    private fun prewarmVideoTrack(sid: String?) {
+        val videoTrack = sid?.let { getParticipant(it)?.getRemoteVideoTrack() }
+        if (videoTrack == prewarmedVideoTrack) return
+        val previousVideoTrack = prewarmedVideoTrack
+        prewarmedVideoTrack = videoTrack?.apply { priority = HIGH }
+        if (previousVideoTrack != null && previousVideoTrack != primaryParticipant.getRemoteVideoTrack()) {
+            previousVideoTrack.priority = if (previousVideoTrack in lowPriorityTracks) LOW else null
+        }
+    }
+
+    private fun clearRejoinedSpeaker() {
+        rejoinedSpeakerSid?.let { sid ->
+            getParticipant(sid)?.getRemoteVideoTrack()?.priority = null
+            rejoinedSpeakerSid = null
+        }
+    }
+
     private fun clearDominantSpeaker() {
-        mutableParticipants.find { it.isDominantSpeaker }?.copy(
+        participantStore.dominantSpeaker?.copy(
                 isDominantSpeaker = false)?.let { updateParticipant(it) }
     }
 
     fun clearRemoteParticipants() {
-        mutableParticipants.removeAll { !it.isLocalParticipant }
+        participantStore.removeAll { !it.isLocalParticipant }
+        rejoinedSpeakerSid = null
+        predictedSpeakerSid = null
+        prewarmedVideoTrack = null
         updatePrimaryParticipant()
     }
 
     private fun updatePrimaryParticipant() {
         primaryParticipant = retrievePrimaryParticipant()
-        Timber.d("Participant Cache: $mutableParticipants")
-        Timber.d("Primary Participant: $primaryParticipant")
+        updateThumbnailPriorities()
+        debugLog { "Primary Participant: $primaryParticipant, Participant Cache: ${participantStore.thumbnails}" }
     }
 
     private fun retrievePrimaryParticipant(): ParticipantViewState =
             determinePrimaryParticipant().apply { setTrackPriority(this) }
 
     private fun determinePrimaryParticipant(): ParticipantViewState {
-        return mutableParticipants.find { it.isPinned }
-                ?: mutableParticipants.find { it.isScreenSharing }
-                ?: mutableParticipants.find { it.isDominantSpeaker }
-                ?: mutableParticipants.find { !it.isLocalParticipant }
-                ?: mutableParticipants[0] // local participant
+        return participantStore.pinnedParticipant
+                ?: participantStore.screenSharingParticipant
+                ?: participantStore[predictedSpeakerSid]
+                ?: participantStore.dominantSpeaker
+                ?: participantStore.firstRemoteParticipant
+                ?: participantStore.firstParticipant // local participant
+                ?: primaryParticipant
     }
 
     private fun setTrackPriority(participant: ParticipantViewState) {
@@ -146,21 +257,21 @@ class ParticipantManager {
                     participant.getRemoteScreenTrack()?.let {
                         it.priority = HIGH
                         clearOldTrackPriorities()
-                        Timber.d("Setting screen track priority to high for participant with sid: ${participant.sid}")
+                        debugLog { "Setting screen track priority to high for participant with sid: ${participant.sid}" }
                     }
                 }
                 participant.isDominantSpeaker -> {
                     participant.getRemoteVideoTrack()?.let {
                         it.priority = null
                         clearOldTrackPriorities()
-                        Timber.d("Clearing dominant speaker priority for participant with sid: ${participant.sid}")
+                        debugLog { "Clearing dominant speaker priority for participant with sid: ${participant.sid}" }
                     }
                 }
                 else -> {
                     participant.getRemoteVideoTrack()?.let {
                         it.priority = HIGH
                         clearOldTrackPriorities()
-                        Timber.d("Setting video track priority to high for participant with sid: ${participant.sid}")
+                        debugLog { "Setting video track priority to high for participant with sid: ${participant.sid}" }
                     }
                 }
             }
@@ -169,11 +280,35 @@ class ParticipantManager {
         if (participant.isLocalParticipant) clearOldTrackPriorities()
     }
 
+    /*
+     * Only the tracks lowered here are reset, the priority of the primary participant is managed
+     * by setTrackPriority.
+     */
+    private fun updateThumbnailPriorities() {
+        val isReduced = qualityLevel >= QualityLevel.REDUCED_SUBSCRIPTION
+        if (!isReduced && lowPriorityTracks.isEmpty() &&
+                participantStore.thumbnails.none { it.isVideoDegraded }) return
+        val primaryVideoTrack = primaryParticipant.getRemoteVideoTrack()
+        val thumbnailTracks = participantStore.thumbnails
+                .filter { it.sid != primaryParticipant.sid && (isReduced || it.isVideoDegraded) }
+                .mapNotNullTo(HashSet()) { it.getRemoteVideoTrack() }
+        lowPriorityTracks.removeAll { videoTrack ->
+            (videoTrack !in thumbnailTracks).also { isRaised ->
+                if (isRaised && videoTrack != primaryVideoTrack && videoTrack != prewarmedVideoTrack) {
+                    videoTrack.priority = null
+                }
+            }
+        }
+        for (videoTrack in thumbnailTracks) {
+            if (lowPriorityTracks.add(videoTrack) && videoTrack != prewarmedVideoTrack) videoTrack.priority = LOW
+        }
+    }
+
     private fun clearOldTrackPriorities() {
         primaryParticipant.run {
             getRemoteVideoTrack()?.priority = null
             getRemoteScreenTrack()?.priority = null
-            Timber.d("Clearing video and screen track priorities for participant with sid: $sid")
+            debugLog { "Clearing video and screen track priorities for participant with sid: $sid" }
         }
     }
 }
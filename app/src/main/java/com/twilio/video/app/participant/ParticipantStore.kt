@@ -0,0 +1,152 @@
+package com.twilio.video.app.participant
+
+/**
+ * Holds the [ParticipantViewState]s of a room indexed by sid.
+ *
+ * Lookups and in place updates are O(1). Structural changes (add, remove, reorder) re-index the
+ * thumbnail order from the first affected position. The pinned, screen sharing, dominant speaker
+ * and first remote participant slots are maintained on every change so the primary participant
+ * can be resolved without scanning the thumbnails.
+ */
+internal class ParticipantStore {
+
+    private val participants = ArrayList<ParticipantViewState>()
+    private val indices = HashMap<String?, Int>()
+    private val pinnedSids = LinkedHashSet<String?>()
+    private val screenSharingSids = LinkedHashSet<String?>()
+    private val dominantSpeakerSids = LinkedHashSet<String?>()
+    private var firstRemoteIndex = NO_INDEX
+    private var thumbnailSnapshot: List<ParticipantViewState>? = null
+
+    val size: Int get() = participants.size
+
+    /** Immutable copy of the thumbnails in display order, only rebuilt after a change. */
+    val thumbnails: List<ParticipantViewState>
+        get() = thumbnailSnapshot ?: participants.toList().also { thumbnailSnapshot = it }
+
+    val pinnedParticipant: ParticipantViewState? get() = firstOf(pinnedSids)
+
+    val screenSharingParticipant: ParticipantViewState? get() = firstOf(screenSharingSids)
+
+    val dominantSpeaker: ParticipantViewState? get() = firstOf(dominantSpeakerSids)
+
+    val firstRemoteParticipant: ParticipantViewState?
+        get() = if (firstRemoteIndex != NO_INDEX) participants[firstRemoteIndex] else null
+
+    val firstParticipant: ParticipantViewState? get() = participants.firstOrNull()
+
+    operator fun get(sid: String?): ParticipantViewState? = indices[sid]?.let { participants[it] }
+
+    operator fun contains(sid: String?) = indices.containsKey(sid)
+
+    /**
+     * Appends the participant to the end of the thumbnails. A participant that is already stored
+     * is replaced in place instead.
+     */
+    fun add(participantViewState: ParticipantViewState) {
+        if (replace(participantViewState.sid, participantViewState)) return
+
+        val index = participants.size
+        participants.add(participantViewState)
+        indices[participantViewState.sid] = index
+        updateSlots(null, participantViewState)
+        if (firstRemoteIndex == NO_INDEX && !participantViewState.isLocalParticipant) {
+            firstRemoteIndex = index
+        }
+        thumbnailSnapshot = null
+    }
+
+    /**
+     * Replaces the participant stored under [sid] keeping its position. If the sid of the new
+     * state differs the participant is re-keyed, dropping any other entry stored under the new sid.
+     *
+     * @return false if no participant is stored under [sid].
+     */
+    fun replace(sid: String?, participantViewState: ParticipantViewState): Boolean {
+        if (sid !in indices) return false
+        val newSid = participantViewState.sid
+        if (newSid != sid) {
+            if (newSid in indices) remove(newSid)
+            indices.remove(sid)?.let { indices[newSid] = it }
+        }
+        val index = indices.getValue(newSid)
+        val oldState = participants[index]
+        participants[index] = participantViewState
+        updateSlots(oldState, participantViewState)
+        if (oldState.isLocalParticipant != participantViewState.isLocalParticipant) {
+            updateFirstRemoteIndex()
+        }
+        thumbnailSnapshot = null
+        return true
+    }
+
+    fun remove(sid: String?): ParticipantViewState? {
+        val index = indices.remove(sid) ?: return null
+        val removed = participants.removeAt(index)
+        reindex(index, participants.lastIndex)
+        updateSlots(removed, null)
+        if (firstRemoteIndex >= index) updateFirstRemoteIndex()
+        thumbnailSnapshot = null
+        return removed
+    }
+
+    fun removeAll(predicate: (ParticipantViewState) -> Boolean) {
+        val removed = participants.filter(predicate)
+        if (removed.isEmpty()) return
+        participants.removeAll(predicate)
+        removed.forEach {
+            indices.remove(it.sid)
+            updateSlots(it, null)
+        }
+        reindex(0, participants.lastIndex)
+        updateFirstRemoteIndex()
+        thumbnailSnapshot = null
+    }
+
+    /** Moves the participant stored under [sid] to [position] in the thumbnails. */
+    fun move(sid: String?, position: Int) {
+        val index = indices[sid] ?: return
+        val target = position.coerceIn(0, participants.lastIndex)
+        if (index == target) return
+        participants.add(target, participants.removeAt(index))
+        reindex(minOf(index, target), maxOf(index, target))
+        updateFirstRemoteIndex()
+        thumbnailSnapshot = null
+    }
+
+    private fun reindex(from: Int, to: Int) {
+        for (i in from..to) indices[participants[i].sid] = i
+    }
+
+    /*
+     * Only the participants in front of the first remote participant are visited, which in
+     * practice is the local participant alone.
+     */
+    private fun updateFirstRemoteIndex() {
+        firstRemoteIndex = participants.indexOfFirst { !it.isLocalParticipant }
+    }
+
+    private fun updateSlots(oldState: ParticipantViewState?, newState: ParticipantViewState?) {
+        updateSlot(pinnedSids, oldState, newState) { it.isPinned }
+        updateSlot(screenSharingSids, oldState, newState) { it.isScreenSharing }
+        updateSlot(dominantSpeakerSids, oldState, newState) { it.isDominantSpeaker }
+    }
+
+    private inline fun updateSlot(
+        slot: MutableSet<String?>,
+        oldState: ParticipantViewState?,
+        newState: ParticipantViewState?,
+        isInSlot: (ParticipantViewState) -> Boolean
+    ) {
+        val wasInSlot = oldState?.let(isInSlot) == true
+        val isNowInSlot = newState?.let(isInSlot) == true
+        if (wasInSlot && (!isNowInSlot || oldState?.sid != newState?.sid)) slot.remove(oldState?.sid)
+        if (isNowInSlot) slot.add(newState?.sid)
+    }
+
+    private fun firstOf(slot: Set<String?>) = if (slot.isEmpty()) null else get(slot.first())
+
+    private companion object {
+        const val NO_INDEX = -1
+    }
+}
@@ -16,7 +16,9 @@ data class ParticipantViewState(
     val isPinned: Boolean = false,
     val isDominantSpeaker: Boolean = false,
     val isLocalParticipant: Boolean = false,
-    val networkQualityLevel: NetworkQualityLevel = NETWORK_QUALITY_LEVEL_UNKNOWN
+    val networkQualityLevel: NetworkQualityLevel = NETWORK_QUALITY_LEVEL_UNKNOWN,
+    /** The rendered video or screen track freezes or stutters, see RenderQualityMonitor. */
+    val isVideoDegraded: Boolean = false
 ) {
     val isScreenSharing: Boolean get() = screenTrack != null
 
@@ -0,0 +1,20 @@
+package com.twilio.video.app.sdk
+
+import android.content.Context
+import com.twilio.video.LocalVideoTrack
+import com.twilio.video.VideoFormat
+import com.twilio.video.app.util.CameraCapturerCompat
+import com.twilio.video.app.util.FrameProcessor
+
+/** Creates the camera capturer of the local participant and the track it captures for. */
+class CameraTrackFactory {
+
+    fun createCapturer(context: Context, frameProcessors: List<FrameProcessor>): CameraCapturerCompat? =
+            CameraCapturerCompat.newInstance(context, frameProcessors)
+
+    fun createTrack(
+        context: Context,
+        cameraCapturer: CameraCapturerCompat,
+        videoFormat: VideoFormat
+    ): LocalVideoTrack? = LocalVideoTrack.create(context, true, cameraCapturer, videoFormat, CAMERA_TRACK_NAME)
+}
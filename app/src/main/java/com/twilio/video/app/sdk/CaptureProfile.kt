@@ -0,0 +1,249 @@
+package com.twilio.video.app.sdk
+
+import android.app.ActivityManager
+import android.content.Context
+import android.content.SharedPreferences
+import android.os.Build
+import android.os.SystemClock
+import androidx.core.content.edit
+import androidx.core.content.getSystemService
+import com.twilio.video.H264Codec
+import com.twilio.video.VideoDimensions
+import com.twilio.video.VideoFormat
+import com.twilio.video.Vp8Codec
+import com.twilio.video.app.data.Preferences
+import com.twilio.video.app.data.Preferences.VIDEO_DIMENSIONS
+import com.twilio.video.app.util.CameraCapturerCompat
+import com.twilio.video.app.util.hardwareVideoEncoders
+import timber.log.Timber
+
+const val CAPTURE_MAX_FRAME_RATE = 30
+const val CAPTURE_MIN_FRAME_RATE = 15
+const val LOW_FRAME_RATE_RATIO = 0.6
+const val LOW_FRAME_RATE_SAMPLES = 3
+const val CAPTURE_DOWNGRADE_COOLDOWN_MILLIS = 20_000L
+
+/*
+ * The dimensions a profile is picked from. Dimensions above 720p are only captured when chosen
+ * in the settings, and downgrades stop at CIF.
+ */
+private val CAPTURE_DIMENSIONS = VIDEO_DIMENSIONS
+        .take(VIDEO_DIMENSIONS.indexOf(VideoDimensions.HD_720P_VIDEO_DIMENSIONS) + 1)
+        .sortedBy { it.width * it.height }
+private val MIN_CAPTURE_DIMENSIONS = VideoDimensions.CIF_VIDEO_DIMENSIONS
+
+/** The capture format the camera is limited to from [QualityLevel.REDUCED_CAPTURE] on. */
+val REDUCED_CAPTURE_PROFILE = CaptureProfile(640, 480, CAPTURE_MIN_FRAME_RATE)
+
+/**
+ * The camera capture format and the video codec picked for a device.
+ *
+ * @param videoCodec [Vp8Codec.NAME] or [H264Codec.NAME]. H264 is only picked for devices that
+ * encode H264, but not VP8, in hardware.
+ */
+data class CaptureProfile(
+    val width: Int,
+    val height: Int,
+    val frameRate: Int,
+    val videoCodec: String = Vp8Codec.NAME
+) {
+    val pixels: Int get() = width * height
+
+    val videoFormat: VideoFormat get() = VideoFormat(VideoDimensions(width, height), frameRate)
+
+    /** Returns this profile capped at the pixels and the frame rate of [limit]. */
+    fun limitTo(limit: CaptureProfile): CaptureProfile {
+        val isTooLarge = pixels > limit.pixels
+        return copy(
+                width = if (isTooLarge) limit.width else width,
+                height = if (isTooLarge) limit.height else height,
+                frameRate = minOf(frameRate, limit.frameRate))
+    }
+
+    override fun toString() = "${width}x$height@$frameRate $videoCodec"
+}
+
+/**
+ * @param cameraSizes the output sizes of the camera, empty if unknown.
+ * @param maxCameraFrameRate the highest frame rate of the camera.
+ * @param hardwareEncoders the names of the video codecs encoded in hardware.
+ */
+data class CaptureCapabilities(
+    val cameraSizes: List<VideoDimensions>,
+    val maxCameraFrameRate: Int,
+    val hardwareEncoders: Set<String>,
+    val isLowRamDevice: Boolean,
+    val processorCount: Int
+) {
+    fun supports(dimensions: VideoDimensions) = cameraSizes.isEmpty() || cameraSizes.any {
+        it.width >= dimensions.width && it.height >= dimensions.height
+    }
+}
+
+/**
+ * Picks the largest capture format the device is expected to sustain. Low RAM devices capture VGA
+ * at 15 fps, devices without a hardware encoder or with few cores capture at most 540p, and the
+ * remaining devices capture 720p at 30 fps as far as the camera supports it.
+ */
+fun selectCaptureProfile(capabilities: CaptureCapabilities): CaptureProfile {
+    val hasHardwareEncoder = capabilities.hardwareEncoders.isNotEmpty()
+    val isMultiCore = capabilities.processorCount >= 6
+    val (maxDimensions, maxFrameRate) = when {
+        capabilities.isLowRamDevice -> VideoDimensions.VGA_VIDEO_DIMENSIONS to CAPTURE_MIN_FRAME_RATE
+        hasHardwareEncoder && isMultiCore -> VideoDimensions.HD_720P_VIDEO_DIMENSIONS to CAPTURE_MAX_FRAME_RATE
+        hasHardwareEncoder || isMultiCore -> VideoDimensions.HD_540P_VIDEO_DIMENSIONS to CAPTURE_MAX_FRAME_RATE
+        else -> VideoDimensions.VGA_VIDEO_DIMENSIONS to 24
+    }
+    val maxPixels = maxDimensions.width * maxDimensions.height
+    val dimensions = CAPTURE_DIMENSIONS.lastOrNull {
+        it.width * it.height <= maxPixels && capabilities.supports(it)
+    } ?: MIN_CAPTURE_DIMENSIONS
+    val frameRate = minOf(maxFrameRate, capabilities.maxCameraFrameRate)
+            .coerceAtLeast(CAPTURE_MIN_FRAME_RATE)
+    val videoCodec = if (Vp8Codec.NAME !in capabilities.hardwareEncoders &&
+            H264Codec.NAME in capabilities.hardwareEncoders) H264Codec.NAME else Vp8Codec.NAME
+    return CaptureProfile(dimensions.width, dimensions.height, frameRate, videoCodec)
+}
+
+/**
+ * Returns the next lower capture format of [profile], or null once it captures CIF at
+ * [CAPTURE_MIN_FRAME_RATE]. The resolution is lowered before the frame rate since the motion of a
+ * call suffers more from dropped frames than from fewer pixels.
+ */
+fun downgradeCaptureProfile(profile: CaptureProfile): CaptureProfile? {
+    val minPixels = MIN_CAPTURE_DIMENSIONS.width * MIN_CAPTURE_DIMENSIONS.height
+    val lowerDimensions = CAPTURE_DIMENSIONS.lastOrNull {
+        it.width * it.height in minPixels until profile.pixels
+    }
+    return when {
+        lowerDimensions != null -> profile.copy(width = lowerDimensions.width, height = lowerDimensions.height)
+        profile.frameRate > CAPTURE_MIN_FRAME_RATE -> profile.copy(frameRate = CAPTURE_MIN_FRAME_RATE)
+        else -> null
+    }
+}
+
+/**
+ * Probes the capture capabilities of the device once and caches the picked [CaptureProfile] in
+ * the shared preferences. The cache is invalidated when the build fingerprint changes, e.g. after a
+ * system update that ships new codecs.
+ */
+class CaptureProfileStore(
+    private val sharedPreferences: SharedPreferences,
+    private val fingerprint: String = Build.FINGERPRINT,
+    private val probe: () -> CaptureCapabilities
+) {
+
+    constructor(context: Context, sharedPreferences: SharedPreferences) :
+            this(sharedPreferences, probe = { probeCaptureCapabilities(context) })
+
+    @Volatile
+    private var profile: CaptureProfile? = null
+
+    fun get(): CaptureProfile = profile ?: synchronized(this) {
+        profile ?: (read() ?: selectCaptureProfile(probe()).also { write(it) }).also { profile = it }
+    }
+
+    private fun read(): CaptureProfile? {
+        val values = sharedPreferences.getString(Preferences.CAPTURE_PROFILE, null)
+                ?.split(';') ?: return null
+        if (values.size != 5 || values[0] != fingerprint) return null
+        return try {
+            CaptureProfile(values[1].toInt(), values[2].toInt(), values[3].toInt(), values[4])
+        } catch (e: NumberFormatException) {
+            null
+        }
+    }
+
+    private fun write(profile: CaptureProfile) {
+        Timber.d("Picked capture profile %s", profile)
+        sharedPreferences.edit {
+            putString(Preferences.CAPTURE_PROFILE, listOf(fingerprint, profile.width, profile.height,
+                    profile.frameRate, profile.videoCodec).joinToString(";"))
+        }
+    }
+}
+
+fun probeCaptureCapabilities(context: Context): CaptureCapabilities {
+    val (cameraSizes, maxCameraFrameRate) = CameraCapturerCompat.getCaptureCapabilities(context)
+            ?: emptyList<VideoDimensions>() to CAPTURE_MAX_FRAME_RATE
+    return CaptureCapabilities(
+            cameraSizes,
+            maxCameraFrameRate,
+            hardwareVideoEncoders(),
+            context.getSystemService<ActivityManager>()?.isLowRamDevice == true,
+            Runtime.getRuntime().availableProcessors())
+}
+
+/**
+ * Picks the format the camera track is captured with. The format is limited to
+ * [REDUCED_CAPTURE_PROFILE] from [QualityLevel.REDUCED_CAPTURE] on, so thermal and battery pressure
+ * reach the capture through the single [QualityLevelStepper] of the [QualityGovernor]. On top of
+ * that the format keeps being lowered while the encoded frame rate stays below
+ * [LOW_FRAME_RATE_RATIO] of the captured one for [LOW_FRAME_RATE_SAMPLES] stats samples. Every
+ * downgrade is given [CAPTURE_DOWNGRADE_COOLDOWN_MILLIS] to take effect before the next one. The
+ * format is never raised again while the same base profile is used.
+ */
+class CaptureFormatGovernor(
+    private val clock: () -> Long = SystemClock::elapsedRealtime,
+    private val onDowngrade: (CaptureProfile) -> Unit
+) {
+
+    private var baseProfile: CaptureProfile? = null
+    private var profile: CaptureProfile? = null
+    private var qualityLevel = QualityLevel.FULL
+    private var lowFrameRateSamples = 0
+    private var lastDowngradeMillis = Long.MIN_VALUE
+
+    /**
+     * Returns the format to capture [baseProfile] with, which is lower than [baseProfile] if it
+     * has been downgraded before or the quality level reduces the capture.
+     */
+    @Synchronized
+    fun govern(baseProfile: CaptureProfile): CaptureProfile {
+        if (this.baseProfile != baseProfile) {
+            this.baseProfile = baseProfile
+            profile = baseProfile
+            lowFrameRateSamples = 0
+        }
+        return limit(profile ?: baseProfile)
+    }
+
+    /**
+     * Applies the capture side of [qualityLevel] and returns the format to capture with from now
+     * on, or null if nothing has been governed yet.
+     */
+    @Synchronized
+    fun setQualityLevel(qualityLevel: QualityLevel): CaptureProfile? {
+        this.qualityLevel = qualityLevel
+        lowFrameRateSamples = 0
+        return profile?.let(::limit)
+    }
+
+    /** Reports the frame rate the camera track has been encoded with over the last stats interval. */
+    @Synchronized
+    fun onFrameRate(frameRate: Int) {
+        val profile = profile ?: return
+        val format = limit(profile)
+        lowFrameRateSamples = if (frameRate < format.frameRate * LOW_FRAME_RATE_RATIO) {
+            lowFrameRateSamples + 1
+        } else {
+            0
+        }
+        if (lowFrameRateSamples < LOW_FRAME_RATE_SAMPLES) return
+        val now = clock()
+        if (lastDowngradeMillis != Long.MIN_VALUE &&
+                now - lastDowngradeMillis < CAPTURE_DOWNGRADE_COOLDOWN_MILLIS) return
+        // The unlimited profile is lowered, so that it recovers once the quality level is raised
+        val lowerProfile = downgradeCaptureProfile(profile) ?: return
+        val lowerFormat = limit(lowerProfile)
+        Timber.i("Lowering the capture profile from %s to %s due to the encoded frame rate %d",
+                profile, lowerProfile, frameRate)
+        this.profile = lowerProfile
+        lowFrameRateSamples = 0
+        lastDowngradeMillis = now
+        if (lowerFormat != format) onDowngrade(lowerFormat)
+    }
+
+    private fun limit(profile: CaptureProfile) =
+            if (qualityLevel >= QualityLevel.REDUCED_CAPTURE) profile.limitTo(REDUCED_CAPTURE_PROFILE) else profile
+}
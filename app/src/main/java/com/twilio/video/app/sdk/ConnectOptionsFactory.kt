@@ -22,120 +22,92 @@ import com.twilio.video.VideoCodec
 import com.twilio.video.VideoContentPreferencesMode
 import com.twilio.video.Vp8Codec
 import com.twilio.video.Vp9Codec
-import com.twilio.video.app.data.Preferences
+import com.twilio.video.app.data.Settings
+import com.twilio.video.app.data.readSettings
 import com.twilio.video.app.data.api.TokenService
 import com.twilio.video.app.util.EnvUtil
-import com.twilio.video.app.util.get
 import com.twilio.video.ktx.createBandwidthProfileOptions
 import com.twilio.video.ktx.createConnectOptions
+import kotlinx.coroutines.async
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.flow.StateFlow
 import tvi.webrtc.voiceengine.WebRtcAudioManager
 import tvi.webrtc.voiceengine.WebRtcAudioUtils
 
 class ConnectOptionsFactory(
     private val context: Context,
     private val sharedPreferences: SharedPreferences,
-    private val tokenService: TokenService
+    private val tokenService: TokenService,
+    val settings: StateFlow<Settings>,
+    private val captureProfileStore: CaptureProfileStore
 ) {
 
-    suspend fun newInstance(identity: String, roomName: String): ConnectOptions {
-
-        setSdkEnvironment(sharedPreferences)
-        val token = tokenService.getToken(identity, roomName)
-        val enableInsights = sharedPreferences.getBoolean(
-                Preferences.ENABLE_INSIGHTS,
-                Preferences.ENABLE_INSIGHTS_DEFAULT)
-
-        val enableAutomaticTrackSubscription = sharedPreferences.get(
-                Preferences.ENABLE_AUTOMATIC_TRACK_SUBSCRIPTION,
-                Preferences.ENABLE_AUTOMATIC_TRACK_SUBSCRIPTION_DEFAULT)
-
-        val enableDominantSpeaker = sharedPreferences.get(
-                Preferences.ENABLE_DOMINANT_SPEAKER,
-                Preferences.ENABLE_DOMINANT_SPEAKER_DEFAULT)
-
-        val preferedVideoCodec: VideoCodec = getVideoCodecPreference(Preferences.VIDEO_CODEC)
-
-        val preferredAudioCodec: AudioCodec = getAudioCodecPreference()
+    /*
+     * The token is requested first so that the options are built while the request is in flight. A
+     * token fetched by prefetchToken is returned right away. The video codecs are only picked once
+     * the token is there, since the token service rewrites the codec and simulcast preferences when
+     * the topology of the room changes. Those are read from the preferences rather than [settings],
+     * which only catches up with the change once its listener ran on the main thread.
+     */
+    suspend fun newInstance(
+        identity: String,
+        roomName: String,
+        settings: Settings = this.settings.value
+    ): ConnectOptions = coroutineScope {
+        val token = async { tokenService.getToken(identity, roomName) }
+        setSdkEnvironment(settings.environment)
+
+        val preferredAudioCodec: AudioCodec = getAudioCodecPreference(settings.audioCodec)
 
         val configuration = NetworkQualityConfiguration(
                 NetworkQualityVerbosity.NETWORK_QUALITY_VERBOSITY_MINIMAL,
                 NetworkQualityVerbosity.NETWORK_QUALITY_VERBOSITY_MINIMAL)
 
-        val mode = sharedPreferences.get(Preferences.BANDWIDTH_PROFILE_MODE,
-                Preferences.BANDWIDTH_PROFILE_MODE_DEFAULT).let {
-            getBandwidthProfileMode(it)
-        }
-        val maxSubscriptionBitrate = sharedPreferences.get(Preferences.BANDWIDTH_PROFILE_MAX_SUBSCRIPTION_BITRATE,
-                Preferences.BANDWIDTH_PROFILE_MAX_SUBSCRIPTION_BITRATE_DEFAULT).toLong()
-
-        val dominantSpeakerPriority = sharedPreferences.get(Preferences.BANDWIDTH_PROFILE_DOMINANT_SPEAKER_PRIORITY,
-                Preferences.BANDWIDTH_PROFILE_DOMINANT_SPEAKER_PRIORITY_DEFAULT).let {
-            getDominantSpeakerPriority(it)
-        }
-        val trackSwitchOffMode = sharedPreferences.get(Preferences.BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_MODE,
-                Preferences.BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_MODE_DEFAULT).let {
-            getTrackSwitchOffMode(it)
-        }
-        val clientTrackSwitchOffControl = sharedPreferences.get(Preferences.BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_CONTROL,
-            Preferences.BANDWIDTH_PROFILE_TRACK_SWITCH_OFF_MODE_DEFAULT).let {
-                getClientTrackSwitchOffControl(it)
-        }
-        val videoContentPreferencesMode = sharedPreferences.get(Preferences.BANDWIDTH_PROFILE_VIDEO_CONTENT_PREFERENCES_MODE,
-                Preferences.BANDWIDTH_PROFILE_VIDEO_CONTENT_PREFERENCES_MODE_DEFAULT).let {
-            getVideoContentPreferencesMode(it)
-        }
+        val mode = getBandwidthProfileMode(settings.bandwidthProfileMode)
+        val dominantSpeakerPriority = getDominantSpeakerPriority(settings.dominantSpeakerPriority)
+        val trackSwitchOffMode = getTrackSwitchOffMode(settings.trackSwitchOffMode)
+        val clientTrackSwitchOffControl = getClientTrackSwitchOffControl(settings.trackSwitchOffControl)
+        val videoContentPreferencesMode = getVideoContentPreferencesMode(settings.videoContentPreferencesMode)
         val bandwidthProfileOptions = createBandwidthProfileOptions {
             mode(mode)
-            maxSubscriptionBitrate(maxSubscriptionBitrate)
+            maxSubscriptionBitrate(settings.maxSubscriptionBitrate.toLong())
             dominantSpeakerPriority(dominantSpeakerPriority)
             trackSwitchOffMode(trackSwitchOffMode)
             clientTrackSwitchOffControl?.let { clientTrackSwitchOffControl(it) }
             videoContentPreferencesMode?.let { videoContentPreferencesMode(it) }
         }
 
-        val acousticEchoCanceler = sharedPreferences.getBoolean(
-                Preferences.AUDIO_ACOUSTIC_ECHO_CANCELER,
-                Preferences.AUDIO_ACOUSTIC_ECHO_CANCELER_DEFAULT)
-        val noiseSuppressor = sharedPreferences.getBoolean(
-                Preferences.AUDIO_ACOUSTIC_NOISE_SUPRESSOR,
-                Preferences.AUDIO_ACOUSTIC_NOISE_SUPRESSOR_DEFAULT)
-        val automaticGainControl = sharedPreferences.getBoolean(
-                Preferences.AUDIO_AUTOMATIC_GAIN_CONTROL,
-                Preferences.AUDIO_AUTOMATIC_GAIN_CONTROL_DEFAULT)
-        val openSLESUsage = sharedPreferences.getBoolean(
-                Preferences.AUDIO_OPEN_SLES_USAGE,
-                Preferences.AUDIO_OPEN_SLES_USAGE_DEFAULT)
-        WebRtcAudioUtils.setWebRtcBasedAcousticEchoCanceler(!acousticEchoCanceler)
-        WebRtcAudioUtils.setWebRtcBasedNoiseSuppressor(!noiseSuppressor)
-        WebRtcAudioUtils.setWebRtcBasedAutomaticGainControl(!automaticGainControl)
-        WebRtcAudioManager.setBlacklistDeviceForOpenSLESUsage(!openSLESUsage)
-
-        val isNetworkQualityEnabled = sharedPreferences.get(
-                Preferences.ENABLE_NETWORK_QUALITY_LEVEL,
-                Preferences.ENABLE_NETWORK_QUALITY_LEVEL_DEFAULT)
-
-        val maxVideoBitrate = sharedPreferences.get(
-                Preferences.MAX_VIDEO_BITRATE,
-                Preferences.MAX_VIDEO_BITRATE_DEFAULT)
-
-        val maxAudioBitrate = sharedPreferences.get(
-                Preferences.MAX_AUDIO_BITRATE,
-                Preferences.MAX_AUDIO_BITRATE_DEFAULT)
-
-        return createConnectOptions(token) {
+        WebRtcAudioUtils.setWebRtcBasedAcousticEchoCanceler(!settings.acousticEchoCanceler)
+        WebRtcAudioUtils.setWebRtcBasedNoiseSuppressor(!settings.noiseSuppressor)
+        WebRtcAudioUtils.setWebRtcBasedAutomaticGainControl(!settings.automaticGainControl)
+        WebRtcAudioManager.setBlacklistDeviceForOpenSLESUsage(!settings.openSLESUsage)
+
+        val accessToken = token.await()
+        val preferedVideoCodecs: List<VideoCodec> =
+                getVideoCodecPreferences(sharedPreferences.readSettings())
+
+        createConnectOptions(accessToken) {
             roomName(roomName)
-            enableInsights(enableInsights)
-            enableAutomaticSubscription(enableAutomaticTrackSubscription)
-            enableDominantSpeaker(enableDominantSpeaker)
-            enableNetworkQuality(isNetworkQualityEnabled)
+            enableInsights(settings.enableInsights)
+            enableAutomaticSubscription(settings.enableAutomaticTrackSubscription)
+            enableDominantSpeaker(settings.enableDominantSpeaker)
+            enableNetworkQuality(settings.enableNetworkQualityLevel)
             networkQualityConfiguration(configuration)
             bandwidthProfile(bandwidthProfileOptions)
-            encodingParameters(EncodingParameters(maxAudioBitrate, maxVideoBitrate))
-            preferVideoCodecs(listOf(preferedVideoCodec))
+            encodingParameters(EncodingParameters(settings.maxAudioBitrate, settings.maxVideoBitrate))
+            preferVideoCodecs(preferedVideoCodecs)
             preferAudioCodecs(listOf(preferredAudioCodec))
         }
     }
 
+    /**
+     * Requests the token of a room ahead of [newInstance], e.g. while the room name is typed, so
+     * that connecting does not wait for the token service.
+     */
+    suspend fun prefetchToken(identity: String, roomName: String) {
+        tokenService.getToken(identity, roomName)
+    }
+
     private fun getTrackSwitchOffMode(trackSwitchOffModeString: String) =
             when (trackSwitchOffModeString) {
                 TrackSwitchOffMode.PREDICTED.name -> TrackSwitchOffMode.PREDICTED
@@ -175,38 +147,37 @@ class ConnectOptionsFactory(
         }
     }
 
-    private fun getVideoCodecPreference(key: String): VideoCodec {
-        return sharedPreferences.getString(key, Preferences.VIDEO_CODEC_DEFAULT)?.let { videoCodecName ->
-            when (videoCodecName) {
-                Vp8Codec.NAME -> {
-                    val simulcast = sharedPreferences.getBoolean(
-                            Preferences.VP8_SIMULCAST, Preferences.VP8_SIMULCAST_DEFAULT)
-                    Vp8Codec(simulcast)
-                }
-                H264Codec.NAME -> H264Codec()
-                Vp9Codec.NAME -> Vp9Codec()
-                else -> Vp8Codec()
-            }
-        } ?: Vp8Codec()
+    /*
+     * VP8 without simulcast falls back to H264 on devices that only encode H264 in hardware, see
+     * selectCaptureProfile.
+     */
+    private fun getVideoCodecPreferences(settings: Settings): List<VideoCodec> {
+        val videoCodec = getVideoCodecPreference(settings)
+        val isHardwareH264Preferred = videoCodec is Vp8Codec && !videoCodec.simulcast &&
+                captureProfileStore.get().videoCodec == H264Codec.NAME
+        return if (isHardwareH264Preferred) listOf(H264Codec(), videoCodec) else listOf(videoCodec)
     }
 
-    private fun getAudioCodecPreference(): AudioCodec {
-        return sharedPreferences.getString(
-                Preferences.AUDIO_CODEC, Preferences.AUDIO_CODEC_DEFAULT)?.let { audioCodecName ->
+    private fun getVideoCodecPreference(settings: Settings): VideoCodec {
+        return when (settings.videoCodec) {
+            Vp8Codec.NAME -> Vp8Codec(settings.vp8Simulcast)
+            H264Codec.NAME -> H264Codec()
+            Vp9Codec.NAME -> Vp9Codec()
+            else -> Vp8Codec()
+        }
+    }
 
-            when (audioCodecName) {
-                IsacCodec.NAME -> IsacCodec()
-                PcmaCodec.NAME -> PcmaCodec()
-                PcmuCodec.NAME -> PcmuCodec()
-                G722Codec.NAME -> G722Codec()
-                else -> OpusCodec()
-            }
-        } ?: OpusCodec()
+    private fun getAudioCodecPreference(audioCodecName: String): AudioCodec {
+        return when (audioCodecName) {
+            IsacCodec.NAME -> IsacCodec()
+            PcmaCodec.NAME -> PcmaCodec()
+            PcmuCodec.NAME -> PcmuCodec()
+            G722Codec.NAME -> G722Codec()
+            else -> OpusCodec()
+        }
     }
 
-    private fun setSdkEnvironment(sharedPreferences: SharedPreferences) {
-        val env = sharedPreferences.getString(
-                Preferences.ENVIRONMENT, Preferences.ENVIRONMENT_DEFAULT)
+    private fun setSdkEnvironment(env: String) {
         val nativeEnvironmentVariableValue = EnvUtil.getNativeEnvironmentVariableValue(env)
         Env.set(
                 context,
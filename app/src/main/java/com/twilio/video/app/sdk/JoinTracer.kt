@@ -0,0 +1,163 @@
+package com.twilio.video.app.sdk
+
+import android.os.Handler
+import android.os.Looper
+import android.os.SystemClock
+import androidx.core.os.TraceCompat
+import com.twilio.video.VideoTrack
+import timber.log.Timber
+import tvi.webrtc.VideoSink
+
+/** The milestones of joining a room in the order they are expected to be reached. */
+enum class JoinMilestone {
+    /** The user asked to join a room. */
+    JOIN_REQUESTED,
+    /** The connect options, which include the access token, are requested. */
+    CONNECT_OPTIONS_REQUESTED,
+    /** The connect options have been created and Video.connect is called. */
+    CONNECT_OPTIONS_CREATED,
+    /** Room.Listener.onConnected was invoked. */
+    ROOM_CONNECTED,
+    /** The local tracks are being published. */
+    LOCAL_TRACKS_PUBLISHING,
+    /** The first local track has been published. */
+    LOCAL_TRACK_PUBLISHED,
+    /** The first remote video track has been subscribed to. */
+    REMOTE_VIDEO_TRACK_SUBSCRIBED,
+    /** The first frame of a remote video track has been received by a sink. */
+    FIRST_REMOTE_FRAME
+}
+
+const val JOIN_SECTION_NAME = "Join"
+
+data class JoinMark(val milestone: JoinMilestone, val elapsedMillis: Long)
+
+/**
+ * @param marks the milestones reached, in the order they were reached, each with the time elapsed
+ * since [JoinMilestone.JOIN_REQUESTED].
+ * @param isComplete true if the first remote frame has been received.
+ */
+data class JoinTimeline(val marks: List<JoinMark>, val isComplete: Boolean) {
+
+    val totalMillis: Long get() = marks.lastOrNull()?.elapsedMillis ?: 0
+
+    /** The time spent reaching every milestone since the previous one. */
+    val phaseMillis: Map<JoinMilestone, Long>
+        get() = marks.zipWithNext { previous, next ->
+            next.milestone to next.elapsedMillis - previous.elapsedMillis
+        }.toMap()
+
+    /** One line per join suitable for logging and aggregating join latency percentiles. */
+    fun export(): String = buildString {
+        append("join total=").append(totalMillis).append("ms complete=").append(isComplete)
+        phaseMillis.forEach { (milestone, millis) ->
+            append(' ').append(milestone.name.toLowerCase()).append('=').append(millis).append("ms")
+        }
+    }
+}
+
+/**
+ * Records the milestones of a single room join. The join up to the first remote frame, or up to its
+ * end without one, is traced as the async [TraceCompat] section [JOIN_SECTION_NAME], and every phase
+ * between two milestones as an async section of its own, so joins show up in systrace and Perfetto
+ * captures and can be measured by the JoinBenchmark of the macrobenchmarks. The timeline
+ * is logged through Timber, and therefore the TreeRanger of release builds, once the first remote
+ * frame arrives or the join ends without one.
+ *
+ * Milestones can be marked from any thread. Only the first mark of a milestone per join counts.
+ *
+ * @param postToMain runs the removal of the sinks of [traceFirstFrame] on the main thread.
+ */
+class JoinTracer(
+    private val postToMain: (Runnable) -> Unit = { mainHandler.post(it) },
+    private val clock: () -> Long = SystemClock::elapsedRealtime
+) {
+
+    private val marks = ArrayList<JoinMark>(JoinMilestone.values().size)
+    private val firstFrameSinks = ArrayList<Pair<VideoTrack, VideoSink>>()
+    private var startMillis = 0L
+    private var joinCount = 0
+    private var isLogged = false
+
+    val isTracing: Boolean
+        @Synchronized get() = marks.isNotEmpty() && !isLogged
+
+    /** Starts the timeline of a new join, dropping the timeline of the previous one. */
+    @Synchronized
+    fun start() {
+        if (isTracing) TraceCompat.endAsyncSection(JOIN_SECTION_NAME, joinCount)
+        endSection()
+        marks.clear()
+        isLogged = false
+        joinCount++
+        startMillis = clock()
+        TraceCompat.beginAsyncSection(JOIN_SECTION_NAME, joinCount)
+        mark(JoinMilestone.JOIN_REQUESTED)
+    }
+
+    @Synchronized
+    fun mark(milestone: JoinMilestone) {
+        if (isLogged || marks.any { it.milestone == milestone }) return
+        if (milestone != JoinMilestone.JOIN_REQUESTED && marks.isEmpty()) return
+        endSection()
+        marks.add(JoinMark(milestone, clock() - startMillis))
+        if (milestone == JoinMilestone.FIRST_REMOTE_FRAME) {
+            log()
+        } else {
+            TraceCompat.beginAsyncSection(sectionName(milestone), joinCount)
+        }
+    }
+
+    /**
+     * Marks [JoinMilestone.FIRST_REMOTE_FRAME] once the first frame of [videoTrack] arrives at a
+     * sink. The sinks of every track are removed once the first frame of any of them arrives or the
+     * join ends, so that none of them keeps counting as a renderer of its track.
+     */
+    fun traceFirstFrame(videoTrack: VideoTrack) {
+        val sink = VideoSink { mark(JoinMilestone.FIRST_REMOTE_FRAME) }
+        synchronized(this) {
+            if (!isTracing) return
+            firstFrameSinks.add(videoTrack to sink)
+        }
+        videoTrack.addSink(sink)
+    }
+
+    /** Logs the timeline of a join that ended before a remote frame was received. */
+    @Synchronized
+    fun finish() {
+        if (!isTracing) return
+        endSection()
+        log()
+    }
+
+    @Synchronized
+    fun timeline() = JoinTimeline(marks.toList(),
+            marks.lastOrNull()?.milestone == JoinMilestone.FIRST_REMOTE_FRAME)
+
+    private fun log() {
+        isLogged = true
+        TraceCompat.endAsyncSection(JOIN_SECTION_NAME, joinCount)
+        Timber.i("%s", timeline().export())
+        removeFirstFrameSinks()
+    }
+
+    /* Never removed from within onFrame, which runs on the render thread of the track. */
+    private fun removeFirstFrameSinks() {
+        if (firstFrameSinks.isEmpty()) return
+        val sinks = firstFrameSinks.toList()
+        firstFrameSinks.clear()
+        postToMain(Runnable { sinks.forEach { (videoTrack, sink) -> videoTrack.removeSink(sink) } })
+    }
+
+    private fun endSection() {
+        val lastMark = marks.lastOrNull() ?: return
+        if (isLogged || lastMark.milestone == JoinMilestone.FIRST_REMOTE_FRAME) return
+        TraceCompat.endAsyncSection(sectionName(lastMark.milestone), joinCount)
+    }
+
+    private fun sectionName(milestone: JoinMilestone) = "$JOIN_SECTION_NAME after ${milestone.name}"
+
+    private companion object {
+        val mainHandler by lazy { Handler(Looper.getMainLooper()) }
+    }
+}
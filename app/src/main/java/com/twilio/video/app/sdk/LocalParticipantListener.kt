@@ -19,9 +19,12 @@ class LocalParticipantListener(private val roomManager: RoomManager) : LocalPart
                 localParticipant.sid, networkQualityLevel)
 
         roomManager.sendRoomEvent(NetworkQualityLevelChange(localParticipant.sid, networkQualityLevel))
+        roomManager.onLocalNetworkQualityLevel(networkQualityLevel)
     }
 
-    override fun onVideoTrackPublished(localParticipant: LocalParticipant, localVideoTrackPublication: LocalVideoTrackPublication) {}
+    override fun onVideoTrackPublished(localParticipant: LocalParticipant, localVideoTrackPublication: LocalVideoTrackPublication) {
+        roomManager.joinTracer.mark(JoinMilestone.LOCAL_TRACK_PUBLISHED)
+    }
 
     override fun onVideoTrackPublicationFailed(localParticipant: LocalParticipant, localVideoTrack: LocalVideoTrack, twilioException: TwilioException) {}
 
@@ -29,7 +32,9 @@ class LocalParticipantListener(private val roomManager: RoomManager) : LocalPart
 
     override fun onDataTrackPublicationFailed(localParticipant: LocalParticipant, localDataTrack: LocalDataTrack, twilioException: TwilioException) {}
 
-    override fun onAudioTrackPublished(localParticipant: LocalParticipant, localAudioTrackPublication: LocalAudioTrackPublication) {}
+    override fun onAudioTrackPublished(localParticipant: LocalParticipant, localAudioTrackPublication: LocalAudioTrackPublication) {
+        roomManager.joinTracer.mark(JoinMilestone.LOCAL_TRACK_PUBLISHED)
+    }
 
     override fun onAudioTrackPublicationFailed(localParticipant: LocalParticipant, localAudioTrack: LocalAudioTrack, twilioException: TwilioException) {}
 }
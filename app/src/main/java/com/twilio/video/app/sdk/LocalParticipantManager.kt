@@ -2,18 +2,20 @@ package com.twilio.video.app.sdk
 
 import android.content.Context
 import android.content.Intent
-import android.content.SharedPreferences
+import android.os.Handler
+import android.os.Looper
+import com.twilio.video.EncodingParameters
 import com.twilio.video.LocalAudioTrack
 import com.twilio.video.LocalParticipant
 import com.twilio.video.LocalTrackPublicationOptions
 import com.twilio.video.LocalVideoTrack
 import com.twilio.video.ScreenCapturer
+import com.twilio.video.StatsReport
 import com.twilio.video.TrackPriority
 import com.twilio.video.VideoFormat
 import com.twilio.video.app.R
-import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION
-import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION_DEFAULT
 import com.twilio.video.app.data.Preferences.VIDEO_DIMENSIONS
+import com.twilio.video.app.data.Settings
 import com.twilio.video.app.ui.room.RoomEvent.LocalParticipantEvent.AudioDisabled
 import com.twilio.video.app.ui.room.RoomEvent.LocalParticipantEvent.AudioEnabled
 import com.twilio.video.app.ui.room.RoomEvent.LocalParticipantEvent.AudioOff
@@ -24,15 +26,23 @@ import com.twilio.video.app.ui.room.RoomEvent.LocalParticipantEvent.VideoDisable
 import com.twilio.video.app.ui.room.RoomEvent.LocalParticipantEvent.VideoEnabled
 import com.twilio.video.app.ui.room.RoomEvent.LocalParticipantEvent.VideoTrackUpdated
 import com.twilio.video.app.util.CameraCapturerCompat
-import com.twilio.video.app.util.get
+import com.twilio.video.app.util.FrameProcessor
+import com.twilio.video.app.util.ScreenShareCapturer
 import com.twilio.video.ktx.createLocalAudioTrack
-import com.twilio.video.ktx.createLocalVideoTrack
+import kotlinx.coroutines.flow.StateFlow
 import timber.log.Timber
 
 class LocalParticipantManager(
     private val context: Context,
     private val roomManager: RoomManager,
-    private val sharedPreferences: SharedPreferences
+    private val settings: StateFlow<Settings>,
+    private val captureProfileStore: CaptureProfileStore,
+    /*
+     * Creates the stages every new camera capturer runs its frames through before they are encoded,
+     * e.g. a background blur. Camera frames reach the encoder unaltered without any.
+     */
+    private val frameProcessorsFactory: () -> List<FrameProcessor> = { emptyList() },
+    private val cameraTrackFactory: CameraTrackFactory = CameraTrackFactory()
 ) {
 
     private var localAudioTrack: LocalAudioTrack? = null
@@ -63,15 +73,70 @@ class LocalParticipantManager(
         }
     private var isAudioMuted = false
     private var isVideoMuted = false
+    private var isResumed = false
+    private var isCapturePaused = false
+    private var isCameraTrackDisabledOnPause = false
+    private var qualityLevel = QualityLevel.FULL
     internal val localVideoTrackNames: MutableMap<String, String> = HashMap()
+    private val mainHandler by lazy { Handler(Looper.getMainLooper()) }
+    private val captureFormatGovernor = CaptureFormatGovernor { profile ->
+        mainHandler.post { changeCaptureFormat(profile) }
+    }
 
     fun onResume() {
+        isResumed = true
         if (!isAudioMuted) setupLocalAudioTrack()
-        if (!isVideoMuted) setupLocalVideoTrack()
+        if (!isVideoMuted) {
+            if (isCapturePaused) resumeCapture() else setupLocalVideoTrack()
+        }
     }
 
     fun onPause() {
-        removeCameraTrack()
+        isResumed = false
+        if (settings.value.keepCameraAlive) {
+            pauseCapture()
+        } else {
+            removeCameraTrack()
+        }
+    }
+
+    /** Reports the encoded frame rate of the camera track to the [CaptureFormatGovernor]. */
+    fun onStatsReports(statsReports: List<StatsReport>) {
+        val cameraVideoTrack = cameraVideoTrack?.takeIf { it.isEnabled } ?: return
+        val trackSid = localParticipant?.localVideoTracks
+                ?.find { it.localVideoTrack == cameraVideoTrack }?.trackSid ?: return
+        statsReports.flatMap { it.localVideoTrackStats }
+                .filter { it.trackSid == trackSid }
+                .maxOfOrNull { it.frameRate }
+                ?.let { captureFormatGovernor.onFrameRate(it) }
+    }
+
+    /**
+     * Applies the camera side of [qualityLevel]. The [CaptureFormatGovernor] limits the capture
+     * format from [QualityLevel.REDUCED_CAPTURE] on and the camera track is removed at
+     * [QualityLevel.AUDIO_ONLY].
+     */
+    fun setQualityLevel(qualityLevel: QualityLevel) {
+        if (this.qualityLevel == qualityLevel) return
+        this.qualityLevel = qualityLevel
+        val captureFormat = captureFormatGovernor.setQualityLevel(qualityLevel)
+        when {
+            qualityLevel == QualityLevel.AUDIO_ONLY -> removeCameraTrack()
+            cameraVideoTrack == null -> if (isResumed && !isVideoMuted) setupLocalVideoTrack()
+            else -> captureFormat?.let { changeCaptureFormat(it) }
+        }
+    }
+
+    /**
+     * Caps the video bitrate of the local participant at [lowBandwidthVideoBitrate] while
+     * [isLowBandwidth], and restores the configured encoding parameters otherwise.
+     */
+    fun setLowBandwidth(isLowBandwidth: Boolean) {
+        val localParticipant = localParticipant ?: return
+        val settings = settings.value
+        val maxVideoBitrate = if (isLowBandwidth)
+            lowBandwidthVideoBitrate(settings.maxVideoBitrate) else settings.maxVideoBitrate
+        localParticipant.setEncodingParameters(EncodingParameters(settings.maxAudioBitrate, maxVideoBitrate))
     }
 
     fun toggleLocalVideo() {
@@ -118,11 +183,14 @@ class LocalParticipantManager(
         screenCapturer = ScreenCapturer(context, captureResultCode, captureIntent,
                 screenCapturerListener)
         screenCapturer?.let { screenCapturer ->
-            screenVideoTrack = createLocalVideoTrack(context, true, screenCapturer,
-                    name = SCREEN_TRACK_NAME)
+            val profile = ScreenShareProfile.forContent(settings.value.screenShareContent)
+            val displayMetrics = context.resources.displayMetrics
+            val videoFormat = VideoFormat(profile.targetDimensions(displayMetrics.widthPixels,
+                    displayMetrics.heightPixels), profile.maxFrameRate)
+            screenVideoTrack = LocalVideoTrack.create(context, true,
+                    ScreenShareCapturer(screenCapturer, profile), videoFormat, SCREEN_TRACK_NAME)
             screenVideoTrack?.let { screenVideoTrack ->
-                localVideoTrackNames[screenVideoTrack.name] =
-                        context.getString(R.string.screen_video_track)
+                registerVideoTrack(screenVideoTrack, context.getString(R.string.screen_video_track))
                 localParticipant?.publishTrack(screenVideoTrack,
                         LocalTrackPublicationOptions(TrackPriority.HIGH))
             } ?: Timber.e(RuntimeException(), "Failed to add screen video track")
@@ -132,23 +200,42 @@ class LocalParticipantManager(
     fun stopScreenCapture() {
         screenVideoTrack?.let { screenVideoTrack ->
             localParticipant?.unpublishTrack(screenVideoTrack)
-            screenVideoTrack.release()
-            localVideoTrackNames.remove(screenVideoTrack.name)
+            roomManager.nativeObjects.release(screenVideoTrack)
             this.screenVideoTrack = null
         }
     }
 
     fun publishLocalTracks() {
+        roomManager.joinTracer.mark(JoinMilestone.LOCAL_TRACKS_PUBLISHING)
         publishAudioTrack(localAudioTrack)
         publishCameraTrack(cameraVideoTrack)
+        // Only still shared when the room is rejoined or switched
+        screenVideoTrack?.let {
+            localParticipant?.publishTrack(it, LocalTrackPublicationOptions(TrackPriority.HIGH))
+        }
     }
 
     fun switchCamera() = cameraCapturer?.switchCamera()
 
+    /**
+     * Releases the local tracks and the camera capturer once neither a room nor the lobby preview
+     * needs them, along with any local object the registry still holds.
+     */
+    fun release() {
+        stopScreenCapture()
+        removeCameraTrack()
+        removeAudioTrack()
+        roomManager.nativeObjects.releaseAll(LOCAL_NATIVE_OBJECT_KINDS)
+    }
+
     private fun setupLocalAudioTrack() {
         if (localAudioTrack == null && !isAudioMuted) {
             localAudioTrack = createLocalAudioTrack(context, true, MICROPHONE_TRACK_NAME)
-            localAudioTrack?.let { publishAudioTrack(it) }
+            localAudioTrack?.let { localAudioTrack ->
+                roomManager.nativeObjects.register(NativeObjectKind.LOCAL_AUDIO_TRACK, localAudioTrack,
+                        localAudioTrack::release)
+                publishAudioTrack(localAudioTrack)
+            }
                     ?: Timber.e(RuntimeException(), "Failed to create local audio track")
         }
     }
@@ -168,6 +255,15 @@ class LocalParticipantManager(
         }
     }
 
+    /* The name shown in the stats only lives as long as the track. */
+    private fun registerVideoTrack(localVideoTrack: LocalVideoTrack, displayName: String) {
+        localVideoTrackNames[localVideoTrack.name] = displayName
+        roomManager.nativeObjects.register(NativeObjectKind.LOCAL_VIDEO_TRACK, localVideoTrack) {
+            localVideoTrackNames.remove(localVideoTrack.name)
+            localVideoTrack.release()
+        }
+    }
+
     private fun unpublishTrack(localVideoTrack: LocalVideoTrack?) =
             localVideoTrack?.let { localParticipant?.unpublishTrack(it) }
 
@@ -175,40 +271,88 @@ class LocalParticipantManager(
             localAudioTrack?.let { localParticipant?.unpublishTrack(it) }
 
     private fun setupLocalVideoTrack() {
-        val dimensionsIndex = sharedPreferences.get(VIDEO_CAPTURE_RESOLUTION,
-                VIDEO_CAPTURE_RESOLUTION_DEFAULT).toInt()
-        val videoFormat = VideoFormat(VIDEO_DIMENSIONS[dimensionsIndex], 30)
+        if (qualityLevel == QualityLevel.AUDIO_ONLY) {
+            Timber.i("Not capturing the camera at quality level %s", qualityLevel)
+            return
+        }
+        val videoFormat = captureFormatGovernor.govern(getCaptureProfile()).videoFormat
 
-        cameraCapturer = CameraCapturerCompat.newInstance(context)
+        cameraCapturer = cameraTrackFactory.createCapturer(context, frameProcessorsFactory())?.also {
+            roomManager.nativeObjects.register(NativeObjectKind.CAMERA_CAPTURER, it, it::dispose)
+        }
         cameraVideoTrack = cameraCapturer?.let { cameraCapturer ->
-            LocalVideoTrack.create(
-                    context,
-                    true,
-                    cameraCapturer,
-                    videoFormat,
-                    CAMERA_TRACK_NAME)
+            cameraTrackFactory.createTrack(context, cameraCapturer, videoFormat)
         }
         cameraVideoTrack?.let { cameraVideoTrack ->
-            localVideoTrackNames[cameraVideoTrack.name] = context.getString(R.string.camera_video_track)
+            registerVideoTrack(cameraVideoTrack, context.getString(R.string.camera_video_track))
             publishCameraTrack(cameraVideoTrack)
         } ?: run {
             Timber.e(RuntimeException(), "Failed to create the local camera video track")
         }
     }
 
+    /*
+     * The automatic capture resolution picks the profile of the device. Any other resolution chosen
+     * in the settings is captured at 30 fps as before.
+     */
+    private fun getCaptureProfile(): CaptureProfile {
+        val dimensionsIndex = settings.value.videoCaptureResolution
+        val deviceProfile = captureProfileStore.get()
+        val dimensions = dimensionsIndex.toIntOrNull()?.let { VIDEO_DIMENSIONS.getOrNull(it) }
+                ?: return deviceProfile
+        return deviceProfile.copy(width = dimensions.width, height = dimensions.height,
+                frameRate = CAPTURE_MAX_FRAME_RATE)
+    }
+
+    /*
+     * Keeps the camera track published and the capturer initialized while the app is paused, so
+     * that resuming neither enumerates the cameras nor renegotiates the track. The track is
+     * disabled so that remote participants do not see its last frame frozen.
+     */
+    private fun pauseCapture() {
+        val cameraVideoTrack = cameraVideoTrack ?: return
+        if (isCapturePaused) return
+        isCameraTrackDisabledOnPause = cameraVideoTrack.isEnabled
+        if (isCameraTrackDisabledOnPause) cameraVideoTrack.enable(false)
+        cameraCapturer?.stopCapture()
+        isCapturePaused = true
+    }
+
+    private fun resumeCapture() {
+        isCapturePaused = false
+        val cameraVideoTrack = cameraVideoTrack ?: return
+        val profile = captureFormatGovernor.govern(getCaptureProfile())
+        cameraCapturer?.startCapture(profile.width, profile.height, profile.frameRate)
+        if (isCameraTrackDisabledOnPause) cameraVideoTrack.enable(true)
+        isCameraTrackDisabledOnPause = false
+    }
+
+    private fun changeCaptureFormat(profile: CaptureProfile) {
+        // A paused capture picks up the format once it is resumed
+        if (cameraVideoTrack == null || isCapturePaused) return
+        cameraCapturer?.changeCaptureFormat(profile.width, profile.height, profile.frameRate)
+    }
+
+    /*
+     * The capturer is disposed first, its frame processors release their textures on the texture
+     * thread of the track, which the track disposes.
+     */
     private fun removeCameraTrack() {
+        cameraVideoTrack?.let { unpublishTrack(it) }
+        cameraCapturer?.let { roomManager.nativeObjects.release(it) }
+        cameraCapturer = null
         cameraVideoTrack?.let { cameraVideoTrack ->
-            unpublishTrack(cameraVideoTrack)
-            localVideoTrackNames.remove(cameraVideoTrack.name)
-            cameraVideoTrack.release()
+            roomManager.nativeObjects.release(cameraVideoTrack)
             this.cameraVideoTrack = null
         }
+        isCapturePaused = false
+        isCameraTrackDisabledOnPause = false
     }
 
     private fun removeAudioTrack() {
         localAudioTrack?.let { localAudioTrack ->
             unpublishTrack(localAudioTrack)
-            localAudioTrack.release()
+            roomManager.nativeObjects.release(localAudioTrack)
             this.localAudioTrack = null
         }
     }
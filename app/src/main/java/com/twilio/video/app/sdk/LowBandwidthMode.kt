@@ -0,0 +1,150 @@
+package com.twilio.video.app.sdk
+
+import android.os.SystemClock
+import com.twilio.video.NetworkQualityLevel
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_FIVE
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_FOUR
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_ONE
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_THREE
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_TWO
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_UNKNOWN
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_ZERO
+
+const val LOW_BANDWIDTH_ENTER_NETWORK_QUALITY = 1
+const val LOW_BANDWIDTH_EXIT_NETWORK_QUALITY = 3
+const val LOW_BANDWIDTH_ENTER_PACKET_LOSS_PERCENT = 10.0
+const val LOW_BANDWIDTH_EXIT_PACKET_LOSS_PERCENT = 3.0
+const val LOW_BANDWIDTH_RECOVERY_DELAY_MILLIS = 30_000L
+const val LOW_BANDWIDTH_MAX_VIDEO_BITRATE = 150
+
+/** The values of [com.twilio.video.app.data.Preferences.LOW_BANDWIDTH_MODE]. */
+enum class LowBandwidthMode {
+    /** Follows the [LowBandwidthDetector]. */
+    AUTOMATIC,
+    ON,
+    OFF
+}
+
+/**
+ * Returns the maximum video bitrate in Kbps to send in the low bandwidth mode given the configured
+ * [maxVideoBitrate], where 0 means unlimited.
+ */
+fun lowBandwidthVideoBitrate(maxVideoBitrate: Int) =
+        if (maxVideoBitrate in 1..LOW_BANDWIDTH_MAX_VIDEO_BITRATE) maxVideoBitrate else LOW_BANDWIDTH_MAX_VIDEO_BITRATE
+
+/**
+ * The packet loss of a call, split by direction.
+ *
+ * @param sendPercent the highest loss of the local tracks, all sent over the link of the local
+ * participant.
+ * @param receivePercent the median loss of the remote tracks. Every remote track comes in over the
+ * uplink of its own participant, so the median keeps a single participant with a poor uplink or a
+ * single lossy thumbnail from passing for a poor link of the local participant.
+ */
+data class PacketLoss(val sendPercent: Double, val receivePercent: Double) {
+
+    val percent get() = maxOf(sendPercent, receivePercent)
+}
+
+/** Returns the [PacketLoss] of a call given the [trackRates] of its tracks. */
+fun packetLoss(trackRates: Collection<TrackStatsRates>): PacketLoss {
+    var sendPercent = 0.0
+    val receivePercents = ArrayList<Double>(trackRates.size)
+    for (rates in trackRates) {
+        if (rates.isLocal) {
+            sendPercent = maxOf(sendPercent, rates.packetLossPercent)
+        } else {
+            receivePercents.add(rates.packetLossPercent)
+        }
+    }
+    receivePercents.sort()
+    val middle = receivePercents.size / 2
+    val receivePercent = when {
+        receivePercents.isEmpty() -> 0.0
+        receivePercents.size % 2 == 1 -> receivePercents[middle]
+        else -> (receivePercents[middle - 1] + receivePercents[middle]) / 2
+    }
+    return PacketLoss(sendPercent, receivePercent)
+}
+
+/**
+ * Detects links too poor to carry the video of a call. The low bandwidth mode is entered as soon as
+ * the network quality level of the local participant drops to [LOW_BANDWIDTH_ENTER_NETWORK_QUALITY]
+ * or the [PacketLoss] of the call reaches [LOW_BANDWIDTH_ENTER_PACKET_LOSS_PERCENT]. It is only left once the
+ * level is back at [LOW_BANDWIDTH_EXIT_NETWORK_QUALITY] and the loss below
+ * [LOW_BANDWIDTH_EXIT_PACKET_LOSS_PERCENT] for [recoveryDelayMillis], so that a link hovering
+ * around a threshold does not keep switching video on and off.
+ */
+class LowBandwidthDetector(
+    private val clock: () -> Long = SystemClock::elapsedRealtime,
+    private val recoveryDelayMillis: Long = LOW_BANDWIDTH_RECOVERY_DELAY_MILLIS
+) {
+
+    var isLowBandwidth = false
+        private set
+    private var networkQuality = -1
+    private var packetLossPercent = 0.0
+    private var recoveringSinceMillis: Long? = null
+
+    /** Returns the new state if [level] changes it, null otherwise. */
+    @Synchronized
+    fun onNetworkQualityLevel(level: NetworkQualityLevel): Boolean? {
+        networkQuality = level.toInt()
+        return evaluate()
+    }
+
+    /**
+     * Reports the packet loss of the call, the higher of the send and the receive loss of a
+     * [PacketLoss]. Recovery is evaluated with every report, so the mode is left within one stats
+     * interval of the recovery delay.
+     */
+    @Synchronized
+    fun onPacketLoss(packetLossPercent: Double): Boolean? {
+        this.packetLossPercent = packetLossPercent
+        return evaluate()
+    }
+
+    /** Reports the [packetLoss] of the [trackRates] of the call, see [onPacketLoss]. */
+    fun onTrackRates(trackRates: Collection<TrackStatsRates>): Boolean? =
+            onPacketLoss(packetLoss(trackRates).percent)
+
+    @Synchronized
+    fun reset() {
+        isLowBandwidth = false
+        networkQuality = -1
+        packetLossPercent = 0.0
+        recoveringSinceMillis = null
+    }
+
+    private fun evaluate(): Boolean? {
+        if (!isLowBandwidth) {
+            val isPoor = networkQuality in 0..LOW_BANDWIDTH_ENTER_NETWORK_QUALITY ||
+                    packetLossPercent >= LOW_BANDWIDTH_ENTER_PACKET_LOSS_PERCENT
+            if (!isPoor) return null
+            isLowBandwidth = true
+            return true
+        }
+        val isGood = (networkQuality < 0 || networkQuality >= LOW_BANDWIDTH_EXIT_NETWORK_QUALITY) &&
+                packetLossPercent < LOW_BANDWIDTH_EXIT_PACKET_LOSS_PERCENT
+        if (!isGood) {
+            recoveringSinceMillis = null
+            return null
+        }
+        val now = clock()
+        val recoveringSinceMillis = recoveringSinceMillis ?: now.also { recoveringSinceMillis = it }
+        if (now - recoveringSinceMillis < recoveryDelayMillis) return null
+        isLowBandwidth = false
+        this.recoveringSinceMillis = null
+        return false
+    }
+
+    private fun NetworkQualityLevel.toInt() = when (this) {
+        NETWORK_QUALITY_LEVEL_UNKNOWN -> -1
+        NETWORK_QUALITY_LEVEL_ZERO -> 0
+        NETWORK_QUALITY_LEVEL_ONE -> 1
+        NETWORK_QUALITY_LEVEL_TWO -> 2
+        NETWORK_QUALITY_LEVEL_THREE -> 3
+        NETWORK_QUALITY_LEVEL_FOUR -> 4
+        NETWORK_QUALITY_LEVEL_FIVE -> 5
+    }
+}
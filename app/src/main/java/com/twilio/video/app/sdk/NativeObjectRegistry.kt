@@ -0,0 +1,101 @@
+package com.twilio.video.app.sdk
+
+import android.os.Debug
+import java.util.IdentityHashMap
+
+/** The SDK objects backed by native memory that [NativeObjectRegistry] keeps track of. */
+enum class NativeObjectKind(val isRemote: Boolean = false) {
+    LOCAL_AUDIO_TRACK,
+    LOCAL_VIDEO_TRACK,
+    CAMERA_CAPTURER,
+    REMOTE_PARTICIPANT(isRemote = true),
+    REMOTE_VIDEO_TRACK(isRemote = true)
+}
+
+val LOCAL_NATIVE_OBJECT_KINDS = NativeObjectKind.values().filterNot { it.isRemote }.toSet()
+val REMOTE_NATIVE_OBJECT_KINDS = NativeObjectKind.values().filter { it.isRemote }.toSet()
+
+/**
+ * @param liveCounts the number of registered objects of every kind, kinds without any are left out.
+ * @param nativeHeapAllocatedBytes the native heap of the process, see [Debug.getNativeHeapAllocatedSize].
+ */
+data class NativeMemorySnapshot(
+    val liveCounts: Map<NativeObjectKind, Int>,
+    val nativeHeapAllocatedBytes: Long
+) {
+    fun liveCount(kind: NativeObjectKind) = liveCounts[kind] ?: 0
+
+    /** Formats the snapshot for the log and the debug overlay, [separator] goes between the values. */
+    fun format(separator: String = ", ") = buildString {
+        append("native heap: ").append(nativeHeapAllocatedBytes / 1024).append(" KiB")
+        for (kind in NativeObjectKind.values()) {
+            append(separator).append(kind.name.toLowerCase()).append(": ").append(liveCount(kind))
+        }
+    }
+
+    override fun toString() = format()
+}
+
+/**
+ * Tracks every native-backed SDK object the app holds from its creation to its release, so that
+ * back-to-back meetings do not accumulate tracks and capturers whose release path never ran.
+ * Local objects are registered with the action releasing them and are released through [release],
+ * [releaseAll] releases whatever is left once a room is left for good. Remote objects are owned and
+ * released by the SDK, registering them only counts them until they are unsubscribed or their
+ * participant disconnects, and drops the references once the room is gone.
+ *
+ * The counts and the native heap are reported by [snapshot], logged when a room is left and shown
+ * by the debug overlay of the room screen.
+ */
+class NativeObjectRegistry(
+    private val nativeHeapAllocatedBytes: () -> Long = Debug::getNativeHeapAllocatedSize
+) {
+
+    private class Entry(val kind: NativeObjectKind, val release: () -> Unit)
+
+    private val entries = IdentityHashMap<Any, Entry>()
+
+    /** Registers [obj], replacing a previous registration of the same object. */
+    @Synchronized
+    fun register(kind: NativeObjectKind, obj: Any, release: () -> Unit = {}) {
+        entries[obj] = Entry(kind, release)
+    }
+
+    /** Forgets [obj] without releasing it, e.g. once the SDK reports a remote track gone. */
+    @Synchronized
+    fun unregister(obj: Any) {
+        entries.remove(obj)
+    }
+
+    /** Releases [obj] if it is still registered, so that an object is never released twice. */
+    fun release(obj: Any) {
+        val entry = synchronized(this) { entries.remove(obj) } ?: return
+        entry.release()
+    }
+
+    /** Releases every registered object of [kinds] and returns how many there were. */
+    fun releaseAll(kinds: Set<NativeObjectKind> = NativeObjectKind.values().toSet()): Int {
+        val leftEntries = synchronized(this) {
+            val iterator = entries.values.iterator()
+            val leftEntries = mutableListOf<Entry>()
+            while (iterator.hasNext()) {
+                val entry = iterator.next()
+                if (entry.kind in kinds) {
+                    leftEntries.add(entry)
+                    iterator.remove()
+                }
+            }
+            leftEntries
+        }
+        leftEntries.forEach { it.release() }
+        return leftEntries.size
+    }
+
+    @Synchronized
+    fun liveCount(kind: NativeObjectKind) = entries.values.count { it.kind == kind }
+
+    fun snapshot(): NativeMemorySnapshot {
+        val liveCounts = synchronized(this) { entries.values.groupingBy { it.kind }.eachCount() }
+        return NativeMemorySnapshot(liveCounts, nativeHeapAllocatedBytes())
+    }
+}
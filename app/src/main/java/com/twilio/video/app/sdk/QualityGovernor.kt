@@ -0,0 +1,174 @@
+package com.twilio.video.app.sdk
+
+import android.content.BroadcastReceiver
+import android.content.Context
+import android.content.Intent
+import android.content.IntentFilter
+import android.os.BatteryManager
+import android.os.Build
+import android.os.Handler
+import android.os.Looper
+import android.os.PowerManager
+import android.os.SystemClock
+import androidx.core.content.getSystemService
+import timber.log.Timber
+
+const val QUALITY_RECOVERY_DELAY_MILLIS = 60_000L
+
+/** The degradation levels of a call in the order they are stepped through. */
+enum class QualityLevel {
+    /** The configured capture format, subscriptions and thumbnails. */
+    FULL,
+    /** The camera captures at most VGA at 15 fps, see [CaptureProfile.limitTo]. */
+    REDUCED_CAPTURE,
+    /**
+     * Thumbnail tracks are subscribed at a low priority and remote tracks are requested at most at
+     * VGA, see [com.twilio.video.app.ui.room.REDUCED_SUBSCRIPTION_VIDEO_DIMENSIONS].
+     */
+    REDUCED_SUBSCRIPTION,
+    /** Thumbnails stop rendering video, only the primary participant is rendered. */
+    NO_THUMBNAILS,
+    /** The camera track is removed and no remote video is rendered. */
+    AUDIO_ONLY
+}
+
+/**
+ * @param batteryPercent the battery level, or -1 if unknown.
+ */
+data class DeviceConditions(
+    val thermalStatus: Int = PowerManager.THERMAL_STATUS_NONE,
+    val batteryPercent: Int = -1,
+    val isCharging: Boolean = false
+) {
+    override fun toString() =
+            "thermal status $thermalStatus, battery $batteryPercent%${if (isCharging) " charging" else ""}"
+}
+
+/**
+ * Returns the quality level a device in [conditions] should run a call at. A charging device is
+ * only degraded by its thermal status.
+ */
+fun targetQualityLevel(conditions: DeviceConditions): QualityLevel {
+    val thermalLevel = when {
+        conditions.thermalStatus >= PowerManager.THERMAL_STATUS_CRITICAL -> QualityLevel.AUDIO_ONLY
+        conditions.thermalStatus >= PowerManager.THERMAL_STATUS_SEVERE -> QualityLevel.NO_THUMBNAILS
+        conditions.thermalStatus >= PowerManager.THERMAL_STATUS_MODERATE -> QualityLevel.REDUCED_SUBSCRIPTION
+        conditions.thermalStatus >= PowerManager.THERMAL_STATUS_LIGHT -> QualityLevel.REDUCED_CAPTURE
+        else -> QualityLevel.FULL
+    }
+    val battery = conditions.batteryPercent
+    val batteryLevel = when {
+        conditions.isCharging || battery < 0 -> QualityLevel.FULL
+        battery <= 5 -> QualityLevel.AUDIO_ONLY
+        battery <= 10 -> QualityLevel.NO_THUMBNAILS
+        battery <= 15 -> QualityLevel.REDUCED_SUBSCRIPTION
+        battery <= 20 -> QualityLevel.REDUCED_CAPTURE
+        else -> QualityLevel.FULL
+    }
+    return maxOf(thermalLevel, batteryLevel)
+}
+
+/**
+ * Steps the [QualityLevel] of a call towards the [targetQualityLevel] of the latest
+ * [DeviceConditions]. Worse conditions degrade the call right away, better conditions raise it one
+ * level at a time once the current level has been held for [recoveryDelayMillis], so that a device
+ * hovering around a threshold does not flip between levels.
+ */
+class QualityLevelStepper(
+    private val clock: () -> Long = SystemClock::elapsedRealtime,
+    private val recoveryDelayMillis: Long = QUALITY_RECOVERY_DELAY_MILLIS
+) {
+
+    var level = QualityLevel.FULL
+        private set
+    private var levelChangedMillis = 0L
+
+    /** Returns the new level if [conditions] change it, null otherwise. */
+    fun update(conditions: DeviceConditions): QualityLevel? {
+        val target = targetQualityLevel(conditions)
+        val now = clock()
+        val newLevel = when {
+            target > level -> target
+            target < level && now - levelChangedMillis >= recoveryDelayMillis ->
+                QualityLevel.values()[level.ordinal - 1]
+            else -> return null
+        }
+        level = newLevel
+        levelChangedMillis = now
+        return newLevel
+    }
+
+    /** True if the level is above the target of [conditions] and waits to be raised. */
+    fun isRecoveryPending(conditions: DeviceConditions) = targetQualityLevel(conditions) < level
+}
+
+/**
+ * Watches the thermal status and the battery level while the [com.twilio.video.app.ui.room.VideoService]
+ * of a call runs and reports every change of the [QualityLevel] to [onQualityLevelChanged] on the
+ * main thread. Every transition is logged along with the conditions that caused it so that quality
+ * complaints can be matched with the degradation of the call.
+ */
+class QualityGovernor(
+    private val context: Context,
+    private val onQualityLevelChanged: (QualityLevel) -> Unit
+) {
+
+    private val handler = Handler(Looper.getMainLooper())
+    private val stepper = QualityLevelStepper()
+    private var conditions = DeviceConditions()
+    private var isStarted = false
+    private val thermalStatusListener by lazy {
+        PowerManager.OnThermalStatusChangedListener { status ->
+            update(conditions.copy(thermalStatus = status))
+        }
+    }
+    private val batteryReceiver = object : BroadcastReceiver() {
+        override fun onReceive(context: Context, intent: Intent) = onBatteryChanged(intent)
+    }
+    private val recoveryRunnable = Runnable { update(conditions) }
+
+    fun start() {
+        if (isStarted) return
+        isStarted = true
+        context.registerReceiver(batteryReceiver, IntentFilter(Intent.ACTION_BATTERY_CHANGED))
+                ?.let { onBatteryChanged(it) }
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q) {
+            context.getSystemService<PowerManager>()
+                    ?.addThermalStatusListener(context.mainExecutor, thermalStatusListener)
+        }
+    }
+
+    fun stop() {
+        if (!isStarted) return
+        isStarted = false
+        context.unregisterReceiver(batteryReceiver)
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q) {
+            context.getSystemService<PowerManager>()?.removeThermalStatusListener(thermalStatusListener)
+        }
+        handler.removeCallbacks(recoveryRunnable)
+    }
+
+    private fun onBatteryChanged(intent: Intent) {
+        val level = intent.getIntExtra(BatteryManager.EXTRA_LEVEL, -1)
+        val scale = intent.getIntExtra(BatteryManager.EXTRA_SCALE, -1)
+        val status = intent.getIntExtra(BatteryManager.EXTRA_STATUS, -1)
+        update(conditions.copy(
+                batteryPercent = if (level >= 0 && scale > 0) level * 100 / scale else -1,
+                isCharging = status == BatteryManager.BATTERY_STATUS_CHARGING ||
+                        status == BatteryManager.BATTERY_STATUS_FULL))
+    }
+
+    private fun update(conditions: DeviceConditions) {
+        if (!isStarted) return
+        this.conditions = conditions
+        val previousLevel = stepper.level
+        stepper.update(conditions)?.let { level ->
+            Timber.i("Quality level changed from %s to %s due to %s", previousLevel, level, conditions)
+            onQualityLevelChanged(level)
+        }
+        handler.removeCallbacks(recoveryRunnable)
+        if (stepper.isRecoveryPending(conditions)) {
+            handler.postDelayed(recoveryRunnable, QUALITY_RECOVERY_DELAY_MILLIS)
+        }
+    }
+}
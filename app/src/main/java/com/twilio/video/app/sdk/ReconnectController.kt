@@ -0,0 +1,93 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.TwilioException.ACCESS_TOKEN_EXPIRED_EXCEPTION
+import com.twilio.video.TwilioException.MEDIA_CONNECTION_ERROR_EXCEPTION
+import com.twilio.video.TwilioException.SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION
+import com.twilio.video.TwilioException.SIGNALING_CONNECTION_ERROR_EXCEPTION
+import com.twilio.video.TwilioException.SIGNALING_CONNECTION_TIMEOUT_EXCEPTION
+
+const val MAX_REJOIN_ATTEMPTS = 3
+const val REJOIN_BACKOFF_MILLIS = 1000L
+
+/** The codes of the network errors a room is rejoined after, any other error returns to the lobby. */
+val REJOINABLE_EXCEPTION_CODES = setOf(
+        SIGNALING_CONNECTION_ERROR_EXCEPTION,
+        SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION,
+        SIGNALING_CONNECTION_TIMEOUT_EXCEPTION,
+        MEDIA_CONNECTION_ERROR_EXCEPTION)
+
+/**
+ * Decides whether [RoomManager] rejoins a room it got disconnected from. The SDK recovers short
+ * network handovers on its own between onReconnecting and onReconnected, a room is only rejoined
+ * once the SDK gives up with one of the [REJOINABLE_EXCEPTION_CODES]. The rejoin is retried up to
+ * [maxRejoinAttempts] times with a backoff doubling from [backoffMillis], unless the user asked to
+ * disconnect in the meantime.
+ */
+class ReconnectController(
+    private val maxRejoinAttempts: Int = MAX_REJOIN_ATTEMPTS,
+    private val backoffMillis: Long = REJOIN_BACKOFF_MILLIS
+) {
+
+    @Volatile
+    var isRejoining = false
+        private set
+    /** The number of rejoin attempts made since the room was last connected. */
+    @Volatile
+    var rejoinAttempts = 0
+        private set
+    @Volatile
+    var isDisconnectRequested = false
+        private set
+
+    @Synchronized
+    fun onConnecting() {
+        isDisconnectRequested = false
+    }
+
+    fun onConnected() = reset()
+
+    @Synchronized
+    fun onDisconnectRequested() {
+        isDisconnectRequested = true
+    }
+
+    /**
+     * Returns the delay after which the room is rejoined following a disconnect with
+     * [exceptionCode], or null to return to the lobby.
+     */
+    @Synchronized
+    fun onDisconnected(exceptionCode: Int?): Long? =
+            if (exceptionCode != null && exceptionCode in REJOINABLE_EXCEPTION_CODES) {
+                nextRejoinDelay()
+            } else giveUp()
+
+    /**
+     * Returns the delay before the next attempt when a rejoin fails with [exceptionCode], or null
+     * once the attempts are exhausted. Failures of a first connect are never retried. A rejoin
+     * rejected for the expiry of the reused token is retried, the next attempt requests a new one.
+     */
+    @Synchronized
+    fun onConnectFailure(exceptionCode: Int): Long? =
+            if (isRejoining && (exceptionCode in REJOINABLE_EXCEPTION_CODES ||
+                            exceptionCode == ACCESS_TOKEN_EXPIRED_EXCEPTION)) {
+                nextRejoinDelay()
+            } else giveUp()
+
+    /** Stops rejoining, e.g. once a rejoin can not even be started. */
+    @Synchronized
+    fun reset() {
+        isRejoining = false
+        rejoinAttempts = 0
+    }
+
+    private fun nextRejoinDelay(): Long? {
+        if (isDisconnectRequested || rejoinAttempts >= maxRejoinAttempts) return giveUp()
+        isRejoining = true
+        return backoffMillis shl rejoinAttempts++
+    }
+
+    private fun giveUp(): Long? {
+        reset()
+        return null
+    }
+}
@@ -22,6 +22,7 @@ class RemoteParticipantListener(private val roomManager: RoomManager) : RemotePa
         Timber.i("RemoteVideoTrack switched off for RemoteParticipant sid: %s, RemoteVideoTrack sid: %s",
                 remoteParticipant.sid, remoteVideoTrack.sid)
 
+        roomManager.onRemoteVideoTrackSwitchOff(remoteVideoTrack.sid, true)
         roomManager.sendRoomEvent(TrackSwitchOff(remoteParticipant.sid, remoteVideoTrack,
                 true))
     }
@@ -30,6 +31,7 @@ class RemoteParticipantListener(private val roomManager: RoomManager) : RemotePa
         Timber.i("RemoteVideoTrack switched on for RemoteParticipant sid: %s, RemoteVideoTrack sid: %s",
                 remoteParticipant.sid, remoteVideoTrack.sid)
 
+        roomManager.onRemoteVideoTrackSwitchOff(remoteVideoTrack.sid, false)
         roomManager.sendRoomEvent(TrackSwitchOff(remoteParticipant.sid, remoteVideoTrack,
                 false))
     }
@@ -38,10 +40,16 @@ class RemoteParticipantListener(private val roomManager: RoomManager) : RemotePa
         Timber.i("RemoteVideoTrack subscribed for RemoteParticipant sid: %s, RemoteVideoTrack sid: %s",
                 remoteParticipant.sid, remoteVideoTrack.sid)
 
+        roomManager.joinTracer.run {
+            mark(JoinMilestone.REMOTE_VIDEO_TRACK_SUBSCRIBED)
+            traceFirstFrame(remoteVideoTrack)
+        }
+
+        val sid = remoteParticipant.sid
         if (remoteVideoTrack.name.contains(SCREEN_TRACK_NAME))
-            roomManager.sendRoomEvent(ScreenTrackUpdated(remoteParticipant.sid, remoteVideoTrack))
+            roomManager.sendVideoTrackSubscribed(sid, remoteVideoTrack, ScreenTrackUpdated(sid, remoteVideoTrack))
         else
-            roomManager.sendRoomEvent(VideoTrackUpdated(remoteParticipant.sid, remoteVideoTrack))
+            roomManager.sendVideoTrackSubscribed(sid, remoteVideoTrack, VideoTrackUpdated(sid, remoteVideoTrack))
     }
 
     override fun onVideoTrackUnsubscribed(remoteParticipant: RemoteParticipant, remoteVideoTrackPublication: RemoteVideoTrackPublication, remoteVideoTrack: RemoteVideoTrack) {
@@ -49,9 +57,9 @@ class RemoteParticipantListener(private val roomManager: RoomManager) : RemotePa
                 remoteParticipant.sid, remoteVideoTrack.sid)
 
         if (remoteVideoTrack.name.contains(SCREEN_TRACK_NAME))
-            roomManager.sendRoomEvent(ScreenTrackUpdated(remoteParticipant.sid, null))
+            roomManager.sendVideoTrackUnsubscribed(remoteVideoTrack, ScreenTrackUpdated(remoteParticipant.sid, null))
         else
-            roomManager.sendRoomEvent(VideoTrackUpdated(remoteParticipant.sid, null))
+            roomManager.sendVideoTrackUnsubscribed(remoteVideoTrack, VideoTrackUpdated(remoteParticipant.sid, null))
     }
 
     override fun onNetworkQualityLevelChanged(remoteParticipant: RemoteParticipant, networkQualityLevel: NetworkQualityLevel) {
@@ -2,36 +2,55 @@ package com.twilio.video.app.sdk
 
 import android.content.Context
 import android.content.Intent
-import android.content.SharedPreferences
+import android.os.Handler
+import android.os.Looper
+import android.os.SystemClock
 import androidx.annotation.VisibleForTesting
 import androidx.annotation.VisibleForTesting.PRIVATE
+import com.twilio.video.ClientTrackSwitchOffControl
+import com.twilio.video.NetworkQualityLevel
 import com.twilio.video.Participant
 import com.twilio.video.RemoteParticipant
+import com.twilio.video.RemoteVideoTrack
 import com.twilio.video.Room
 import com.twilio.video.StatsReport
 import com.twilio.video.TwilioException
 import com.twilio.video.TwilioException.ROOM_MAX_PARTICIPANTS_EXCEEDED_EXCEPTION
+import com.twilio.video.app.data.Settings
 import com.twilio.video.app.data.api.AuthServiceError
 import com.twilio.video.app.data.api.AuthServiceException
+import com.twilio.video.app.telemetry.CallQualityCollector
+import com.twilio.video.app.telemetry.CallTelemetry
 import com.twilio.video.app.ui.room.RoomEvent
 import com.twilio.video.app.ui.room.RoomEvent.ConnectFailure
 import com.twilio.video.app.ui.room.RoomEvent.Connected
 import com.twilio.video.app.ui.room.RoomEvent.Connecting
 import com.twilio.video.app.ui.room.RoomEvent.Disconnected
 import com.twilio.video.app.ui.room.RoomEvent.DominantSpeakerChanged
+import com.twilio.video.app.ui.room.RoomEvent.LowBandwidthModeChanged
 import com.twilio.video.app.ui.room.RoomEvent.MaxParticipantFailure
+import com.twilio.video.app.ui.room.RoomEvent.QualityLevelChanged
+import com.twilio.video.app.ui.room.RoomEvent.Reconnected
+import com.twilio.video.app.ui.room.RoomEvent.Reconnecting
 import com.twilio.video.app.ui.room.RoomEvent.RecordingStarted
 import com.twilio.video.app.ui.room.RoomEvent.RecordingStopped
 import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParticipantConnected
 import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParticipantDisconnected
+import com.twilio.video.app.ui.room.RoomEvent.RoomSwitchFailure
+import com.twilio.video.app.ui.room.RoomEvent.SpeakerPredicted
 import com.twilio.video.app.ui.room.RoomEvent.StatsUpdate
 import com.twilio.video.app.ui.room.VideoService.Companion.startService
 import com.twilio.video.app.ui.room.VideoService.Companion.stopService
+import com.twilio.video.app.util.debugLog
+import kotlinx.coroutines.CancellationException
 import kotlinx.coroutines.CoroutineDispatcher
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.SharedFlow
+import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.launch
 import timber.log.Timber
 
@@ -41,27 +60,64 @@ const val SCREEN_TRACK_NAME = "screen"
 
 class RoomManager(
     private val context: Context,
-    private val videoClient: VideoClient,
-    sharedPreferences: SharedPreferences,
-    coroutineDispatcher: CoroutineDispatcher = Dispatchers.IO
+    videoClient: Lazy<VideoClient>,
+    coroutineDispatcher: CoroutineDispatcher = Dispatchers.IO,
+    val joinTracer: JoinTracer = JoinTracer(),
+    private val settings: StateFlow<Settings>,
+    captureProfileStore: CaptureProfileStore,
+    val nativeObjects: NativeObjectRegistry = NativeObjectRegistry(),
+    private val callTelemetry: CallTelemetry? = null
 ) {
 
+    /** Built on the first token prefetch or connect, not while the lobby starts. */
+    private val videoClient by videoClient
+
     private var statsScheduler: StatsScheduler? = null
+    private var statsSubscriberCount = 0
+    private val statsHistory = StatsHistory()
+    private val lowBandwidthDetector = LowBandwidthDetector()
+    private val speakerDetector = SpeakerDetector()
+    @Volatile
+    private var isSpeakerDetectionEnabled = false
+    private val callQualityCollector = CallQualityCollector()
+    @Volatile
+    private var isQualityTelemetryEnabled = false
+    /* Only read and written on the main thread, see updateLowBandwidthMode. */
+    private var isLowBandwidth = false
+    private val mainHandler by lazy { Handler(Looper.getMainLooper()) }
     private val roomListener = RoomListener()
+    private val reconnectController = ReconnectController()
+    private val subscriptionScheduler = TrackSubscriptionScheduler(::sendRoomEvent)
+    private var rejoinJob: Job? = null
+    @Volatile
+    private var standbyRoom: StandbyRoom? = null
+    private var isSwitchingRoom = false
+    private var identity: String? = null
+    private var roomName: String? = null
     @VisibleForTesting(otherwise = PRIVATE)
     internal var roomScope = CoroutineScope(coroutineDispatcher)
     private val mutableRoomEvents: MutableSharedFlow<RoomEvent> = MutableSharedFlow()
     val roomEvents: SharedFlow<RoomEvent> = mutableRoomEvents
     @VisibleForTesting(otherwise = PRIVATE)
     internal var localParticipantManager: LocalParticipantManager =
-            LocalParticipantManager(context, this, sharedPreferences)
+            LocalParticipantManager(context, this, settings, captureProfileStore)
     var room: Room? = null
 
     fun disconnect() {
+        reconnectController.onDisconnectRequested()
+        dropStandbyRoom()
+        if (rejoinJob?.isActive == true) {
+            rejoinJob?.cancel()
+            leaveRoom()
+        }
         room?.disconnect()
     }
 
     suspend fun connect(identity: String, roomName: String) {
+        this.identity = identity
+        this.roomName = roomName
+        reconnectController.onConnecting()
+        joinTracer.start()
         sendRoomEvent(Connecting)
         connectToRoom(identity, roomName)
     }
@@ -78,13 +134,215 @@ class RoomManager(
         }
     }
 
+    /**
+     * Connects [roomName] on standby next to the room of the call, e.g. a breakout room the user is
+     * about to move to, so that a following [switchRoom] to it neither waits for the token nor for
+     * the connect. Replaces any other standby room. The user already shows up as a participant of
+     * the standby room, without tracks, and hears none of it.
+     */
+    fun preconnect(roomName: String) {
+        val identity = identity ?: return
+        if (room == null || standbyRoom?.roomName == roomName) return
+        dropStandbyRoom()
+        val standbyRoom = StandbyRoom(roomName, roomListener, ::onStandbyRoomConnected, ::onStandbyRoomFailed)
+        this.standbyRoom = standbyRoom
+        roomScope.launch {
+            try {
+                standbyRoom.room = videoClient.preconnect(identity, roomName, standbyRoom)
+            } catch (e: CancellationException) {
+                throw e
+            } catch (e: Exception) {
+                Timber.w(e, "Failed to preconnect room %s", roomName)
+                onStandbyRoomFailed(standbyRoom, null)
+            }
+        }
+    }
+
+    /** Drops the room connected by [preconnect] unless the call is already switching to it. */
+    fun cancelPreconnect() {
+        if (standbyRoom?.isSwitchRequested == false) dropStandbyRoom()
+    }
+
+    /**
+     * Moves the call to [roomName] without leaving it, the local tracks and their capturers are
+     * kept as they are. The current room stays connected until [roomName] is, which is connected
+     * now unless [preconnect] did already. Reports [RoomSwitchFailure] if it can not be joined.
+     */
+    fun switchRoom(roomName: String) {
+        if (room == null || room?.name == roomName) return
+        preconnect(roomName)
+        val standbyRoom = standbyRoom ?: return
+        Timber.i("Switching to room %s", roomName)
+        standbyRoom.isSwitchRequested = true
+        if (standbyRoom.isConnected) switchToStandbyRoom(standbyRoom)
+    }
+
+    private fun onStandbyRoomConnected(standbyRoom: StandbyRoom) {
+        if (standbyRoom !== this.standbyRoom) {
+            standbyRoom.disconnect()
+        } else if (standbyRoom.isSwitchRequested) {
+            switchToStandbyRoom(standbyRoom)
+        }
+    }
+
+    private fun onStandbyRoomFailed(standbyRoom: StandbyRoom, twilioException: TwilioException?) {
+        Timber.w("Lost standby room %s with error %d", standbyRoom.roomName, twilioException?.code)
+        if (standbyRoom !== this.standbyRoom) return
+        this.standbyRoom = null
+        if (standbyRoom.isSwitchRequested) sendRoomEvent(RoomSwitchFailure(standbyRoom.roomName))
+    }
+
+    private fun dropStandbyRoom() {
+        standbyRoom?.disconnect()
+        standbyRoom = null
+    }
+
+    /*
+     * Switches on the main thread in one go, no event of either room is handled in between. The
+     * previous room is disconnected right before the local tracks are published to the new one, so
+     * that no track is ever published to both. From then on the new room is the room of the call,
+     * e.g. it is rejoined if it is lost, and the call quality spans both rooms.
+     */
+    private fun switchToStandbyRoom(standbyRoom: StandbyRoom) {
+        val newRoom = standbyRoom.room ?: return
+        val previousRoom = room
+        this.standbyRoom = null
+        rejoinJob?.cancel()
+
+        statsScheduler?.stop()
+        statsScheduler = null
+        statsHistory.clear()
+        subscriptionScheduler.reset()
+        speakerDetector.reset()
+        val remoteObjectCount = nativeObjects.releaseAll(REMOTE_NATIVE_OBJECT_KINDS)
+        Timber.i("Switching from room %s to %s, dropped %d remote objects",
+                previousRoom?.name, newRoom.name, remoteObjectCount)
+
+        localParticipantManager.localParticipant = null
+        room = null
+        previousRoom?.disconnect()
+        roomName = newRoom.name
+        videoClient.onRoomSwitched(newRoom.name)
+        standbyRoom.activate()
+        isSwitchingRoom = true
+        roomListener.onConnected(newRoom)
+        isSwitchingRoom = false
+    }
+
+    /**
+     * Prefetches the token of [roomName] so that a following [connect] goes straight to
+     * connecting. Failures are only logged, [connect] requests the token again.
+     */
+    fun prefetchToken(identity: String, roomName: String) =
+            roomScope.launch {
+                try {
+                    videoClient.prefetchToken(identity, roomName)
+                } catch (e: CancellationException) {
+                    throw e
+                } catch (e: Exception) {
+                    Timber.w(e, "Failed to prefetch token")
+                }
+            }
+
+    /*
+     * The first attempt reuses the connect options of the lost room to skip the token service, the
+     * following ones build new options, which request a new token if the cached one expired.
+     */
+    private fun rejoin(delayMillis: Long) {
+        rejoinJob = roomScope.launch {
+            delay(delayMillis)
+            Timber.i("Rejoining room %s, attempt %d", roomName, reconnectController.rejoinAttempts)
+            try {
+                val rejoinedRoom = if (reconnectController.rejoinAttempts == 1) {
+                    videoClient.rejoin(roomListener)
+                } else null
+                room = rejoinedRoom ?: videoClient.connect(identity!!, roomName!!, roomListener)
+            } catch (e: CancellationException) {
+                throw e
+            } catch (e: Exception) {
+                Timber.w(e, "Failed to rejoin room %s", roomName)
+                reconnectController.reset()
+                leaveRoom()
+                sendRoomEvent(ConnectFailure)
+            }
+        }
+    }
+
+    /**
+     * Returns to the lobby once the room is left for good, the local tracks stay alive for the
+     * preview, see [releaseIfIdle]. The screen share only lives as long as the room.
+     */
+    private fun leaveRoom() {
+        stopService(context)
+        dropStandbyRoom()
+        joinTracer.finish()
+        reportCallQuality()
+        localParticipantManager.stopScreenCapture()
+        Timber.i("Left room, %s", nativeObjects.snapshot())
+
+        sendRoomEvent(Disconnected)
+
+        lowBandwidthDetector.reset()
+        if (isLowBandwidth) {
+            isLowBandwidth = false
+            sendRoomEvent(LowBandwidthModeChanged(false, LOW_BANDWIDTH_KEEP_DOMINANT_SPEAKER_DEFAULT))
+        }
+    }
+
+    /* A call spans every rejoin, its join latency is the one of the first join. */
+    private fun reportCallQuality() {
+        val joinTimeline = joinTracer.timeline()
+        val joinMillis = if (joinTimeline.isComplete) joinTimeline.totalMillis else -1
+        val summary = callQualityCollector.finish(SystemClock.elapsedRealtime(), joinMillis) ?: return
+        roomScope.launch { callTelemetry?.report(summary) }
+    }
+
+    /** Feeds the switch off time of remote video to the call quality telemetry. */
+    fun onRemoteVideoTrackSwitchOff(trackSid: String, isSwitchedOff: Boolean) {
+        if (isQualityTelemetryEnabled) {
+            callQualityCollector.onTrackSwitchOff(trackSid, isSwitchedOff, SystemClock.elapsedRealtime())
+        }
+    }
+
+    /** Counts a rendered remote video track that froze, see RenderQualityMonitor. */
+    fun onRenderFreeze() {
+        if (isQualityTelemetryEnabled) callQualityCollector.onRenderFreeze()
+    }
+
+    /**
+     * Releases the local tracks once the room screen is gone for good, unless a room still uses
+     * them or is being rejoined.
+     */
+    fun releaseIfIdle() {
+        if (room != null || rejoinJob?.isActive == true) return
+        localParticipantManager.release()
+        Timber.i("Released local tracks, %s", nativeObjects.snapshot())
+    }
+
+    /** Whether video tracks reach the view through the [TrackSubscriptionScheduler]. */
+    val isTrackSubscriptionScheduled get() = subscriptionScheduler.isEnabled
+
+    fun sendVideoTrackSubscribed(sid: String, videoTrack: RemoteVideoTrack, roomEvent: RoomEvent) {
+        nativeObjects.register(NativeObjectKind.REMOTE_VIDEO_TRACK, videoTrack)
+        subscriptionScheduler.onVideoTrackSubscribed(sid, videoTrack, roomEvent)
+    }
+
+    fun sendVideoTrackUnsubscribed(videoTrack: RemoteVideoTrack, roomEvent: RoomEvent) {
+        nativeObjects.unregister(videoTrack)
+        subscriptionScheduler.onVideoTrackUnsubscribed(videoTrack, roomEvent)
+    }
+
+    fun updateSubscriptionPriorities(primarySid: String?, thumbnailSids: List<String?>) =
+            subscriptionScheduler.updatePriorities(primarySid, thumbnailSids)
+
     fun sendRoomEvent(roomEvent: RoomEvent) {
-        Timber.d("sendRoomEvent: $roomEvent")
+        debugLog { "sendRoomEvent: $roomEvent" }
         roomScope.launch { mutableRoomEvents.emit(roomEvent) }
     }
 
     private fun handleTokenException(e: Exception, error: AuthServiceError? = null): Room? {
         Timber.e(e, "Failed to retrieve token")
+        joinTracer.finish()
         sendRoomEvent(RoomEvent.TokenError(serviceError = error))
         return null
     }
@@ -115,17 +373,138 @@ class RoomManager(
 
     fun switchCamera() = localParticipantManager.switchCamera()
 
+    /** Applies [qualityLevel] to the local tracks and reports it to the view model. */
+    fun setQualityLevel(qualityLevel: QualityLevel) {
+        localParticipantManager.setQualityLevel(qualityLevel)
+        sendRoomEvent(QualityLevelChanged(qualityLevel))
+    }
+
+    /** Feeds the network quality level of the local participant to the [LowBandwidthDetector]. */
+    fun onLocalNetworkQualityLevel(networkQualityLevel: NetworkQualityLevel) {
+        onLowBandwidthSample { lowBandwidthDetector.onNetworkQualityLevel(networkQualityLevel) }
+    }
+
+    /*
+     * Samples come from the SDK listeners and from the stats thread. Both are handed to the main
+     * thread, which feeds the detector and applies the mode, and dropped once the room is gone.
+     */
+    private fun onLowBandwidthSample(sample: () -> Unit) {
+        mainHandler.post {
+            if (room == null) return@post
+            sample()
+            updateLowBandwidthMode()
+        }
+    }
+
+    /**
+     * Applies the [LowBandwidthMode] chosen in the settings, or the state of the
+     * [LowBandwidthDetector] in [LowBandwidthMode.AUTOMATIC]. The low bandwidth mode caps the video
+     * bitrate of the local participant and stops rendering remote video except for the dominant
+     * speaker, if kept, which lets the bandwidth profile switch the other tracks off.
+     *
+     * Called on the main thread only, as are the local tracks this changes the encoding of.
+     */
+    private fun updateLowBandwidthMode() {
+        val mode = LowBandwidthMode.values().find {
+            it.name == settings.value.lowBandwidthMode
+        } ?: LowBandwidthMode.AUTOMATIC
+        val isLowBandwidth = when (mode) {
+            LowBandwidthMode.AUTOMATIC -> lowBandwidthDetector.isLowBandwidth
+            LowBandwidthMode.ON -> true
+            LowBandwidthMode.OFF -> false
+        }
+        if (this.isLowBandwidth == isLowBandwidth) return
+        this.isLowBandwidth = isLowBandwidth
+        Timber.i("Low bandwidth mode %s in %s mode", if (isLowBandwidth) "entered" else "left", mode)
+        localParticipantManager.setLowBandwidth(isLowBandwidth)
+        sendRoomEvent(LowBandwidthModeChanged(isLowBandwidth, settings.value.lowBandwidthKeepDominantSpeaker))
+    }
+
+    /**
+     * Registers a consumer of [StatsUpdate] events. While at least one consumer is subscribed stats
+     * are polled at the foreground rate of the [StatsScheduler].
+     */
+    fun subscribeToStats() {
+        statsSubscriberCount++
+        statsScheduler?.isForeground = true
+    }
+
+    fun unsubscribeFromStats() {
+        if (statsSubscriberCount > 0) statsSubscriberCount--
+        statsScheduler?.isForeground = statsSubscriberCount > 0
+    }
+
     fun sendStatsUpdate(statsReports: List<StatsReport>) {
+        localParticipantManager.onStatsReports(statsReports)
         room?.let { room ->
+            val trackRates = statsHistory.record(statsReports, SystemClock.elapsedRealtime())
+            onLowBandwidthSample { lowBandwidthDetector.onTrackRates(trackRates.values) }
+            if (isSpeakerDetectionEnabled) detectSpeaker(room, statsReports)
+            if (isQualityTelemetryEnabled) callQualityCollector.onStats(statsReports, trackRates)
             val roomStats = RoomStats(
-                    room.remoteParticipants,
-                    localParticipantManager.localVideoTrackNames,
-                    statsReports
+                    getRemoteTrackIdentities(room),
+                    getLocalVideoTrackNames(room),
+                    statsReports,
+                    trackRates
             )
             sendRoomEvent(StatsUpdate(roomStats))
         }
     }
 
+    /*
+     * The stats only keep the identities of the remote tracks by sid, so that a view state holding
+     * them does not keep the participants of a room that was left alive.
+     */
+    private fun getRemoteTrackIdentities(room: Room): Map<String, String> {
+        val identities = HashMap<String, String>()
+        for (remoteParticipant in room.remoteParticipants) {
+            for (publication in remoteParticipant.remoteAudioTracks) {
+                if (publication.remoteAudioTrack != null) {
+                    identities[publication.trackSid] = remoteParticipant.identity
+                }
+            }
+            for (publication in remoteParticipant.remoteVideoTracks) {
+                if (publication.remoteVideoTrack != null) {
+                    identities[publication.trackSid] = remoteParticipant.identity
+                }
+            }
+        }
+        return identities
+    }
+
+    /* The stats report local tracks by sid, the names are kept by track name. */
+    private fun getLocalVideoTrackNames(room: Room): Map<String, String> {
+        val localVideoTrackNames = localParticipantManager.localVideoTrackNames
+        val names = HashMap<String, String>()
+        room.localParticipant?.localVideoTracks?.forEach { publication ->
+            localVideoTrackNames[publication.localVideoTrack.name]?.let { names[publication.trackSid] = it }
+        }
+        return names
+    }
+
+    private fun detectSpeaker(room: Room, statsReports: List<StatsReport>) {
+        val trackAudioLevels = HashMap<String, Int>()
+        for (statsReport in statsReports) {
+            for (audioTrackStats in statsReport.remoteAudioTrackStats) {
+                trackAudioLevels[audioTrackStats.trackSid] = audioTrackStats.audioLevel
+            }
+        }
+        val audioLevels = HashMap<String, Int>()
+        for (remoteParticipant in room.remoteParticipants) {
+            audioLevels[remoteParticipant.sid] = remoteParticipant.remoteAudioTracks
+                    .maxOfOrNull { trackAudioLevels[it.trackSid] ?: 0 } ?: 0
+        }
+        speakerDetector.onAudioLevels(audioLevels)?.let {
+            sendRoomEvent(SpeakerPredicted(it.speakerSid, it.nextSpeakerSid))
+        }
+    }
+
+    /**
+     * Exports the bitrate, packet loss, frame rate trend and jitter of every track of the current
+     * room as CSV, see [StatsHistory.export].
+     */
+    fun exportStats(): String = statsHistory.export()
+
     fun enableLocalAudio() = localParticipantManager.enableLocalAudio()
 
     fun disableLocalAudio() = localParticipantManager.disableLocalAudio()
@@ -139,26 +518,53 @@ class RoomManager(
             Timber.i("onConnected -> room sid: %s",
                     room.sid)
 
+            joinTracer.mark(JoinMilestone.ROOM_CONNECTED)
+            reconnectController.onConnected()
+
             startService(context, room.name)
 
+            subscriptionScheduler.isEnabled = !settings.value.enableAutomaticTrackSubscription
             setupParticipants(room)
 
-            statsScheduler = StatsScheduler(this@RoomManager, room).apply { start() }
+            isSpeakerDetectionEnabled = settings.value.enableSpeakerDetection
+            isQualityTelemetryEnabled = callTelemetry?.isAvailable == true &&
+                    settings.value.enableQualityTelemetry
+            if (isQualityTelemetryEnabled) callQualityCollector.start(SystemClock.elapsedRealtime())
+            statsScheduler = StatsScheduler(this@RoomManager, room).apply {
+                isForeground = statsSubscriberCount > 0
+                isSpeakerDetectionEnabled = this@RoomManager.isSpeakerDetectionEnabled
+                start()
+            }
             this@RoomManager.room = room
+            updateLowBandwidthMode()
         }
 
         override fun onDisconnected(room: Room, twilioException: TwilioException?) {
             Timber.i("Disconnected from room -> sid: %s, state: %s",
                     room.sid, room.state)
-
-            stopService(context)
-
-            sendRoomEvent(Disconnected)
+            if (!isCallRoom(room)) return
 
             localParticipantManager.localParticipant = null
 
             statsScheduler?.stop()
             statsScheduler = null
+            statsHistory.clear()
+            subscriptionScheduler.reset()
+            speakerDetector.reset()
+            // A rejoin registers the participants of the new room, the lost one is gone for good
+            val remoteObjectCount = nativeObjects.releaseAll(REMOTE_NATIVE_OBJECT_KINDS)
+            Timber.i("Dropped %d remote objects of room %s", remoteObjectCount, room.name)
+
+            val rejoinDelayMillis = reconnectController.onDisconnected(twilioException?.code)
+            if (rejoinDelayMillis != null) {
+                Timber.w("Lost room %s with error %d, rejoining in %d ms",
+                        room.name, twilioException?.code, rejoinDelayMillis)
+                this@RoomManager.room = null
+                sendRoomEvent(Reconnecting)
+                rejoin(rejoinDelayMillis)
+            } else {
+                leaveRoom()
+            }
         }
 
         override fun onConnectFailure(room: Room, twilioException: TwilioException) {
@@ -168,8 +574,19 @@ class RoomManager(
                     room.state,
                     twilioException.code,
                     twilioException.message)
+            val isRejoining = reconnectController.isRejoining
+            val rejoinDelayMillis = reconnectController.onConnectFailure(twilioException.code)
+            if (rejoinDelayMillis != null) {
+                this@RoomManager.room = null
+                rejoin(rejoinDelayMillis)
+                return
+            }
+            joinTracer.finish()
 
-            if (twilioException.code == ROOM_MAX_PARTICIPANTS_EXCEEDED_EXCEPTION) {
+            if (isRejoining) {
+                leaveRoom()
+                if (!reconnectController.isDisconnectRequested) sendRoomEvent(ConnectFailure)
+            } else if (twilioException.code == ROOM_MAX_PARTICIPANTS_EXCEEDED_EXCEPTION) {
                 sendRoomEvent(MaxParticipantFailure)
             } else {
                 sendRoomEvent(ConnectFailure)
@@ -179,7 +596,9 @@ class RoomManager(
         override fun onParticipantConnected(room: Room, remoteParticipant: RemoteParticipant) {
             Timber.i("RemoteParticipant connected -> room sid: %s, remoteParticipant: %s",
                     room.sid, remoteParticipant.sid)
+            if (!isCallRoom(room)) return
 
+            nativeObjects.register(NativeObjectKind.REMOTE_PARTICIPANT, remoteParticipant)
             remoteParticipant.setListener(RemoteParticipantListener(this@RoomManager))
             sendRoomEvent(RemoteParticipantConnected(remoteParticipant))
         }
@@ -187,29 +606,46 @@ class RoomManager(
         override fun onParticipantDisconnected(room: Room, remoteParticipant: RemoteParticipant) {
             Timber.i("RemoteParticipant disconnected -> room sid: %s, remoteParticipant: %s",
                     room.sid, remoteParticipant.sid)
+            if (!isCallRoom(room)) return
 
+            nativeObjects.unregister(remoteParticipant)
             sendRoomEvent(RemoteParticipantDisconnected(remoteParticipant.sid))
         }
 
         override fun onDominantSpeakerChanged(room: Room, remoteParticipant: RemoteParticipant?) {
             Timber.i("DominantSpeakerChanged -> room sid: %s, remoteParticipant: %s",
                     room.sid, remoteParticipant?.sid)
+            if (!isCallRoom(room)) return
 
+            speakerDetector.onDominantSpeaker(remoteParticipant?.sid)
             sendRoomEvent(DominantSpeakerChanged(remoteParticipant?.sid))
         }
 
-        override fun onRecordingStarted(room: Room) = sendRoomEvent(RecordingStarted)
+        override fun onRecordingStarted(room: Room) {
+            if (isCallRoom(room)) sendRoomEvent(RecordingStarted)
+        }
 
-        override fun onRecordingStopped(room: Room) = sendRoomEvent(RecordingStopped)
+        override fun onRecordingStopped(room: Room) {
+            if (isCallRoom(room)) sendRoomEvent(RecordingStopped)
+        }
 
         override fun onReconnected(room: Room) {
             Timber.i("onReconnected: %s", room.name)
+            if (isCallRoom(room)) sendRoomEvent(Reconnected)
         }
 
+        /*
+         * The SDK keeps the room, its local tracks and the subscriptions while it reconnects, only
+         * the view is told so that it keeps the layout and shows the reconnecting state.
+         */
         override fun onReconnecting(room: Room, twilioException: TwilioException) {
-            Timber.i("onReconnecting: %s", room.name)
+            Timber.i("onReconnecting: %s, code: %d", room.name, twilioException.code)
+            if (isCallRoom(room)) sendRoomEvent(Reconnecting)
         }
 
+        /* A room the call switched away from may still report events until it is disconnected. */
+        private fun isCallRoom(room: Room) = room === this@RoomManager.room
+
         private fun setupParticipants(room: Room) {
             room.localParticipant?.let { localParticipant ->
                 localParticipantManager.localParticipant = localParticipant
@@ -218,11 +654,14 @@ class RoomManager(
                 localParticipant.setListener(LocalParticipantListener(this@RoomManager))
 
                 room.remoteParticipants.forEach {
+                    nativeObjects.register(NativeObjectKind.REMOTE_PARTICIPANT, it)
                     it.setListener(RemoteParticipantListener(this@RoomManager))
                     participants.add(it)
                 }
 
-                sendRoomEvent(Connected(participants, room, room.name))
+                val switchOffControl = videoClient.connectedSettings?.trackSwitchOffControl
+                sendRoomEvent(Connected(participants, room, room.name, isSwitchingRoom,
+                        switchOffControl?.uppercase() == ClientTrackSwitchOffControl.MANUAL.name))
                 localParticipantManager.publishLocalTracks()
             }
         }
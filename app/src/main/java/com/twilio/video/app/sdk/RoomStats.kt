@@ -1,10 +1,15 @@
 package com.twilio.video.app.sdk
 
-import com.twilio.video.RemoteParticipant
 import com.twilio.video.StatsReport
 
+/**
+ * @param remoteTrackIdentities the identity of the participant of every subscribed remote track by
+ * track sid. Only plain values are kept, as the stats outlive the room in the view state.
+ * @param localVideoTrackNames the display name of every local video track by track sid.
+ */
 data class RoomStats(
-    val remoteParticipants: List<RemoteParticipant>,
+    val remoteTrackIdentities: Map<String, String>,
     val localVideoTrackNames: Map<String, String>,
-    val statsReports: List<StatsReport>? = null
+    val statsReports: List<StatsReport>? = null,
+    val trackRates: Map<String, TrackStatsRates> = emptyMap()
 )
@@ -0,0 +1,43 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.VideoDimensions
+import com.twilio.video.app.data.Preferences
+
+/**
+ * The target format of a screen share track. Screen shares are downscaled to fit
+ * [maxLongEdge] x [maxShortEdge] and sent at most at [maxFrameRate]. A frame is only sent when the
+ * screen content changes, and the last frame is sent again once nothing changed for
+ * [keepAliveMillis] so that late joiners and lost key frames recover, or never if it is 0.
+ */
+data class ScreenShareProfile(
+    val maxLongEdge: Int,
+    val maxShortEdge: Int,
+    val maxFrameRate: Int,
+    val keepAliveMillis: Long
+) {
+
+    /**
+     * Returns the dimensions a screen of [width] x [height] is sent at, which keep its aspect ratio
+     * and are even for the encoder. Screens are never upscaled.
+     */
+    fun targetDimensions(width: Int, height: Int): VideoDimensions {
+        val isLandscape = width >= height
+        val maxWidth = if (isLandscape) maxLongEdge else maxShortEdge
+        val maxHeight = if (isLandscape) maxShortEdge else maxLongEdge
+        val scale = minOf(1.0, maxWidth.toDouble() / width, maxHeight.toDouble() / height)
+        return VideoDimensions((width * scale).toInt() and 1.inv(), (height * scale).toInt() and 1.inv())
+    }
+
+    companion object {
+        /*
+         * Slides and documents are mostly static and need sharp text, so they keep a high
+         * resolution at a low frame rate and rely on the keep-alive between changes.
+         */
+        val TEXT = ScreenShareProfile(1920, 1080, 5, 2_000)
+        val MOTION = ScreenShareProfile(1280, 720, 15, 0)
+
+        /** Returns the profile of a [Preferences.SCREEN_SHARE_CONTENT] value. */
+        fun forContent(content: String?) =
+                if (content == Preferences.SCREEN_SHARE_CONTENT_MOTION) MOTION else TEXT
+    }
+}
@@ -0,0 +1,81 @@
+package com.twilio.video.app.sdk
+
+import android.os.SystemClock
+
+const val SPEAKER_DETECTION_INTERVAL_MILLIS = 500L
+/** The weight of a new audio level sample in the smoothed level of a participant. */
+const val SPEAKER_LEVEL_SMOOTHING = 0.5
+/** The smoothed audio level, out of 32767, a participant has to reach to be considered speaking. */
+const val SPEAKER_MIN_AUDIO_LEVEL = 1000.0
+/** How much louder than the current speaker a participant has to be to take over. */
+const val SPEAKER_SWITCH_RATIO = 1.5
+const val SPEAKER_HOLD_MILLIS = 1500L
+
+/**
+ * @param speakerSid the participant who most likely speaks, rendered in the primary view.
+ * @param nextSpeakerSid the participant who is getting louder than [speakerSid], whose video is
+ * requested at a high layer ahead of a switch.
+ */
+data class SpeakerPrediction(val speakerSid: String?, val nextSpeakerSid: String?)
+
+/**
+ * Predicts the dominant speaker from the audio levels of the stats reports, ahead of the dominant
+ * speaker events of the room which lag a second or two behind. The levels are smoothed, the
+ * speaker only changes to a participant that is [SPEAKER_SWITCH_RATIO] times louder, and a new
+ * speaker is held for at least [holdMillis], so that a cough or a short reply does not flip the
+ * primary view. The dominant speaker reported by the room stays the authority and replaces the
+ * prediction, see [onDominantSpeaker].
+ */
+class SpeakerDetector(
+    private val clock: () -> Long = SystemClock::elapsedRealtime,
+    private val holdMillis: Long = SPEAKER_HOLD_MILLIS
+) {
+
+    private val levels = HashMap<String, Double>()
+    private var prediction = SpeakerPrediction(null, null)
+    private var heldSinceMillis: Long? = null
+
+    /**
+     * Feeds the latest audio level of every remote participant by sid. Returns the new prediction
+     * if it changed, null otherwise.
+     */
+    @Synchronized
+    fun onAudioLevels(audioLevels: Map<String, Int>): SpeakerPrediction? {
+        levels.keys.retainAll(audioLevels.keys)
+        for ((sid, audioLevel) in audioLevels) {
+            val level = levels[sid]
+            levels[sid] = if (level == null) audioLevel.toDouble()
+                    else level + SPEAKER_LEVEL_SMOOTHING * (audioLevel - level)
+        }
+        var speakerSid = prediction.speakerSid?.takeIf { it in levels }
+        val loudest = levels.maxByOrNull { it.value }?.takeIf { it.value >= SPEAKER_MIN_AUDIO_LEVEL }
+        var nextSpeakerSid = loudest?.key?.takeIf { it != speakerSid }
+        if (nextSpeakerSid != null) {
+            val nowMillis = clock()
+            val speakerLevel = speakerSid?.let { levels[it] } ?: 0.0
+            val heldSinceMillis = heldSinceMillis
+            if ((heldSinceMillis == null || nowMillis - heldSinceMillis >= holdMillis) &&
+                    loudest!!.value >= speakerLevel * SPEAKER_SWITCH_RATIO) {
+                speakerSid = nextSpeakerSid
+                nextSpeakerSid = null
+                this.heldSinceMillis = nowMillis
+            }
+        }
+        return SpeakerPrediction(speakerSid, nextSpeakerSid).takeIf { it != prediction }
+                ?.also { prediction = it }
+    }
+
+    /** Adopts the dominant speaker reported by the room and holds it like a predicted one. */
+    @Synchronized
+    fun onDominantSpeaker(sid: String?) {
+        prediction = SpeakerPrediction(sid, null)
+        heldSinceMillis = clock()
+    }
+
+    @Synchronized
+    fun reset() {
+        levels.clear()
+        prediction = SpeakerPrediction(null, null)
+        heldSinceMillis = null
+    }
+}
@@ -0,0 +1,156 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.NetworkQualityLevel
+import com.twilio.video.RemoteAudioTrack
+import com.twilio.video.RemoteAudioTrackPublication
+import com.twilio.video.RemoteDataTrack
+import com.twilio.video.RemoteDataTrackPublication
+import com.twilio.video.RemoteParticipant
+import com.twilio.video.RemoteVideoTrack
+import com.twilio.video.RemoteVideoTrackPublication
+import com.twilio.video.Room
+import com.twilio.video.TwilioException
+import timber.log.Timber
+
+/**
+ * A second room connected next to the room of the call, e.g. a breakout room the user is about to
+ * move to, see [RoomManager.preconnect]. While on standby none of its events reach the view and the
+ * audio of its participants is not played. Once [activate]d it is the room of the call and every
+ * callback goes to [roomListener], the listener of the room can not be replaced after connecting.
+ *
+ * The room is connected off the main thread while its callbacks arrive on the main thread.
+ */
+class StandbyRoom(
+    val roomName: String,
+    private val roomListener: Room.Listener,
+    private val onStandbyConnected: (StandbyRoom) -> Unit,
+    private val onStandbyFailed: (StandbyRoom, TwilioException?) -> Unit
+) : Room.Listener {
+
+    @Volatile
+    var room: Room? = null
+    @Volatile
+    var isConnected = false
+        private set
+    /** Switches to the room as soon as it is connected, see [RoomManager.switchRoom]. */
+    var isSwitchRequested = false
+    private var isActive = false
+    @Volatile
+    private var isDisconnectRequested = false
+
+    /** Plays the audio of the participants and hands the callbacks of the room to [roomListener]. */
+    fun activate() {
+        isActive = true
+        room?.remoteParticipants?.forEach { remoteParticipant ->
+            remoteParticipant.remoteAudioTracks.forEach { it.remoteAudioTrack?.enablePlayback(true) }
+        }
+    }
+
+    fun disconnect() {
+        isDisconnectRequested = true
+        room?.disconnect()
+    }
+
+    override fun onConnected(room: Room) {
+        if (isActive) return roomListener.onConnected(room)
+        this.room = room
+        if (isDisconnectRequested) return room.disconnect()
+        Timber.i("Standby room %s connected", room.name)
+        isConnected = true
+        room.remoteParticipants.forEach { it.setListener(StandbyParticipantListener) }
+        onStandbyConnected(this)
+    }
+
+    override fun onConnectFailure(room: Room, twilioException: TwilioException) {
+        if (isActive) return roomListener.onConnectFailure(room, twilioException)
+        onStandbyFailed(this, twilioException)
+    }
+
+    override fun onDisconnected(room: Room, twilioException: TwilioException?) {
+        if (isActive) return roomListener.onDisconnected(room, twilioException)
+        isConnected = false
+        if (!isDisconnectRequested) onStandbyFailed(this, twilioException)
+    }
+
+    override fun onParticipantConnected(room: Room, remoteParticipant: RemoteParticipant) {
+        if (isActive) return roomListener.onParticipantConnected(room, remoteParticipant)
+        remoteParticipant.setListener(StandbyParticipantListener)
+    }
+
+    override fun onParticipantDisconnected(room: Room, remoteParticipant: RemoteParticipant) {
+        if (isActive) roomListener.onParticipantDisconnected(room, remoteParticipant)
+    }
+
+    override fun onDominantSpeakerChanged(room: Room, remoteParticipant: RemoteParticipant?) {
+        if (isActive) roomListener.onDominantSpeakerChanged(room, remoteParticipant)
+    }
+
+    override fun onRecordingStarted(room: Room) {
+        if (isActive) roomListener.onRecordingStarted(room)
+    }
+
+    override fun onRecordingStopped(room: Room) {
+        if (isActive) roomListener.onRecordingStopped(room)
+    }
+
+    override fun onReconnected(room: Room) {
+        if (isActive) roomListener.onReconnected(room)
+    }
+
+    override fun onReconnecting(room: Room, twilioException: TwilioException) {
+        if (isActive) roomListener.onReconnecting(room, twilioException)
+    }
+}
+
+/*
+ * Keeps the audio of a standby room silent, the participants get a [RemoteParticipantListener]
+ * once the room is activated.
+ */
+private object StandbyParticipantListener : RemoteParticipant.Listener {
+
+    override fun onAudioTrackSubscribed(remoteParticipant: RemoteParticipant, remoteAudioTrackPublication: RemoteAudioTrackPublication, remoteAudioTrack: RemoteAudioTrack) {
+        remoteAudioTrack.enablePlayback(false)
+    }
+
+    override fun onVideoTrackSwitchedOff(remoteParticipant: RemoteParticipant, remoteVideoTrack: RemoteVideoTrack) {}
+
+    override fun onVideoTrackSwitchedOn(remoteParticipant: RemoteParticipant, remoteVideoTrack: RemoteVideoTrack) {}
+
+    override fun onVideoTrackSubscribed(remoteParticipant: RemoteParticipant, remoteVideoTrackPublication: RemoteVideoTrackPublication, remoteVideoTrack: RemoteVideoTrack) {}
+
+    override fun onVideoTrackUnsubscribed(remoteParticipant: RemoteParticipant, remoteVideoTrackPublication: RemoteVideoTrackPublication, remoteVideoTrack: RemoteVideoTrack) {}
+
+    override fun onNetworkQualityLevelChanged(remoteParticipant: RemoteParticipant, networkQualityLevel: NetworkQualityLevel) {}
+
+    override fun onAudioTrackUnsubscribed(remoteParticipant: RemoteParticipant, remoteAudioTrackPublication: RemoteAudioTrackPublication, remoteAudioTrack: RemoteAudioTrack) {}
+
+    override fun onAudioTrackPublished(remoteParticipant: RemoteParticipant, remoteAudioTrackPublication: RemoteAudioTrackPublication) {}
+
+    override fun onAudioTrackUnpublished(remoteParticipant: RemoteParticipant, remoteAudioTrackPublication: RemoteAudioTrackPublication) {}
+
+    override fun onAudioTrackEnabled(remoteParticipant: RemoteParticipant, remoteAudioTrackPublication: RemoteAudioTrackPublication) {}
+
+    override fun onAudioTrackDisabled(remoteParticipant: RemoteParticipant, remoteAudioTrackPublication: RemoteAudioTrackPublication) {}
+
+    override fun onDataTrackPublished(remoteParticipant: RemoteParticipant, remoteDataTrackPublication: RemoteDataTrackPublication) {}
+
+    override fun onVideoTrackPublished(remoteParticipant: RemoteParticipant, remoteVideoTrackPublication: RemoteVideoTrackPublication) {}
+
+    override fun onVideoTrackEnabled(remoteParticipant: RemoteParticipant, remoteVideoTrackPublication: RemoteVideoTrackPublication) {}
+
+    override fun onVideoTrackDisabled(remoteParticipant: RemoteParticipant, remoteVideoTrackPublication: RemoteVideoTrackPublication) {}
+
+    override fun onDataTrackSubscriptionFailed(remoteParticipant: RemoteParticipant, remoteDataTrackPublication: RemoteDataTrackPublication, twilioException: TwilioException) {}
+
+    override fun onDataTrackSubscribed(remoteParticipant: RemoteParticipant, remoteDataTrackPublication: RemoteDataTrackPublication, remoteDataTrack: RemoteDataTrack) {}
+
+    override fun onVideoTrackSubscriptionFailed(remoteParticipant: RemoteParticipant, remoteVideoTrackPublication: RemoteVideoTrackPublication, twilioException: TwilioException) {}
+
+    override fun onAudioTrackSubscriptionFailed(remoteParticipant: RemoteParticipant, remoteAudioTrackPublication: RemoteAudioTrackPublication, twilioException: TwilioException) {}
+
+    override fun onVideoTrackUnpublished(remoteParticipant: RemoteParticipant, remoteVideoTrackPublication: RemoteVideoTrackPublication) {}
+
+    override fun onDataTrackUnsubscribed(remoteParticipant: RemoteParticipant, remoteDataTrackPublication: RemoteDataTrackPublication, remoteDataTrack: RemoteDataTrack) {}
+
+    override fun onDataTrackUnpublished(remoteParticipant: RemoteParticipant, remoteDataTrackPublication: RemoteDataTrackPublication) {}
+}
@@ -0,0 +1,99 @@
+package com.twilio.video.app.sdk
+
+import androidx.annotation.VisibleForTesting
+import com.twilio.video.StatsReport
+import java.util.Locale
+
+/**
+ * Keeps a [TrackStatsRingBuffer] per track sid fed with the reports of the [StatsScheduler].
+ * Tracks missing from a report are dropped along with their history.
+ */
+class StatsHistory(
+    private val capacity: Int = TRACK_STATS_CAPACITY,
+    private val windowMillis: Long = TRACK_STATS_WINDOW_MILLIS
+) {
+    private val buffers = HashMap<String, TrackStatsRingBuffer>()
+    private val recordedSids = HashSet<String>()
+
+    /**
+     * Records the tracks of the reports and returns the rates of every track that has enough
+     * samples, keyed by track sid.
+     */
+    @Synchronized
+    fun record(statsReports: List<StatsReport>, timestampMillis: Long): Map<String, TrackStatsRates> {
+        recordedSids.clear()
+        for (report in statsReports) {
+            for (stats in report.localAudioTrackStats) {
+                recordTrack(stats.trackSid, isLocal = true, timestampMillis, stats.bytesSent,
+                        stats.packetsSent.toLong(), stats.packetsLost.toLong(), jitter = stats.jitter)
+            }
+            for (stats in report.localVideoTrackStats) {
+                recordTrack(stats.trackSid, isLocal = true, timestampMillis, stats.bytesSent,
+                        stats.packetsSent.toLong(), stats.packetsLost.toLong(), frameRate = stats.frameRate)
+            }
+            for (stats in report.remoteAudioTrackStats) {
+                recordTrack(stats.trackSid, isLocal = false, timestampMillis, stats.bytesReceived,
+                        stats.packetsReceived.toLong(), stats.packetsLost.toLong(), jitter = stats.jitter)
+            }
+            for (stats in report.remoteVideoTrackStats) {
+                recordTrack(stats.trackSid, isLocal = false, timestampMillis, stats.bytesReceived,
+                        stats.packetsReceived.toLong(), stats.packetsLost.toLong(),
+                        frameRate = stats.frameRate)
+            }
+        }
+        buffers.keys.retainAll(recordedSids)
+        return rates()
+    }
+
+    @Synchronized
+    fun rates(): Map<String, TrackStatsRates> {
+        val rates = HashMap<String, TrackStatsRates>(buffers.size)
+        buffers.forEach { (trackSid, buffer) -> buffer.rates(windowMillis)?.let { rates[trackSid] = it } }
+        return rates
+    }
+
+    /**
+     * Exports the current rates of every track as CSV, one line per track after a header line.
+     */
+    @Synchronized
+    fun export(): String = buildString {
+        append(EXPORT_HEADER)
+        buffers.toSortedMap().forEach { (trackSid, buffer) ->
+            val rates = buffer.rates(windowMillis) ?: return@forEach
+            append('\n')
+            append(String.format(Locale.US, "%s,%d,%d,%.2f,%d,%d",
+                    trackSid,
+                    buffer.size,
+                    rates.bitrateKbps,
+                    rates.packetLossPercent,
+                    rates.frameRateTrend,
+                    rates.jitterP95))
+        }
+    }
+
+    @Synchronized
+    fun clear() {
+        buffers.clear()
+    }
+
+    @VisibleForTesting
+    internal fun recordTrack(
+        trackSid: String,
+        isLocal: Boolean,
+        timestampMillis: Long,
+        bytes: Long,
+        packets: Long,
+        packetsLost: Long,
+        frameRate: Int = 0,
+        jitter: Int = 0
+    ) {
+        recordedSids.add(trackSid)
+        buffers.getOrPut(trackSid) { TrackStatsRingBuffer(capacity, isLocal) }
+                .add(timestampMillis, bytes, packets, packetsLost, frameRate, jitter)
+    }
+
+    companion object {
+        const val EXPORT_HEADER =
+                "track_sid,samples,bitrate_kbps,packet_loss_percent,frame_rate_trend,jitter_p95"
+    }
+}
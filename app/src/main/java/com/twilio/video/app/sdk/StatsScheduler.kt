@@ -21,42 +21,93 @@ import com.twilio.video.Room
 import com.twilio.video.StatsListener
 import timber.log.Timber
 
-class StatsScheduler(private val roomManager: RoomManager, private val room: Room) {
-    private var handlerThread: HandlerThread? = null
-    private var handler: Handler? = null
+const val STATS_FOREGROUND_INTERVAL_MILLIS = 1000L
+const val STATS_BACKGROUND_INTERVAL_MILLIS = 10_000L
+
+/**
+ * Periodically requests the stats of a [Room].
+ *
+ * Stats are polled every [foregroundIntervalMillis] while [isForeground] is set, e.g. while the
+ * stats are displayed, and every [backgroundIntervalMillis] otherwise. A background interval of
+ * zero or less stops polling until the scheduler returns to the foreground. While
+ * [isSpeakerDetectionEnabled] stats are polled at least every [SPEAKER_DETECTION_INTERVAL_MILLIS]
+ * for the audio levels the [SpeakerDetector] needs. All schedulers share a single stats thread
+ * instead of starting a thread per room.
+ */
+class StatsScheduler(
+    private val roomManager: RoomManager,
+    private val room: Room,
+    private val foregroundIntervalMillis: Long = STATS_FOREGROUND_INTERVAL_MILLIS,
+    private val backgroundIntervalMillis: Long = STATS_BACKGROUND_INTERVAL_MILLIS,
+    private val handler: Handler = sharedHandler
+) {
     private val statsListener: StatsListener = StatsListener { statsReports ->
         roomManager.sendStatsUpdate(statsReports)
     }
-    private val isRunning: Boolean
-        get() = handlerThread?.isAlive ?: false
+    @Volatile
+    private var isRunning = false
+    @Volatile
+    var isForeground = false
+        set(value) {
+            if (field == value) return
+            field = value
+            if (isRunning) handler.post { reschedule(pollNow = value) }
+        }
+    /** Only read when the scheduler starts. */
+    var isSpeakerDetectionEnabled = false
+    private val intervalMillis: Long
+        get() {
+            val intervalMillis = if (isForeground) foregroundIntervalMillis else backgroundIntervalMillis
+            return if (isSpeakerDetectionEnabled && (intervalMillis <= 0 ||
+                            intervalMillis > SPEAKER_DETECTION_INTERVAL_MILLIS)) {
+                SPEAKER_DETECTION_INTERVAL_MILLIS
+            } else intervalMillis
+        }
+    private val statsRunner: Runnable = object : Runnable {
+        override fun run() {
+            if (!isRunning) return
+            room.getStats(statsListener)
+            val intervalMillis = intervalMillis
+            if (intervalMillis > 0) handler.postDelayed(this, intervalMillis)
+        }
+    }
 
     fun start() {
         if (isRunning) {
             stop()
         }
-        val handlerThread = HandlerThread("StatsSchedulerThread")
-        this.handlerThread = handlerThread
-        handlerThread.start()
-        val handler = Handler(handlerThread.looper)
-        this.handler = handler
-        val statsRunner: Runnable = object : Runnable {
-            override fun run() {
-                room.getStats(statsListener)
-                handler.postDelayed(this, 1000)
-            }
-        }
-        handler.post(statsRunner)
-        Timber.d("Stats scheduler thread started")
+        isRunning = true
+        handler.post { reschedule(pollNow = true) }
+        Timber.d("Stats scheduler started")
     }
 
     fun stop() {
         if (isRunning) {
-            handlerThread?.let { handlerThread ->
-                handlerThread.quit()
-                this.handlerThread = null
-                handler = null
-                Timber.d("Stats scheduler thread closed")
-            }
+            isRunning = false
+            handler.post { handler.removeCallbacks(statsRunner) }
+            Timber.d("Stats scheduler stopped")
+        }
+    }
+
+    /*
+     * Only invoked on the stats thread so that the runner is never posted twice.
+     */
+    private fun reschedule(pollNow: Boolean) {
+        handler.removeCallbacks(statsRunner)
+        if (!isRunning) return
+        val intervalMillis = intervalMillis
+        Timber.d("Polling stats every %d ms", intervalMillis)
+        when {
+            pollNow -> handler.post(statsRunner)
+            intervalMillis > 0 -> handler.postDelayed(statsRunner, intervalMillis)
+        }
+    }
+
+    companion object {
+        private val sharedHandler: Handler by lazy {
+            val handlerThread = HandlerThread("StatsSchedulerThread")
+            handlerThread.start()
+            Handler(handlerThread.looper)
         }
     }
 }
@@ -0,0 +1,125 @@
+package com.twilio.video.app.sdk
+
+import java.util.Arrays
+import kotlin.math.ceil
+
+const val TRACK_STATS_CAPACITY = 60
+const val TRACK_STATS_WINDOW_MILLIS = 10_000L
+
+/**
+ * Rates of a track derived from the samples of a sliding window.
+ *
+ * @param bitrateKbps the bitrate sent or received over the window.
+ * @param packetLossPercent the share of packets lost over the window.
+ * @param frameRateTrend the frame rate of the newest sample minus the frame rate of the oldest one.
+ * @param jitterP95 the 95th percentile of the jitter samples of the window.
+ * @param isLocal whether the track is sent rather than received.
+ */
+data class TrackStatsRates(
+    val bitrateKbps: Long,
+    val packetLossPercent: Double,
+    val frameRateTrend: Int,
+    val jitterP95: Int,
+    val isLocal: Boolean = false
+)
+
+/**
+ * Fixed capacity history of the cumulative stats of a single track. Samples are stored in
+ * preallocated primitive arrays so recording a sample never allocates, the oldest sample is
+ * overwritten once the buffer is full.
+ *
+ * The packets of a remote track are the ones received, so the loss is the share of the lost ones in
+ * the received and lost packets. The packets of an [isLocal] track are the ones sent, which already
+ * include the ones the receivers reported lost.
+ *
+ * Not thread safe, see [StatsHistory].
+ */
+class TrackStatsRingBuffer(
+    val capacity: Int = TRACK_STATS_CAPACITY,
+    val isLocal: Boolean = false
+) {
+
+    private val timestamps = LongArray(capacity)
+    private val bytes = LongArray(capacity)
+    private val packets = LongArray(capacity)
+    private val packetsLost = LongArray(capacity)
+    private val frameRates = IntArray(capacity)
+    private val jitters = IntArray(capacity)
+    private val jitterScratch = IntArray(capacity)
+    private var head = 0
+
+    var size = 0
+        private set
+
+    init {
+        require(capacity >= 2) { "A track stats ring buffer needs room for at least two samples" }
+    }
+
+    /**
+     * Records the cumulative counters of a stats report. The history is cleared first when a
+     * counter went backwards, e.g. because the track was republished under the same sid.
+     */
+    fun add(
+        timestampMillis: Long,
+        bytes: Long,
+        packets: Long,
+        packetsLost: Long,
+        frameRate: Int = 0,
+        jitter: Int = 0
+    ) {
+        if (size > 0) {
+            val newest = indexOf(size - 1)
+            if (bytes < this.bytes[newest] || packets < this.packets[newest] ||
+                    packetsLost < this.packetsLost[newest]) clear()
+        }
+        timestamps[head] = timestampMillis
+        this.bytes[head] = bytes
+        this.packets[head] = packets
+        this.packetsLost[head] = packetsLost
+        frameRates[head] = frameRate
+        jitters[head] = jitter
+        head = (head + 1) % capacity
+        if (size < capacity) size++
+    }
+
+    /**
+     * @return the rates over the samples recorded within [windowMillis] of the newest sample, or
+     * null if the window does not span at least two samples.
+     */
+    fun rates(windowMillis: Long = TRACK_STATS_WINDOW_MILLIS): TrackStatsRates? {
+        if (size < 2) return null
+        val newest = indexOf(size - 1)
+        var oldestPosition = size - 1
+        while (oldestPosition > 0 &&
+                timestamps[newest] - timestamps[indexOf(oldestPosition - 1)] <= windowMillis) {
+            oldestPosition--
+        }
+        val oldest = indexOf(oldestPosition)
+        val elapsedMillis = timestamps[newest] - timestamps[oldest]
+        if (oldest == newest || elapsedMillis <= 0) return null
+
+        val bitrateKbps = (bytes[newest] - bytes[oldest]) * 8 / elapsedMillis
+        val lostDelta = packetsLost[newest] - packetsLost[oldest]
+        val packetsDelta = packets[newest] - packets[oldest]
+        val totalDelta = if (isLocal) packetsDelta else packetsDelta + lostDelta
+        val packetLossPercent = if (totalDelta > 0) lostDelta * 100.0 / totalDelta else 0.0
+        val frameRateTrend = frameRates[newest] - frameRates[oldest]
+
+        val sampleCount = size - oldestPosition
+        for (position in 0 until sampleCount) {
+            jitterScratch[position] = jitters[indexOf(oldestPosition + position)]
+        }
+        Arrays.sort(jitterScratch, 0, sampleCount)
+        val jitterP95 = jitterScratch[ceil(sampleCount * 0.95).toInt() - 1]
+
+        return TrackStatsRates(bitrateKbps, packetLossPercent, frameRateTrend, jitterP95, isLocal)
+    }
+
+    fun clear() {
+        head = 0
+        size = 0
+    }
+
+    /* Maps a position counted from the oldest sample to an index of the arrays. */
+    private fun indexOf(position: Int) = (head - size + position + capacity) % capacity
+}
@@ -0,0 +1,121 @@
+package com.twilio.video.app.sdk
+
+import android.os.Handler
+import android.os.Looper
+import com.twilio.video.RemoteVideoTrack
+import com.twilio.video.app.ui.room.RoomEvent
+import java.util.concurrent.atomic.AtomicBoolean
+import tvi.webrtc.VideoFrame
+import tvi.webrtc.VideoSink
+
+const val MAX_IN_FLIGHT_VIDEO_TRACKS = 4
+const val VIDEO_TRACK_SLOT_TIMEOUT_MILLIS = 1000L
+
+/**
+ * Hands the video tracks subscribed by the subscribe rules of a room to the view in the order they
+ * are needed, so that joining a large room does not rebind every participant at once. The video of
+ * the primary participant, i.e. the pinned participant or the dominant speaker, goes first, then the
+ * thumbnails in the order they are laid out, so visible thumbnails come before the ones scrolled
+ * away. Audio is never held back, [RemoteParticipantListener] reports it directly.
+ *
+ * At most [maxInFlight] tracks are waiting for their first frame at a time. A track leaves its slot
+ * with the first frame, when it is unsubscribed or after [VIDEO_TRACK_SLOT_TIMEOUT_MILLIS], as a
+ * track switched off by the bandwidth profile does not receive frames. Tracks unsubscribed while
+ * still queued are dropped without ever reaching the view.
+ *
+ * Automatic subscription subscribes every track while connecting, the scheduler is only
+ * [isEnabled] without it, otherwise every track is delivered as it arrives. Must only be used on the
+ * main thread, which the SDK invokes the listeners of a room on.
+ */
+class TrackSubscriptionScheduler(
+    private val deliver: (RoomEvent) -> Unit,
+    private val maxInFlight: Int = MAX_IN_FLIGHT_VIDEO_TRACKS,
+    private val awaitFirstFrame: (videoTrack: RemoteVideoTrack, onSlotReleased: () -> Unit) -> Unit =
+            { videoTrack, onSlotReleased -> awaitFirstFrameOrTimeout(videoTrack, onSlotReleased) }
+) {
+
+    private class PendingTrack(val sid: String, val videoTrack: RemoteVideoTrack, val event: RoomEvent)
+
+    private val pendingTracks = ArrayList<PendingTrack>()
+    private val inFlightTracks = HashSet<RemoteVideoTrack>()
+    private var primarySid: String? = null
+    private var thumbnailSids: List<String?> = emptyList()
+
+    var isEnabled = false
+        set(value) {
+            if (field == value) return
+            field = value
+            if (!value) reset()
+        }
+
+    /** Ranks the queued tracks, called with the layout of every participant view state update. */
+    fun updatePriorities(primarySid: String?, thumbnailSids: List<String?>) {
+        this.primarySid = primarySid
+        this.thumbnailSids = thumbnailSids
+    }
+
+    fun onVideoTrackSubscribed(sid: String, videoTrack: RemoteVideoTrack, event: RoomEvent) {
+        if (!isEnabled) return deliver(event)
+        pendingTracks.add(PendingTrack(sid, videoTrack, event))
+        releaseTracks()
+    }
+
+    fun onVideoTrackUnsubscribed(videoTrack: RemoteVideoTrack, event: RoomEvent) {
+        if (pendingTracks.removeAll { it.videoTrack == videoTrack }) return
+        deliver(event)
+        if (inFlightTracks.remove(videoTrack)) releaseTracks()
+    }
+
+    /** Drops the queue of a room that was left. */
+    fun reset() {
+        pendingTracks.clear()
+        inFlightTracks.clear()
+    }
+
+    private fun releaseTracks() {
+        while (inFlightTracks.size < maxInFlight && pendingTracks.isNotEmpty()) {
+            val next = pendingTracks.minByOrNull { rank(it.sid) }!!
+            pendingTracks.remove(next)
+            inFlightTracks.add(next.videoTrack)
+            deliver(next.event)
+            awaitFirstFrame(next.videoTrack) {
+                if (inFlightTracks.remove(next.videoTrack)) releaseTracks()
+            }
+        }
+    }
+
+    private fun rank(sid: String): Int {
+        if (sid == primarySid) return 0
+        val index = thumbnailSids.indexOf(sid)
+        return if (index >= 0) index + 1 else Int.MAX_VALUE
+    }
+}
+
+private val mainHandler by lazy { Handler(Looper.getMainLooper()) }
+
+/**
+ * Calls [onSlotReleased] on the thread of [handler] once [videoTrack] rendered its first frame or
+ * after [VIDEO_TRACK_SLOT_TIMEOUT_MILLIS], whichever comes first.
+ */
+internal fun awaitFirstFrameOrTimeout(
+    videoTrack: RemoteVideoTrack,
+    onSlotReleased: () -> Unit,
+    handler: Handler = mainHandler
+) {
+    val hasFrame = AtomicBoolean()
+    var isReleased = false
+    lateinit var sink: VideoSink
+    val release = Runnable {
+        if (isReleased) return@Runnable
+        isReleased = true
+        videoTrack.removeSink(sink)
+        onSlotReleased()
+    }
+    sink = object : VideoSink {
+        override fun onFrame(frame: VideoFrame) {
+            if (hasFrame.compareAndSet(false, true)) handler.post(release)
+        }
+    }
+    videoTrack.addSink(sink)
+    handler.postDelayed(release, VIDEO_TRACK_SLOT_TIMEOUT_MILLIS)
+}
@@ -1,23 +1,76 @@
 package com.twilio.video.app.sdk
 
 import android.content.Context
+import com.twilio.video.ConnectOptions
 import com.twilio.video.Room
 import com.twilio.video.Video
+import com.twilio.video.app.data.Settings
 
 class VideoClient(
     private val context: Context,
-    private val connectOptionsFactory: ConnectOptionsFactory
+    private val connectOptionsFactory: ConnectOptionsFactory,
+    private val joinTracer: JoinTracer
 ) {
 
+    private var lastConnectOptions: ConnectOptions? = null
+    private val standbyConnectOptions = HashMap<String, ConnectOptions>()
+    private val standbySettings = HashMap<String, Settings>()
+
+    /**
+     * The settings the [ConnectOptions] of the room of the call were built from, which a change of
+     * the settings during the call does not alter.
+     */
+    @Volatile
+    var connectedSettings: Settings? = null
+        private set
+
     suspend fun connect(
         identity: String,
         roomName: String,
         roomListener: Room.Listener
     ): Room {
 
+            joinTracer.mark(JoinMilestone.CONNECT_OPTIONS_REQUESTED)
+            val settings = connectOptionsFactory.settings.value
+            val connectOptions = connectOptionsFactory.newInstance(identity, roomName, settings)
+            joinTracer.mark(JoinMilestone.CONNECT_OPTIONS_CREATED)
+            lastConnectOptions = connectOptions
+            connectedSettings = settings
             return Video.connect(
                     context,
-                    connectOptionsFactory.newInstance(identity, roomName),
+                    connectOptions,
                     roomListener)
     }
+
+    /**
+     * Connects again with the [ConnectOptions] of the last [connect], including its token, so that
+     * a room is rejoined without waiting for the token service. Returns null without a previous
+     * [connect].
+     */
+    fun rejoin(roomListener: Room.Listener): Room? =
+            lastConnectOptions?.let { Video.connect(context, it, roomListener) }
+
+    /**
+     * Connects a [StandbyRoom] next to the room of the call. Its [ConnectOptions] only replace
+     * those [rejoin] reuses once the call switches to it, see [onRoomSwitched].
+     */
+    suspend fun preconnect(identity: String, roomName: String, roomListener: Room.Listener): Room {
+        val settings = connectOptionsFactory.settings.value
+        val connectOptions = connectOptionsFactory.newInstance(identity, roomName, settings)
+        synchronized(standbyConnectOptions) {
+            standbyConnectOptions[roomName] = connectOptions
+            standbySettings[roomName] = settings
+        }
+        return Video.connect(context, connectOptions, roomListener)
+    }
+
+    fun onRoomSwitched(roomName: String) = synchronized(standbyConnectOptions) {
+        standbyConnectOptions[roomName]?.let { lastConnectOptions = it }
+        standbySettings[roomName]?.let { connectedSettings = it }
+        standbyConnectOptions.clear()
+        standbySettings.clear()
+    }
+
+    suspend fun prefetchToken(identity: String, roomName: String) =
+            connectOptionsFactory.prefetchToken(identity, roomName)
 }
@@ -2,26 +2,48 @@ package com.twilio.video.app.sdk
 
 import android.app.Application
 import android.content.SharedPreferences
+import com.twilio.video.app.data.SettingsStore
 import com.twilio.video.app.data.api.TokenService
+import com.twilio.video.app.telemetry.CallTelemetry
 import dagger.Module
 import dagger.Provides
 import dagger.hilt.InstallIn
 import dagger.hilt.components.SingletonComponent
+import javax.inject.Provider
 import javax.inject.Singleton
 
 @Module
 @InstallIn(SingletonComponent::class)
 class VideoSdkModule {
 
+    @Provides
+    @Singleton
+    fun providesNativeObjectRegistry() = NativeObjectRegistry()
+
+    @Provides
+    @Singleton
+    fun providesCaptureProfileStore(application: Application, sharedPreferences: SharedPreferences) =
+            CaptureProfileStore(application, sharedPreferences)
+
     @Provides
     @Singleton
     fun providesRoomManager(
         application: Application,
         sharedPreferences: SharedPreferences,
-        tokenService: TokenService
+        settingsStore: SettingsStore,
+        tokenService: Provider<TokenService>,
+        nativeObjects: NativeObjectRegistry,
+        captureProfileStore: CaptureProfileStore
     ): RoomManager {
-        val connectOptionsFactory = ConnectOptionsFactory(application, sharedPreferences, tokenService)
-        val videoClient = VideoClient(application, connectOptionsFactory)
-        return RoomManager(application, videoClient, sharedPreferences)
+        val joinTracer = JoinTracer()
+        val videoClient = lazy {
+            val connectOptionsFactory = ConnectOptionsFactory(application, sharedPreferences,
+                    tokenService.get(), settingsStore.settings, captureProfileStore)
+            VideoClient(application, connectOptionsFactory, joinTracer)
+        }
+        return RoomManager(application, videoClient, joinTracer = joinTracer,
+                settings = settingsStore.settings, captureProfileStore = captureProfileStore,
+                nativeObjects = nativeObjects,
+                callTelemetry = CallTelemetry(application))
     }
 }
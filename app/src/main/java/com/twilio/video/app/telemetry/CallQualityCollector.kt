@@ -0,0 +1,172 @@
+package com.twilio.video.app.telemetry
+
+import com.twilio.video.StatsReport
+import com.twilio.video.app.sdk.TrackStatsRates
+import com.twilio.video.app.sdk.packetLoss
+
+private val BITRATE_KBPS_BOUNDS = intArrayOf(50, 100, 200, 300, 500, 750, 1000, 1500, 2000, 3000, 5000)
+private val PACKET_LOSS_PERMILLE_BOUNDS = intArrayOf(0, 5, 10, 20, 30, 50, 100, 200, 500)
+private val ROUND_TRIP_TIME_MILLIS_BOUNDS = intArrayOf(25, 50, 100, 150, 200, 300, 500, 1000)
+private val FRAME_RATE_BOUNDS = intArrayOf(0, 1, 5, 10, 15, 20, 24, 30)
+
+/**
+ * Summarizes the quality of a call from the reports of the [com.twilio.video.app.sdk.StatsScheduler]
+ * into [QualityHistogram]s, so that collecting costs a few counter increments per stats poll and no
+ * sample is kept. A call starts with the first [start] and spans every rejoin until [finish].
+ *
+ * A remote video track whose frame rate drops to zero while it is not switched off counts as a
+ * freeze, the time tracks spend switched off by the bandwidth profile is reported separately.
+ * Freezes seen by the renderers of the views are counted apart from those of the stats, see
+ * [onRenderFreeze].
+ */
+class CallQualityCollector {
+
+    private val sendBitrates = QualityHistogram(BITRATE_KBPS_BOUNDS)
+    private val receiveBitrates = QualityHistogram(BITRATE_KBPS_BOUNDS)
+    private val sendPacketLosses = QualityHistogram(PACKET_LOSS_PERMILLE_BOUNDS)
+    private val receivePacketLosses = QualityHistogram(PACKET_LOSS_PERMILLE_BOUNDS)
+    private val roundTripTimes = QualityHistogram(ROUND_TRIP_TIME_MILLIS_BOUNDS)
+    private val frameRates = QualityHistogram(FRAME_RATE_BOUNDS)
+    private val lastFrameRates = HashMap<String, Int>()
+    private val remoteFrameRates = HashMap<String, Int>()
+    private val switchedOffSinceMillis = HashMap<String, Long>()
+    private var startMillis: Long? = null
+    private var freezeCount = 0
+    private var renderFreezeCount = 0
+    private var switchOffMillis = 0L
+
+    val isStarted: Boolean
+        @Synchronized get() = startMillis != null
+
+    /** Starts a call unless one is already started, e.g. when a lost room is rejoined. */
+    @Synchronized
+    fun start(nowMillis: Long) {
+        if (startMillis == null) startMillis = nowMillis
+    }
+
+    /** Records a stats poll, [trackRates] are the rates of the tracks by sid, see StatsHistory. */
+    @Synchronized
+    fun onStats(statsReports: List<StatsReport>, trackRates: Map<String, TrackStatsRates>) {
+        if (startMillis == null) return
+        var sendBitrateKbps = 0L
+        var receiveBitrateKbps = 0L
+        var roundTripTimeMillis = 0L
+        remoteFrameRates.clear()
+        for (statsReport in statsReports) {
+            for (stats in statsReport.localAudioTrackStats) {
+                sendBitrateKbps += trackRates[stats.trackSid]?.bitrateKbps ?: 0
+                roundTripTimeMillis = maxOf(roundTripTimeMillis, stats.roundTripTime)
+            }
+            for (stats in statsReport.localVideoTrackStats) {
+                sendBitrateKbps += trackRates[stats.trackSid]?.bitrateKbps ?: 0
+                roundTripTimeMillis = maxOf(roundTripTimeMillis, stats.roundTripTime)
+            }
+            for (stats in statsReport.remoteAudioTrackStats) {
+                receiveBitrateKbps += trackRates[stats.trackSid]?.bitrateKbps ?: 0
+            }
+            for (stats in statsReport.remoteVideoTrackStats) {
+                receiveBitrateKbps += trackRates[stats.trackSid]?.bitrateKbps ?: 0
+                remoteFrameRates[stats.trackSid] = stats.frameRate
+            }
+        }
+        val packetLoss = packetLoss(trackRates.values)
+        record(sendBitrateKbps.toInt(), receiveBitrateKbps.toInt(), (packetLoss.sendPercent * 10).toInt(),
+                (packetLoss.receivePercent * 10).toInt(), roundTripTimeMillis.toInt(), remoteFrameRates)
+    }
+
+    /**
+     * Records a single sample, the rates summed over every local and every remote track. The loss
+     * is the one of a [com.twilio.video.app.sdk.PacketLoss], so a single lossy remote track does
+     * not pass for a lossy call. [frameRates] holds the frame rate of every remote video track by sid.
+     */
+    @Synchronized
+    fun record(
+        sendBitrateKbps: Int,
+        receiveBitrateKbps: Int,
+        sendPacketLossPermille: Int,
+        receivePacketLossPermille: Int,
+        roundTripTimeMillis: Int,
+        frameRates: Map<String, Int>
+    ) {
+        if (startMillis == null) return
+        sendBitrates.add(sendBitrateKbps)
+        receiveBitrates.add(receiveBitrateKbps)
+        sendPacketLosses.add(sendPacketLossPermille)
+        receivePacketLosses.add(receivePacketLossPermille)
+        if (roundTripTimeMillis > 0) roundTripTimes.add(roundTripTimeMillis)
+        for ((trackSid, frameRate) in frameRates) {
+            if (trackSid in switchedOffSinceMillis) continue
+            this.frameRates.add(frameRate)
+            if (frameRate == 0 && (lastFrameRates[trackSid] ?: 0) > 0) freezeCount++
+        }
+        lastFrameRates.keys.retainAll(frameRates.keys)
+        lastFrameRates.putAll(frameRates)
+    }
+
+    @Synchronized
+    fun onTrackSwitchOff(trackSid: String, isSwitchedOff: Boolean, nowMillis: Long) {
+        if (startMillis == null) return
+        if (isSwitchedOff) {
+            switchedOffSinceMillis.getOrPut(trackSid) { nowMillis }
+        } else {
+            switchedOffSinceMillis.remove(trackSid)?.let { switchOffMillis += nowMillis - it }
+            // A track switched on is not frozen before it received its first frames again
+            lastFrameRates.remove(trackSid)
+        }
+    }
+
+    /** Counts a rendered remote video track that stopped delivering frames. */
+    @Synchronized
+    fun onRenderFreeze() {
+        if (startMillis != null) renderFreezeCount++
+    }
+
+    /**
+     * Ends the call and returns its summary, or null if no call is started or no stats were
+     * recorded. [joinMillis] is the time to the first remote frame of the call or -1.
+     */
+    @Synchronized
+    fun finish(nowMillis: Long, joinMillis: Long): CallQualitySummary? {
+        val startMillis = startMillis ?: return null
+        switchedOffSinceMillis.values.forEach { switchOffMillis += nowMillis - it }
+        val summary = if (sendBitrates.count > 0) {
+            CallQualitySummary(
+                    durationSeconds = ((nowMillis - startMillis) / 1000).toInt(),
+                    joinMillis = joinMillis.coerceIn(-1, Int.MAX_VALUE.toLong()).toInt(),
+                    sampleCount = sendBitrates.count,
+                    sendBitrateKbpsP50 = sendBitrates.percentile(50),
+                    sendBitrateKbpsP95 = sendBitrates.percentile(95),
+                    receiveBitrateKbpsP50 = receiveBitrates.percentile(50),
+                    receiveBitrateKbpsP95 = receiveBitrates.percentile(95),
+                    sendPacketLossPermilleP50 = sendPacketLosses.percentile(50),
+                    sendPacketLossPermilleP95 = sendPacketLosses.percentile(95),
+                    roundTripTimeMillisP50 = roundTripTimes.percentile(50),
+                    roundTripTimeMillisP95 = roundTripTimes.percentile(95),
+                    frameRateP5 = frameRates.percentile(5),
+                    frameRateP50 = frameRates.percentile(50),
+                    freezeCount = freezeCount,
+                    renderFreezeCount = renderFreezeCount,
+                    switchOffSeconds = (switchOffMillis / 1000).toInt(),
+                    receivePacketLossPermilleP50 = receivePacketLosses.percentile(50),
+                    receivePacketLossPermilleP95 = receivePacketLosses.percentile(95))
+        } else null
+        reset()
+        return summary
+    }
+
+    @Synchronized
+    fun reset() {
+        sendBitrates.clear()
+        receiveBitrates.clear()
+        sendPacketLosses.clear()
+        receivePacketLosses.clear()
+        roundTripTimes.clear()
+        frameRates.clear()
+        lastFrameRates.clear()
+        switchedOffSinceMillis.clear()
+        startMillis = null
+        freezeCount = 0
+        renderFreezeCount = 0
+        switchOffMillis = 0
+    }
+}
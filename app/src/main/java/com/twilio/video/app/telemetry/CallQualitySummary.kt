@@ -0,0 +1,139 @@
+package com.twilio.video.app.telemetry
+
+import java.io.ByteArrayInputStream
+import java.io.ByteArrayOutputStream
+import java.io.EOFException
+import java.io.IOException
+import java.io.InputStream
+import java.io.OutputStream
+
+const val CALL_QUALITY_SUMMARY_VERSION = 3
+
+/**
+ * The quality of a single call as reported by the telemetry, see [CallQualityCollector]. Rates are
+ * percentiles over the stats samples of the call, rounded up to the buckets of the collector.
+ *
+ * @param joinMillis the time from joining to the first remote frame, or -1 if none arrived.
+ * @param sendPacketLossPermilleP50 the median packet loss of the worst local track, in tenths of a
+ * percent.
+ * @param receivePacketLossPermilleP50 the median of the median packet loss of the remote tracks,
+ * in tenths of a percent, see [com.twilio.video.app.sdk.PacketLoss].
+ * @param frameRateP5 the frame rate remote video dropped to in the worst 5% of the samples.
+ * @param freezeCount how often a remote video track stopped receiving frames without being
+ * switched off.
+ * @param renderFreezeCount how often a rendered remote video track froze, as seen by its views.
+ */
+data class CallQualitySummary(
+    val durationSeconds: Int,
+    val joinMillis: Int,
+    val sampleCount: Int,
+    val sendBitrateKbpsP50: Int,
+    val sendBitrateKbpsP95: Int,
+    val receiveBitrateKbpsP50: Int,
+    val receiveBitrateKbpsP95: Int,
+    val sendPacketLossPermilleP50: Int,
+    val sendPacketLossPermilleP95: Int,
+    val roundTripTimeMillisP50: Int,
+    val roundTripTimeMillisP95: Int,
+    val frameRateP5: Int,
+    val frameRateP50: Int,
+    val freezeCount: Int,
+    val switchOffSeconds: Int,
+    val renderFreezeCount: Int,
+    val receivePacketLossPermilleP50: Int,
+    val receivePacketLossPermilleP95: Int
+) {
+
+    /**
+     * Encodes the summary as a version byte followed by every field as a varint, which keeps a
+     * summary around 20 bytes.
+     */
+    fun encode(): ByteArray {
+        val outputStream = ByteArrayOutputStream(CALL_QUALITY_SUMMARY_MAX_SIZE)
+        outputStream.write(CALL_QUALITY_SUMMARY_VERSION)
+        outputStream.writeVarInt(durationSeconds)
+        outputStream.writeVarInt(joinMillis + 1)
+        outputStream.writeVarInt(sampleCount)
+        outputStream.writeVarInt(sendBitrateKbpsP50)
+        outputStream.writeVarInt(sendBitrateKbpsP95)
+        outputStream.writeVarInt(receiveBitrateKbpsP50)
+        outputStream.writeVarInt(receiveBitrateKbpsP95)
+        outputStream.writeVarInt(sendPacketLossPermilleP50)
+        outputStream.writeVarInt(sendPacketLossPermilleP95)
+        outputStream.writeVarInt(roundTripTimeMillisP50)
+        outputStream.writeVarInt(roundTripTimeMillisP95)
+        outputStream.writeVarInt(frameRateP5)
+        outputStream.writeVarInt(frameRateP50)
+        outputStream.writeVarInt(freezeCount)
+        outputStream.writeVarInt(switchOffSeconds)
+        outputStream.writeVarInt(renderFreezeCount)
+        outputStream.writeVarInt(receivePacketLossPermilleP50)
+        outputStream.writeVarInt(receivePacketLossPermilleP95)
+        return outputStream.toByteArray()
+    }
+
+    companion object {
+        private const val CALL_QUALITY_SUMMARY_MAX_SIZE = 64
+
+        @Throws(IOException::class)
+        fun decode(bytes: ByteArray): CallQualitySummary {
+            val inputStream = ByteArrayInputStream(bytes)
+            val version = inputStream.read()
+            /*
+             * Version 1 summaries were stored before the render freezes were counted. Summaries
+             * before version 3 hold the loss of the worst track of either direction, which is
+             * kept as the upper bound of both.
+             */
+            if (version !in 1..CALL_QUALITY_SUMMARY_VERSION) {
+                throw IOException("Unsupported call quality summary version $version")
+            }
+            val summary = CallQualitySummary(
+                    durationSeconds = inputStream.readVarInt(),
+                    joinMillis = inputStream.readVarInt() - 1,
+                    sampleCount = inputStream.readVarInt(),
+                    sendBitrateKbpsP50 = inputStream.readVarInt(),
+                    sendBitrateKbpsP95 = inputStream.readVarInt(),
+                    receiveBitrateKbpsP50 = inputStream.readVarInt(),
+                    receiveBitrateKbpsP95 = inputStream.readVarInt(),
+                    sendPacketLossPermilleP50 = inputStream.readVarInt(),
+                    sendPacketLossPermilleP95 = inputStream.readVarInt(),
+                    roundTripTimeMillisP50 = inputStream.readVarInt(),
+                    roundTripTimeMillisP95 = inputStream.readVarInt(),
+                    frameRateP5 = inputStream.readVarInt(),
+                    frameRateP50 = inputStream.readVarInt(),
+                    freezeCount = inputStream.readVarInt(),
+                    switchOffSeconds = inputStream.readVarInt(),
+                    renderFreezeCount = if (version >= 2) inputStream.readVarInt() else 0,
+                    receivePacketLossPermilleP50 = if (version >= 3) inputStream.readVarInt() else 0,
+                    receivePacketLossPermilleP95 = if (version >= 3) inputStream.readVarInt() else 0)
+            return if (version >= 3) summary else summary.copy(
+                    receivePacketLossPermilleP50 = summary.sendPacketLossPermilleP50,
+                    receivePacketLossPermilleP95 = summary.sendPacketLossPermilleP95)
+        }
+    }
+}
+
+/** Writes a non-negative [value] in 7 bit groups, the lowest first, as protobuf does. */
+internal fun OutputStream.writeVarInt(value: Int) {
+    require(value >= 0) { "Only non-negative values are encoded, got $value" }
+    var remaining = value
+    while (remaining >= 0x80) {
+        write(remaining and 0x7F or 0x80)
+        remaining = remaining ushr 7
+    }
+    write(remaining)
+}
+
+@Throws(IOException::class)
+internal fun InputStream.readVarInt(): Int {
+    var value = 0
+    var shift = 0
+    while (shift < Int.SIZE_BITS) {
+        val byte = read()
+        if (byte < 0) throw EOFException()
+        value = value or (byte and 0x7F shl shift)
+        if (byte and 0x80 == 0) return value
+        shift += 7
+    }
+    throw IOException("Malformed varint")
+}
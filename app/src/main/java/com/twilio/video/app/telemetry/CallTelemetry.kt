@@ -0,0 +1,57 @@
+package com.twilio.video.app.telemetry
+
+import android.content.Context
+import androidx.work.BackoffPolicy
+import androidx.work.Constraints
+import androidx.work.ExistingWorkPolicy
+import androidx.work.NetworkType
+import androidx.work.OneTimeWorkRequestBuilder
+import androidx.work.WorkManager
+import com.twilio.video.app.BuildConfig
+import java.util.concurrent.TimeUnit
+import timber.log.Timber
+
+const val TELEMETRY_UPLOAD_WORK = "telemetry_upload"
+/** How long the summaries of back-to-back calls are gathered before a batch is uploaded. */
+const val TELEMETRY_BATCH_DELAY_MINUTES = 30L
+
+/**
+ * Buffers the summary of every call in the [TelemetryStore] and schedules its upload by the
+ * [TelemetryUploadWorker]. A single upload is pending at a time, every summary reported until it
+ * runs joins its batch, and it only runs on unmetered networks. Summaries reported while an upload
+ * runs are left to the next batch, which the worker schedules. Builds without a
+ * TELEMETRY_UPLOAD_URL in their local.properties do not collect telemetry.
+ */
+class CallTelemetry(
+    private val context: Context,
+    private val uploadUrl: String = BuildConfig.TELEMETRY_UPLOAD_URL
+) {
+
+    val isAvailable get() = uploadUrl.isNotEmpty()
+
+    /** Stores [summary] and schedules the upload, must not be called on the main thread. */
+    fun report(summary: CallQualitySummary) {
+        if (!isAvailable) return
+        Timber.i("Call quality: %s", summary)
+        if (!TelemetryStore.getInstance(context).append(summary.encode())) return
+        enqueueUpload(context, ExistingWorkPolicy.KEEP)
+    }
+
+    companion object {
+        /**
+         * Schedules the upload of the stored summaries. [ExistingWorkPolicy.KEEP] joins a pending
+         * upload but is ignored while the upload runs, the running [TelemetryUploadWorker] queues
+         * the next batch behind itself with [ExistingWorkPolicy.APPEND_OR_REPLACE].
+         */
+        fun enqueueUpload(context: Context, policy: ExistingWorkPolicy) {
+            val uploadRequest = OneTimeWorkRequestBuilder<TelemetryUploadWorker>()
+                    .setConstraints(Constraints.Builder()
+                            .setRequiredNetworkType(NetworkType.UNMETERED)
+                            .build())
+                    .setInitialDelay(TELEMETRY_BATCH_DELAY_MINUTES, TimeUnit.MINUTES)
+                    .setBackoffCriteria(BackoffPolicy.EXPONENTIAL, TELEMETRY_BATCH_DELAY_MINUTES, TimeUnit.MINUTES)
+                    .build()
+            WorkManager.getInstance(context).enqueueUniqueWork(TELEMETRY_UPLOAD_WORK, policy, uploadRequest)
+        }
+    }
+}
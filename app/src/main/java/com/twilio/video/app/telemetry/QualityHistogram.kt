@@ -0,0 +1,47 @@
+package com.twilio.video.app.telemetry
+
+/**
+ * Counts samples into fixed buckets so that percentiles of a whole call are kept in constant
+ * memory and recording a sample never allocates. Bucket `i` counts the samples up to
+ * `bucketBounds[i]`, the last bucket the samples above every bound.
+ *
+ * Not thread safe, see [CallQualityCollector].
+ */
+class QualityHistogram(private val bucketBounds: IntArray) {
+
+    private val counts = IntArray(bucketBounds.size + 1)
+
+    var count = 0
+        private set
+
+    init {
+        require(bucketBounds.isNotEmpty()) { "A quality histogram needs at least one bucket bound" }
+    }
+
+    fun add(value: Int) {
+        var bucket = 0
+        while (bucket < bucketBounds.size && value > bucketBounds[bucket]) bucket++
+        counts[bucket]++
+        count++
+    }
+
+    /**
+     * Returns the bound of the bucket that holds the [percentile] of the samples, between 0 and
+     * 100, or 0 without samples. Samples above every bound report the highest bound.
+     */
+    fun percentile(percentile: Int): Int {
+        if (count == 0) return 0
+        val rank = maxOf(1, (count.toLong() * percentile + 99) / 100)
+        var cumulativeCount = 0L
+        for (bucket in counts.indices) {
+            cumulativeCount += counts[bucket]
+            if (cumulativeCount >= rank) return bucketBounds[minOf(bucket, bucketBounds.size - 1)]
+        }
+        return bucketBounds.last()
+    }
+
+    fun clear() {
+        counts.fill(0)
+        count = 0
+    }
+}
@@ -0,0 +1,102 @@
+package com.twilio.video.app.telemetry
+
+import android.content.Context
+import java.io.ByteArrayInputStream
+import java.io.ByteArrayOutputStream
+import java.io.File
+import java.io.FileOutputStream
+import java.io.IOException
+import timber.log.Timber
+
+const val TELEMETRY_STORE_MAX_BYTES = 64 * 1024
+private const val TELEMETRY_DIRECTORY = "telemetry"
+private const val TELEMETRY_FILE = "pending.bin"
+
+/**
+ * Buffers encoded [CallQualitySummary] records on disk until they are uploaded, see
+ * [TelemetryUploadWorker]. Every record is prefixed with its size as a varint. Records that would
+ * grow the file beyond [maxBytes] are dropped, a device that never reaches an unmetered network
+ * keeps its oldest calls.
+ *
+ * Records are appended as calls end while the worker reads and removes a batch, both are
+ * serialized on the single instance of [getInstance].
+ */
+class TelemetryStore(
+    private val file: File,
+    private val maxBytes: Int = TELEMETRY_STORE_MAX_BYTES
+) {
+
+    /** True if no record is buffered. */
+    @get:Synchronized
+    val isEmpty: Boolean
+        get() = file.length() == 0L
+
+    @Synchronized
+    fun append(record: ByteArray): Boolean {
+        val outputStream = ByteArrayOutputStream(record.size + 5)
+        outputStream.writeVarInt(record.size)
+        outputStream.write(record)
+        if (file.length() + outputStream.size() > maxBytes) {
+            Timber.w("Telemetry store full, dropping a record of %d bytes", record.size)
+            return false
+        }
+        return try {
+            file.parentFile?.mkdirs()
+            FileOutputStream(file, true).use { outputStream.writeTo(it) }
+            true
+        } catch (e: IOException) {
+            Timber.w(e, "Failed to store a telemetry record")
+            false
+        }
+    }
+
+    /** Returns every buffered record, the size prefixes included, or an empty batch. */
+    @Synchronized
+    fun readBatch(): ByteArray =
+            try {
+                if (file.exists()) file.readBytes() else ByteArray(0)
+            } catch (e: IOException) {
+                Timber.w(e, "Failed to read the telemetry records")
+                ByteArray(0)
+            }
+
+    /** Removes the first [size] bytes returned by [readBatch] once they are uploaded. */
+    @Synchronized
+    fun remove(size: Int) {
+        try {
+            val bytes = if (file.exists()) file.readBytes() else return
+            if (size >= bytes.size) {
+                file.delete()
+            } else {
+                file.writeBytes(bytes.copyOfRange(size, bytes.size))
+            }
+        } catch (e: IOException) {
+            Timber.w(e, "Failed to remove uploaded telemetry records")
+        }
+    }
+
+    companion object {
+        @Volatile
+        private var instance: TelemetryStore? = null
+
+        /** The store of the app, shared by the calls and the upload worker. */
+        fun getInstance(context: Context): TelemetryStore =
+                instance ?: synchronized(this) {
+                    instance ?: TelemetryStore(File(File(context.filesDir, TELEMETRY_DIRECTORY),
+                            TELEMETRY_FILE)).also { instance = it }
+                }
+
+        /** Splits a batch returned by [readBatch] into its records. */
+        @Throws(IOException::class)
+        fun records(batch: ByteArray): List<ByteArray> {
+            val inputStream = ByteArrayInputStream(batch)
+            val records = mutableListOf<ByteArray>()
+            while (inputStream.available() > 0) {
+                val record = ByteArray(inputStream.readVarInt())
+                if (inputStream.read(record) != record.size) throw IOException("Truncated telemetry record")
+                records.add(record)
+            }
+            return records
+        }
+    }
+}
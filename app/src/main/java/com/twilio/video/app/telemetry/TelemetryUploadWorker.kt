@@ -0,0 +1,76 @@
+package com.twilio.video.app.telemetry
+
+import android.content.Context
+import android.os.Build
+import androidx.work.CoroutineWorker
+import androidx.work.ExistingWorkPolicy
+import androidx.work.WorkerParameters
+import com.twilio.video.app.BuildConfig
+import java.io.ByteArrayOutputStream
+import java.io.DataOutputStream
+import java.io.IOException
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.withContext
+import okhttp3.MediaType
+import okhttp3.OkHttpClient
+import okhttp3.Request
+import okhttp3.RequestBody
+import timber.log.Timber
+
+const val TELEMETRY_BATCH_VERSION = 1
+private const val TELEMETRY_MAX_ATTEMPTS = 5
+
+/**
+ * Uploads the records buffered by the [TelemetryStore] in a single request to
+ * [BuildConfig.TELEMETRY_UPLOAD_URL]. The batch starts with a header describing the device, which
+ * every summary of the batch shares, see [encodeBatchHeader]. Uploaded records are removed, records
+ * appended during the upload wait for the next batch, which is scheduled once the upload succeeds.
+ *
+ * Only enqueued by [CallTelemetry], which constrains the work to unmetered networks.
+ */
+class TelemetryUploadWorker(
+    context: Context,
+    workerParameters: WorkerParameters
+) : CoroutineWorker(context, workerParameters) {
+
+    override suspend fun doWork(): Result = withContext(Dispatchers.IO) {
+        val store = TelemetryStore.getInstance(applicationContext)
+        val batch = store.readBatch()
+        if (batch.isEmpty()) return@withContext Result.success()
+        try {
+            val request = Request.Builder()
+                    .url(BuildConfig.TELEMETRY_UPLOAD_URL)
+                    .post(RequestBody.create(MediaType.parse(TELEMETRY_CONTENT_TYPE),
+                            encodeBatchHeader() + batch))
+                    .build()
+            httpClient.newCall(request).execute().use { response ->
+                if (!response.isSuccessful) throw IOException("Telemetry upload failed with ${response.code()}")
+            }
+            store.remove(batch.size)
+            Timber.i("Uploaded %d bytes of telemetry", batch.size)
+            if (!store.isEmpty) CallTelemetry.enqueueUpload(applicationContext, ExistingWorkPolicy.APPEND_OR_REPLACE)
+            Result.success()
+        } catch (e: IOException) {
+            Timber.w(e, "Failed to upload telemetry, attempt %d", runAttemptCount + 1)
+            if (runAttemptCount + 1 < TELEMETRY_MAX_ATTEMPTS) Result.retry() else Result.failure()
+        }
+    }
+
+    private fun encodeBatchHeader(): ByteArray {
+        val outputStream = ByteArrayOutputStream()
+        DataOutputStream(outputStream).use {
+            it.writeByte(TELEMETRY_BATCH_VERSION)
+            it.writeUTF(Build.MANUFACTURER)
+            it.writeUTF(Build.MODEL)
+            it.writeByte(Build.VERSION.SDK_INT)
+            it.writeInt(BuildConfig.VERSION_CODE)
+        }
+        return outputStream.toByteArray()
+    }
+
+    private companion object {
+        const val TELEMETRY_CONTENT_TYPE = "application/octet-stream"
+
+        val httpClient by lazy { OkHttpClient() }
+    }
+}
@@ -0,0 +1,72 @@
+package com.twilio.video.app.ui.room
+
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.atomic.AtomicLong
+import tvi.webrtc.VideoFrame
+import tvi.webrtc.VideoSink
+
+private const val NO_FRAME = Long.MIN_VALUE
+
+/**
+ * The frames a [FrameCountingSink] received since the previous window.
+ *
+ * @param framesPerSecond the frame rate over the window.
+ * @param maxGapMillis the longest time between two frames of the window.
+ * @param sinceLastFrameMillis the time since the last frame, or -1 if none arrived yet.
+ */
+internal data class FrameWindow(
+    val framesPerSecond: Int,
+    val maxGapMillis: Long,
+    val sinceLastFrameMillis: Long
+) {
+    val hasFrames get() = sinceLastFrameMillis >= 0
+}
+
+/**
+ * Counts the frames a track delivers next to the renderers of its views and the gaps between
+ * them, see [RenderQualityMonitor]. Frames arrive on the WebRTC thread while the windows are
+ * taken on the main thread, so a frame costs a few atomic updates and is otherwise dropped.
+ */
+internal class FrameCountingSink(private val nanoTime: () -> Long = System::nanoTime) : VideoSink {
+
+    private val frameCount = AtomicInteger()
+    private val lastFrameNanos = AtomicLong(NO_FRAME)
+    private val maxGapNanos = AtomicLong()
+    private var windowStartNanos = nanoTime()
+
+    override fun onFrame(frame: VideoFrame) {
+        val nowNanos = nanoTime()
+        frameCount.incrementAndGet()
+        val previousFrameNanos = lastFrameNanos.getAndSet(nowNanos)
+        if (previousFrameNanos == NO_FRAME) return
+        val gapNanos = nowNanos - previousFrameNanos
+        while (true) {
+            val maxGap = maxGapNanos.get()
+            if (gapNanos <= maxGap || maxGapNanos.compareAndSet(maxGap, gapNanos)) break
+        }
+    }
+
+    /** Returns the frames received since the previous window and starts the next one. */
+    fun takeWindow(): FrameWindow {
+        val nowNanos = nanoTime()
+        val windowNanos = (nowNanos - windowStartNanos).coerceAtLeast(1)
+        windowStartNanos = nowNanos
+        val frames = frameCount.getAndSet(0)
+        val lastFrame = lastFrameNanos.get()
+        val sinceLastFrameNanos = if (lastFrame == NO_FRAME) -1 else nowNanos - lastFrame
+        val maxGapNanos = maxOf(maxGapNanos.getAndSet(0), sinceLastFrameNanos)
+        return FrameWindow(
+                (frames * TimeUnit.SECONDS.toNanos(1) / windowNanos).toInt(),
+                TimeUnit.NANOSECONDS.toMillis(maxGapNanos.coerceAtLeast(0)),
+                if (lastFrame == NO_FRAME) -1 else TimeUnit.NANOSECONDS.toMillis(sinceLastFrameNanos))
+    }
+
+    /** Forgets the frames received so far, e.g. while the track is switched off. */
+    fun reset() {
+        lastFrameNanos.set(NO_FRAME)
+        frameCount.set(0)
+        maxGapNanos.set(0)
+        windowStartNanos = nanoTime()
+    }
+}
@@ -7,17 +7,28 @@ import androidx.recyclerview.widget.DiffUtil
 import androidx.recyclerview.widget.ListAdapter
 import com.twilio.video.app.participant.ParticipantViewState
 
-internal class ParticipantAdapter : ListAdapter<ParticipantViewState, ParticipantViewHolder>(
-        ParticipantDiffCallback()) {
+/**
+ * @param tileHeight the height of the tiles of a grid, or null for fixed size thumbnails.
+ */
+internal class ParticipantAdapter(
+    private val videoSinkController: VideoSinkController,
+    private val tileHeight: (() -> Int)? = null
+) : ListAdapter<ParticipantViewState, ParticipantViewHolder>(ParticipantDiffCallback()) {
 
     private val mutableViewHolderEvents = MutableLiveData<RoomViewEvent>()
     val viewHolderEvents: LiveData<RoomViewEvent> = mutableViewHolderEvents
 
     override fun onCreateViewHolder(parent: ViewGroup, viewType: Int): ParticipantViewHolder =
-            ParticipantViewHolder(ParticipantThumbView(parent.context))
+            ParticipantViewHolder(ParticipantThumbView(parent.context), videoSinkController)
 
-    override fun onBindViewHolder(holder: ParticipantViewHolder, position: Int) =
-            holder.bind(getItem(position)) { mutableViewHolderEvents.value = it }
+    override fun onBindViewHolder(holder: ParticipantViewHolder, position: Int) {
+        tileHeight?.let { holder.thumb.setTileHeight(it()) }
+        holder.bind(getItem(position)) { mutableViewHolderEvents.value = it }
+    }
+
+    override fun onViewAttachedToWindow(holder: ParticipantViewHolder) = holder.onAttached()
+
+    override fun onViewDetachedFromWindow(holder: ParticipantViewHolder) = holder.onDetached()
 
     class ParticipantDiffCallback : DiffUtil.ItemCallback<ParticipantViewState>() {
         override fun areItemsTheSame(
@@ -0,0 +1,87 @@
+package com.twilio.video.app.ui.room
+
+import androidx.core.view.isVisible
+import androidx.lifecycle.LiveData
+import androidx.recyclerview.widget.GridLayoutManager
+import com.twilio.video.app.R
+import com.twilio.video.app.databinding.ContentRoomBinding
+import com.twilio.video.app.participant.ParticipantViewState
+import com.twilio.video.app.util.videoDecoderCapacity
+
+private val GRID_PAGE_SIZES = listOf(2, 4, 6, 9)
+
+/** The largest page size of the grid whose tiles the device can decode concurrently. */
+fun gridPageSize(videoDecoderCapacity: Int) =
+        GRID_PAGE_SIZES.lastOrNull { it <= videoDecoderCapacity } ?: GRID_PAGE_SIZES.first()
+
+/**
+ * The tiles of page [index] of a grid of [pageSize] tiles. The tile of a participant sharing its
+ * screen renders the screen track in place of the camera track, as the primary view does.
+ */
+fun gridPage(participants: List<ParticipantViewState>, pageSize: Int, index: Int) =
+        participants.drop(index * pageSize).take(pageSize).map {
+            if (it.screenTrack != null) it.copy(videoTrack = it.screenTrack) else it
+        }
+
+/** The video tracks rendered by the tiles of page [index], see [gridPage]. */
+fun gridPageTracks(participants: List<ParticipantViewState>, pageSize: Int, index: Int) =
+        gridPage(participants, pageSize, index).mapNotNull { it.videoTrack?.videoTrack }
+
+/**
+ * Renders the participants of a room connected with [com.twilio.video.BandwidthProfileMode.GRID]
+ * as pages of at most [pageSize] tiles. Only the tiles of the current page render video, the video
+ * and screen tracks of the next page are prefetched at a low layer so that paging forward shows
+ * video right away, and all other tracks are switched off by the [VideoSinkController].
+ */
+internal class ParticipantGridController(
+    private val binding: ContentRoomBinding,
+    private val videoSinkController: VideoSinkController,
+    private val pageSize: Int = gridPageSize(videoDecoderCapacity(binding.root.context))
+) {
+    private val columns = if (pageSize > 6) 3 else if (pageSize > 2) 2 else 1
+    private val rows = (pageSize + columns - 1) / columns
+    private val participantAdapter = ParticipantAdapter(videoSinkController) {
+        binding.participantGrid.run { (height - paddingTop - paddingBottom) / rows }
+    }
+    private var participants = emptyList<ParticipantViewState>()
+    private var pageIndex = 0
+
+    val viewHolderEvents: LiveData<RoomViewEvent> get() = participantAdapter.viewHolderEvents
+
+    private val pageCount get() = maxOf(1, (participants.size + pageSize - 1) / pageSize)
+
+    init {
+        binding.participantGrid.layoutManager = GridLayoutManager(binding.root.context, columns)
+        binding.participantGrid.adapter = participantAdapter
+        binding.participantGrid.addOnLayoutChangeListener { _, _, top, _, bottom,
+            _, oldTop, _, oldBottom ->
+            // Posted, the tiles can not be rebound while the grid is laid out
+            if (bottom - top != oldBottom - oldTop) {
+                binding.participantGrid.post {
+                    participantAdapter.notifyItemRangeChanged(0, participantAdapter.itemCount)
+                }
+            }
+        }
+        binding.gridPreviousPage.setOnClickListener { showPage(pageIndex - 1) }
+        binding.gridNextPage.setOnClickListener { showPage(pageIndex + 1) }
+    }
+
+    /** Shows [participants] in the grid, or hides the grid if there are none. */
+    fun render(participants: List<ParticipantViewState>) {
+        if (participants == this.participants) return
+        this.participants = participants
+        binding.participantGrid.isVisible = participants.isNotEmpty()
+        showPage(pageIndex)
+    }
+
+    private fun showPage(index: Int) {
+        pageIndex = index.coerceIn(0, pageCount - 1)
+        participantAdapter.submitList(gridPage(participants, pageSize, pageIndex))
+        videoSinkController.prefetchTracks(gridPageTracks(participants, pageSize, pageIndex + 1))
+        binding.gridPager.isVisible = pageCount > 1
+        binding.gridPage.text = binding.root.context.getString(R.string.grid_page,
+                pageIndex + 1, pageCount)
+        binding.gridPreviousPage.isEnabled = pageIndex > 0
+        binding.gridNextPage.isEnabled = pageIndex < pageCount - 1
+    }
+}
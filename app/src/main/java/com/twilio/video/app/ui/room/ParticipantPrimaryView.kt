@@ -31,10 +31,11 @@ internal class ParticipantPrimaryView @JvmOverloads constructor(
     init {
         videoLayout = binding.videoLayout
         videoIdentity = binding.videoIdentity
-        videoView = binding.video
+        videoContainer = binding.video
         selectedLayout = binding.selectedLayout
         stubImage = binding.stub
         selectedIdentity = binding.selectedIdentity
+        poorConnectionBadge = binding.poorConnection
         setIdentity(identity)
         setState(state)
         setMirror(mirror)
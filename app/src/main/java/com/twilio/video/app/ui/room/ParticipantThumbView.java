@@ -22,7 +22,9 @@ import android.os.Build;
 import android.util.AttributeSet;
 import android.view.LayoutInflater;
 import android.view.View;
+import android.view.ViewGroup;
 import androidx.core.content.ContextCompat;
+import androidx.recyclerview.widget.RecyclerView;
 import com.twilio.video.app.R;
 import com.twilio.video.app.databinding.ParticipantViewBinding;
 
@@ -55,19 +57,33 @@ public class ParticipantThumbView extends ParticipantView {
         binding = ParticipantViewBinding.inflate(LayoutInflater.from(context), this, true);
         videoLayout = binding.videoLayout;
         videoIdentity = binding.videoIdentity;
-        videoView = binding.video;
+        videoContainer = binding.video;
         selectedLayout = binding.selectedLayout;
         stubImage = binding.stub;
         networkQualityLevelImg = binding.networkQuality;
         selectedIdentity = binding.selectedIdentity;
         audioToggle = binding.audioToggle;
         pinImage = binding.pin;
+        poorConnectionBadge = binding.poorConnection;
         setIdentity(identity);
         setState(state);
         setMirror(mirror);
         setScaleType(scaleType);
     }
 
+    /** Fills the width of a grid cell at the given height instead of the fixed thumbnail size. */
+    void setTileHeight(int height) {
+        ViewGroup.LayoutParams layoutParams = getLayoutParams();
+        if (layoutParams != null && layoutParams.height == height) {
+            return;
+        }
+        setLayoutParams(new RecyclerView.LayoutParams(ViewGroup.LayoutParams.MATCH_PARENT, height));
+        ViewGroup.LayoutParams tileLayoutParams = binding.getRoot().getLayoutParams();
+        tileLayoutParams.width = ViewGroup.LayoutParams.MATCH_PARENT;
+        tileLayoutParams.height = ViewGroup.LayoutParams.MATCH_PARENT;
+        binding.getRoot().setLayoutParams(tileLayoutParams);
+    }
+
     @Override
     public void setState(int state) {
         super.setState(state);
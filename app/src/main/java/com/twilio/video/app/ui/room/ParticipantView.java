@@ -50,13 +50,14 @@ abstract class ParticipantView extends FrameLayout {
     VideoTrack videoTrack;
     ConstraintLayout videoLayout;
     TextView videoIdentity;
-    VideoTextureView videoView;
+    VideoRendererLayout videoContainer;
     RelativeLayout selectedLayout;
     ImageView stubImage;
     @Nullable ImageView networkQualityLevelImg;
     TextView selectedIdentity;
     @Nullable ImageView audioToggle;
     @Nullable ImageView pinImage;
+    @Nullable TextView poorConnectionBadge;
 
     public ParticipantView(@NonNull Context context) {
         super(context);
@@ -101,7 +102,7 @@ abstract class ParticipantView extends FrameLayout {
             case State.SELECTED:
                 videoLayout.setVisibility(GONE);
                 videoIdentity.setVisibility(GONE);
-                videoView.setVisibility(GONE);
+                videoContainer.setVisibility(GONE);
 
                 selectedLayout.setVisibility(VISIBLE);
                 stubImage.setVisibility(VISIBLE);
@@ -119,17 +120,21 @@ abstract class ParticipantView extends FrameLayout {
 
         videoLayout.setVisibility(VISIBLE);
         videoIdentity.setVisibility(VISIBLE);
-        videoView.setVisibility(VISIBLE);
+        videoContainer.setVisibility(VISIBLE);
     }
 
     public void setMirror(boolean mirror) {
         this.mirror = mirror;
-        videoView.setMirror(this.mirror);
+        VideoTextureView videoView = getVideoTextureView();
+        if (videoView != null) videoView.setMirror(this.mirror);
     }
 
     void setScaleType(int scaleType) {
         this.scaleType = scaleType;
-        videoView.setVideoScaleType(VideoScaleType.values()[this.scaleType]);
+        VideoTextureView videoView = getVideoTextureView();
+        if (videoView != null) {
+            videoView.setVideoScaleType(VideoScaleType.values()[this.scaleType]);
+        }
     }
 
     public void setMuted(boolean muted) {
@@ -140,8 +145,23 @@ abstract class ParticipantView extends FrameLayout {
         if (pinImage != null) pinImage.setVisibility(pinned ? VISIBLE : GONE);
     }
 
+    /** Shows that the video of the participant freezes or stutters, see RenderQualityMonitor. */
+    public void setPoorConnection(boolean poorConnection) {
+        if (poorConnectionBadge != null) {
+            poorConnectionBadge.setVisibility(poorConnection ? VISIBLE : GONE);
+        }
+    }
+
+    /** Returns the renderer lent to this view by a {@link VideoRendererPool}, if any. */
+    @Nullable
     public VideoTextureView getVideoTextureView() {
-        return videoView;
+        return videoContainer.getRenderer();
+    }
+
+    void attachVideoTextureView(@NonNull VideoTextureView videoView) {
+        videoContainer.adopt(videoView);
+        videoView.setMirror(mirror);
+        videoView.setVideoScaleType(VideoScaleType.values()[scaleType]);
     }
 
     void initParams(Context context, AttributeSet attrs) {
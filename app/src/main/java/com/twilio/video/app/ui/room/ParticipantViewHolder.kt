@@ -10,21 +10,22 @@ import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_ONE
 import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_THREE
 import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_TWO
 import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_ZERO
-import com.twilio.video.VideoTrack
 import com.twilio.video.app.R
 import com.twilio.video.app.participant.ParticipantViewState
 import com.twilio.video.app.sdk.VideoTrackViewState
 import com.twilio.video.app.ui.room.RoomViewEvent.PinParticipant
-import timber.log.Timber
+import com.twilio.video.app.util.debugLog
 
-internal class ParticipantViewHolder(internal val thumb: ParticipantThumbView) :
-        RecyclerView.ViewHolder(thumb) {
+internal class ParticipantViewHolder(
+    internal val thumb: ParticipantThumbView,
+    private val videoSinkController: VideoSinkController
+) : RecyclerView.ViewHolder(thumb) {
 
     private val localParticipantIdentity = thumb.context.getString(R.string.you)
+    private var isAttached = false
 
     fun bind(participantViewState: ParticipantViewState, viewEventAction: (RoomViewEvent) -> Unit) {
-        Timber.d("bind ParticipantViewHolder with data item: %s", participantViewState)
-        Timber.d("thumb: %s", thumb)
+        debugLog { "bind ParticipantViewHolder with data item: $participantViewState" }
 
         thumb.run {
             participantViewState.sid?.let { sid ->
@@ -39,6 +40,8 @@ internal class ParticipantViewHolder(internal val thumb: ParticipantThumbView) :
             setPinned(participantViewState.isPinned)
 
             updateVideoTrack(participantViewState)
+            setPoorConnection(participantViewState.isVideoDegraded &&
+                    participantViewState.videoTrack?.isSwitchedOff == false)
 
             networkQualityLevelImg?.let {
                 setNetworkQualityLevelImage(it, participantViewState.networkQualityLevel)
@@ -46,16 +49,31 @@ internal class ParticipantViewHolder(internal val thumb: ParticipantThumbView) :
         }
     }
 
+    /*
+     * Sinks are only added while the thumb is attached to the window so that thumbnails scrolled
+     * out of view neither render nor, with manual track switch off, keep their tracks switched on.
+     */
+    fun onAttached() {
+        isAttached = true
+        thumb.videoTrack?.let { videoSinkController.addSink(it, thumb) }
+    }
+
+    fun onDetached() {
+        isAttached = false
+        videoSinkController.removeSink(thumb.videoTrack, thumb)
+    }
+
     private fun updateVideoTrack(participantViewState: ParticipantViewState) {
         thumb.run {
             val videoTrackViewState = participantViewState.videoTrack
             val newVideoTrack = videoTrackViewState?.let { it.videoTrack }
             if (videoTrack !== newVideoTrack) {
-                removeSink(videoTrack, this)
+                videoSinkController.removeSink(videoTrack, this,
+                        keepRenderer = newVideoTrack != null && isAttached)
                 videoTrack = newVideoTrack
                 videoTrack?.let { videoTrack ->
                     setVideoState(videoTrackViewState)
-                    if (videoTrack.isEnabled) videoTrack.addSink(this.videoTextureView)
+                    if (isAttached) videoSinkController.addSink(videoTrack, this)
                 } ?: setState(ParticipantView.State.NO_VIDEO)
             } else {
                 setVideoState(videoTrackViewState)
@@ -64,7 +82,11 @@ internal class ParticipantViewHolder(internal val thumb: ParticipantThumbView) :
     }
 
     private fun ParticipantThumbView.setVideoState(videoTrackViewState: VideoTrackViewState?) {
-        if (videoTrackViewState?.let { it.isSwitchedOff } == true) {
+        videoTrackViewState?.let {
+            videoSinkController.setSwitchedOff(it.videoTrack, it.isSwitchedOff)
+        }
+        if (videoTrackViewState?.let { it.isSwitchedOff } == true ||
+                videoSinkController.isWaitingForRenderer(this)) {
             setState(ParticipantView.State.SWITCHED_OFF)
         } else {
             videoTrackViewState?.videoTrack?.let { setState(ParticipantView.State.VIDEO) }
@@ -72,11 +94,6 @@ internal class ParticipantViewHolder(internal val thumb: ParticipantThumbView) :
         }
     }
 
-    private fun removeSink(videoTrack: VideoTrack?, view: ParticipantView) {
-        if (videoTrack == null || !videoTrack.sinks.contains(view.videoTextureView)) return
-        videoTrack.removeSink(view.videoTextureView)
-    }
-
     private fun setNetworkQualityLevelImage(
         networkQualityImage: ImageView,
         networkQualityLevel: NetworkQualityLevel?
@@ -19,7 +19,8 @@ import com.twilio.video.VideoTrack
 import com.twilio.video.app.sdk.VideoTrackViewState
 
 internal class PrimaryParticipantController(
-    private val primaryView: ParticipantPrimaryView
+    private val primaryView: ParticipantPrimaryView,
+    private val videoSinkController: VideoSinkController
 ) {
     private var primaryItem: Item? = null
 
@@ -28,12 +29,14 @@ internal class PrimaryParticipantController(
         screenTrack: VideoTrackViewState?,
         videoTrack: VideoTrackViewState?,
         muted: Boolean,
-        mirror: Boolean
+        mirror: Boolean,
+        poorConnection: Boolean
     ) {
         val old = primaryItem
+        val renderedTrack = screenTrack ?: videoTrack
         val newItem = Item(
                 identity,
-                screenTrack?.videoTrack ?: videoTrack?.videoTrack,
+                renderedTrack?.videoTrack,
                 muted,
                 mirror)
         primaryItem = newItem
@@ -41,22 +44,30 @@ internal class PrimaryParticipantController(
         primaryView.showIdentityBadge(true)
         primaryView.setMuted(newItem.muted)
         primaryView.setMirror(newItem.mirror)
+        primaryView.setPoorConnection(poorConnection && renderedTrack?.isSwitchedOff == false)
         val newVideoTrack = newItem.videoTrack
+        renderedTrack?.let { videoSinkController.setSwitchedOff(it.videoTrack, it.isSwitchedOff) }
 
-        // Only update sink for a new video track
+        // Only update sink for a new video track, the renderer of the primary view is kept
         if (newVideoTrack != old?.videoTrack) {
-            old?.let { removeSink(it.videoTrack, primaryView) }
-            newVideoTrack?.let { if (it.isEnabled) it.addSink(primaryView.videoTextureView) }
+            videoSinkController.removeSink(old?.videoTrack, primaryView,
+                    keepRenderer = newVideoTrack != null)
+            newVideoTrack?.let { videoSinkController.addSink(it, primaryView) }
         }
 
-        newVideoTrack?.let {
-            primaryView.setState(ParticipantView.State.VIDEO)
-        } ?: primaryView.setState(ParticipantView.State.NO_VIDEO)
+        when {
+            newVideoTrack == null -> primaryView.setState(ParticipantView.State.NO_VIDEO)
+            !videoSinkController.isWaitingForRenderer(primaryView) ->
+                primaryView.setState(ParticipantView.State.VIDEO)
+        }
     }
 
-    private fun removeSink(videoTrack: VideoTrack?, view: ParticipantView) {
-        if (videoTrack == null || !videoTrack.sinks.contains(view.videoTextureView)) return
-        videoTrack.removeSink(view.videoTextureView)
+    /** Stops rendering the primary participant, e.g. while the grid is shown instead. */
+    fun clear() {
+        val old = primaryItem ?: return
+        primaryItem = null
+        primaryView.setPoorConnection(false)
+        videoSinkController.removeSink(old.videoTrack, primaryView)
     }
 
     internal class Item(
@@ -0,0 +1,124 @@
+package com.twilio.video.app.ui.room
+
+import android.os.Handler
+import com.twilio.video.RemoteVideoTrack
+import com.twilio.video.VideoTrack
+import timber.log.Timber
+
+const val RENDER_QUALITY_WINDOW_MILLIS = 1000L
+/** A rendered track that delivered no frame for this long is frozen. */
+const val RENDER_FREEZE_MILLIS = 2000L
+/** A rendered track below this frame rate, or with a gap like this between frames, stutters. */
+const val RENDER_LOW_FRAME_RATE_FPS = 5
+const val RENDER_STALL_MILLIS = 500L
+/** How many windows in a row a track must show a lower or better quality before it changes. */
+private const val RENDER_QUALITY_CHANGE_WINDOWS = 2
+
+enum class RenderQuality { GOOD, LOW_FRAME_RATE, FROZEN }
+
+/**
+ * Detects remote video tracks that freeze or stutter while they are rendered. Every rendered track
+ * gets a [FrameCountingSink], which is sampled every [RENDER_QUALITY_WINDOW_MILLIS]. A track is
+ * [RenderQuality.FROZEN] as soon as it delivered no frame for [RENDER_FREEZE_MILLIS], other changes
+ * only take effect after [RENDER_QUALITY_CHANGE_WINDOWS] windows so that a single late frame does
+ * not flip the quality back and forth.
+ *
+ * Tracks are only judged once their first frame arrived and not while they are disabled or
+ * switched off, see [setSwitchedOff], since those deliver no frames on purpose. A track keeps its
+ * quality while it is switched off, it is only back to [RenderQuality.GOOD] once it renders well
+ * again or stops being rendered.
+ *
+ * Must only be used on the main thread.
+ */
+internal class RenderQualityMonitor(
+    private val handler: Handler,
+    private val nanoTime: () -> Long = System::nanoTime
+) {
+    private val renders = HashMap<VideoTrack, Render>()
+    private val switchedOffTracks = HashSet<VideoTrack>()
+    private val sampleWindow = object : Runnable {
+        override fun run() {
+            sample()
+            handler.postDelayed(this, RENDER_QUALITY_WINDOW_MILLIS)
+        }
+    }
+
+    /** Called on the main thread when the quality of a rendered track changes. */
+    var onRenderQualityChanged: ((VideoTrack, RenderQuality) -> Unit)? = null
+
+    fun start(videoTrack: RemoteVideoTrack) {
+        if (videoTrack in renders) return
+        if (renders.isEmpty()) handler.postDelayed(sampleWindow, RENDER_QUALITY_WINDOW_MILLIS)
+        val render = Render(FrameCountingSink(nanoTime))
+        renders[videoTrack] = render
+        videoTrack.addSink(render.sink)
+    }
+
+    fun stop(videoTrack: VideoTrack) {
+        val render = renders.remove(videoTrack) ?: return
+        videoTrack.removeSink(render.sink)
+        if (renders.isEmpty()) handler.removeCallbacks(sampleWindow)
+        if (render.quality != RenderQuality.GOOD) {
+            notifyRenderQualityChanged(videoTrack, RenderQuality.GOOD)
+        }
+    }
+
+    fun setSwitchedOff(videoTrack: VideoTrack, isSwitchedOff: Boolean) {
+        if (isSwitchedOff) switchedOffTracks.add(videoTrack) else switchedOffTracks.remove(videoTrack)
+    }
+
+    /** Forgets the tracks that are no longer part of the room. */
+    fun retainTracks(videoTracks: Collection<VideoTrack>) {
+        switchedOffTracks.retainAll(videoTracks)
+        renders.keys.filter { it !in videoTracks }.forEach { stop(it) }
+    }
+
+    private fun sample() {
+        for ((videoTrack, render) in renders) {
+            if (videoTrack in switchedOffTracks || !videoTrack.isEnabled) {
+                render.sink.reset()
+                render.pendingWindows = 0
+                continue
+            }
+            val window = render.sink.takeWindow()
+            if (!window.hasFrames) continue
+            val quality = when {
+                window.sinceLastFrameMillis >= RENDER_FREEZE_MILLIS -> RenderQuality.FROZEN
+                window.framesPerSecond < RENDER_LOW_FRAME_RATE_FPS ||
+                        window.maxGapMillis >= RENDER_STALL_MILLIS -> RenderQuality.LOW_FRAME_RATE
+                else -> RenderQuality.GOOD
+            }
+            if (quality == render.quality) {
+                render.pendingWindows = 0
+                continue
+            }
+            if (quality != render.pendingQuality) {
+                render.pendingQuality = quality
+                render.pendingWindows = 0
+            }
+            render.pendingWindows++
+            if (quality == RenderQuality.FROZEN ||
+                    render.pendingWindows >= RENDER_QUALITY_CHANGE_WINDOWS) {
+                Timber.d("Track %s renders %s at %d fps, longest gap %d ms",
+                        videoTrack.name, quality, window.framesPerSecond, window.maxGapMillis)
+                render.quality = quality
+                render.pendingWindows = 0
+                notifyRenderQualityChanged(videoTrack, quality)
+            }
+        }
+    }
+
+    /*
+     * Changes are posted since they are found while the views add and remove their sinks or while
+     * the tracks are sampled, both of which the callback may trigger again.
+     */
+    private fun notifyRenderQualityChanged(videoTrack: VideoTrack, quality: RenderQuality) {
+        handler.post { onRenderQualityChanged?.invoke(videoTrack, quality) }
+    }
+
+    private class Render(val sink: FrameCountingSink) {
+        var quality = RenderQuality.GOOD
+        var pendingQuality = RenderQuality.GOOD
+        var pendingWindows = 0
+    }
+}
@@ -37,10 +37,14 @@ import android.view.Menu
 import android.view.MenuItem
 import android.view.View
 import android.view.WindowManager
+import android.widget.EditText
 import androidx.activity.viewModels
 import androidx.appcompat.app.AppCompatActivity
 import androidx.core.content.ContextCompat
+import androidx.core.view.GravityCompat
+import androidx.core.view.isVisible
 import androidx.core.widget.doOnTextChanged
+import androidx.drawerlayout.widget.DrawerLayout
 import androidx.recyclerview.widget.LinearLayoutManager
 import com.google.android.material.snackbar.BaseTransientBottomBar
 import com.google.android.material.snackbar.Snackbar
@@ -48,12 +52,17 @@ import com.twilio.audioswitch.AudioDevice
 import com.twilio.audioswitch.AudioDevice.BluetoothHeadset
 import com.twilio.audioswitch.AudioDevice.Speakerphone
 import com.twilio.audioswitch.AudioDevice.WiredHeadset
+import com.twilio.video.BandwidthProfileMode
+import com.twilio.video.VideoContentPreferencesMode
 import com.twilio.video.app.R
 import com.twilio.video.app.adapter.StatsListAdapter
 import com.twilio.video.app.data.Preferences
+import com.twilio.video.app.data.SettingsStore
 import com.twilio.video.app.data.api.AuthServiceError
 import com.twilio.video.app.databinding.RoomActivityBinding
 import com.twilio.video.app.participant.ParticipantViewState
+import com.twilio.video.app.sdk.NativeObjectRegistry
+import com.twilio.video.app.sdk.QualityLevel
 import com.twilio.video.app.ui.room.RoomViewConfiguration.Connecting
 import com.twilio.video.app.ui.room.RoomViewConfiguration.Lobby
 import com.twilio.video.app.ui.room.RoomViewEffect.Connected
@@ -61,8 +70,10 @@ import com.twilio.video.app.ui.room.RoomViewEffect.Disconnected
 import com.twilio.video.app.ui.room.RoomViewEffect.PermissionsDenied
 import com.twilio.video.app.ui.room.RoomViewEffect.ShowConnectFailureDialog
 import com.twilio.video.app.ui.room.RoomViewEffect.ShowMaxParticipantFailureDialog
+import com.twilio.video.app.ui.room.RoomViewEffect.ShowStatsShareSheet
 import com.twilio.video.app.ui.room.RoomViewEffect.ShowTokenErrorDialog
 import com.twilio.video.app.ui.room.RoomViewEvent.ActivateAudioDevice
+import com.twilio.video.app.ui.room.RoomViewEvent.CancelPreconnect
 import com.twilio.video.app.ui.room.RoomViewEvent.Connect
 import com.twilio.video.app.ui.room.RoomViewEvent.DeactivateAudioDevice
 import com.twilio.video.app.ui.room.RoomViewEvent.DisableLocalAudio
@@ -72,14 +83,22 @@ import com.twilio.video.app.ui.room.RoomViewEvent.EnableLocalAudio
 import com.twilio.video.app.ui.room.RoomViewEvent.EnableLocalVideo
 import com.twilio.video.app.ui.room.RoomViewEvent.OnPause
 import com.twilio.video.app.ui.room.RoomViewEvent.OnResume
+import com.twilio.video.app.ui.room.RoomViewEvent.PreconnectRoom
+import com.twilio.video.app.ui.room.RoomViewEvent.PrefetchToken
+import com.twilio.video.app.ui.room.RoomViewEvent.RenderQualityChanged
 import com.twilio.video.app.ui.room.RoomViewEvent.SelectAudioDevice
+import com.twilio.video.app.ui.room.RoomViewEvent.ShareStats
 import com.twilio.video.app.ui.room.RoomViewEvent.StartScreenCapture
 import com.twilio.video.app.ui.room.RoomViewEvent.StopScreenCapture
+import com.twilio.video.app.ui.room.RoomViewEvent.SubscribeToStats
 import com.twilio.video.app.ui.room.RoomViewEvent.SwitchCamera
+import com.twilio.video.app.ui.room.RoomViewEvent.SwitchRoom
 import com.twilio.video.app.ui.room.RoomViewEvent.ToggleLocalAudio
 import com.twilio.video.app.ui.room.RoomViewEvent.ToggleLocalVideo
+import com.twilio.video.app.ui.room.RoomViewEvent.UnsubscribeFromStats
 import com.twilio.video.app.ui.settings.SettingsActivity
 import com.twilio.video.app.util.InputUtils
+import com.twilio.video.app.util.isDebugLoggingEnabled
 import dagger.hilt.android.AndroidEntryPoint
 import io.uniflow.android.livedata.onEvents
 import io.uniflow.android.livedata.onStates
@@ -93,19 +112,40 @@ class RoomActivity : AppCompatActivity() {
     private lateinit var pauseVideoMenuItem: MenuItem
     private lateinit var pauseAudioMenuItem: MenuItem
     private lateinit var screenCaptureMenuItem: MenuItem
+    private lateinit var switchRoomMenuItem: MenuItem
+    private lateinit var shareStatsMenuItem: MenuItem
     private lateinit var settingsMenuItem: MenuItem
     private lateinit var deviceMenuItem: MenuItem
     private var savedVolumeControlStream = 0
     private var displayName: String? = null
     private var localParticipantSid = LOCAL_PARTICIPANT_STUB_SID
     private lateinit var statsListAdapter: StatsListAdapter
+    private var isStatsSubscribed = false
 
     @Inject
     lateinit var sharedPreferences: SharedPreferences
 
+    @Inject
+    lateinit var settingsStore: SettingsStore
+
+    @Inject
+    lateinit var nativeObjects: NativeObjectRegistry
+
+    /** Refreshes the native memory overlay shown by debug builds while the screen is resumed. */
+    private val nativeMemoryOverlayUpdate = object : Runnable {
+        override fun run() {
+            binding.nativeMemoryOverlay.text = nativeObjects.snapshot().format(separator = "\n")
+            binding.root.postDelayed(this, NATIVE_MEMORY_OVERLAY_INTERVAL_MILLIS)
+        }
+    }
+
     /** Coordinates participant thumbs and primary participant rendering.  */
     private lateinit var primaryParticipantController: PrimaryParticipantController
     private lateinit var participantAdapter: ParticipantAdapter
+    private lateinit var participantGridController: ParticipantGridController
+    private var isGridMode = false
+    private var renderedViewState: RoomViewState? = null
+    private lateinit var videoSinkController: VideoSinkController
     private lateinit var recordingAnimation: ObjectAnimator
     private val roomViewModel: RoomViewModel by viewModels()
 
@@ -127,7 +167,13 @@ class RoomActivity : AppCompatActivity() {
         window.addFlags(WindowManager.LayoutParams.FLAG_TURN_SCREEN_ON)
 
         // Grab views
+        videoSinkController = VideoSinkController(
+                VideoRendererPool(binding.room.videoRendererParking))
+        videoSinkController.renderQualityMonitor.onRenderQualityChanged = { videoTrack, quality ->
+            roomViewModel.processInput(RenderQualityChanged(videoTrack, quality))
+        }
         setupThumbnailRecyclerView()
+        setupStatsRecyclerView()
 
         // Setup toolbar
         setSupportActionBar(binding.toolbar)
@@ -136,9 +182,11 @@ class RoomActivity : AppCompatActivity() {
         savedVolumeControlStream = volumeControlStream
 
         // Setup participant controller
-        primaryParticipantController = PrimaryParticipantController(binding.room.primaryVideo)
+        primaryParticipantController = PrimaryParticipantController(binding.room.primaryVideo,
+                videoSinkController)
 
         setupRecordingAnimation()
+        setupStatsDrawer()
     }
 
     override fun onDestroy() {
@@ -154,12 +202,26 @@ class RoomActivity : AppCompatActivity() {
     override fun onResume() {
         super.onResume()
         displayName = sharedPreferences.getString(Preferences.DISPLAY_NAME, null)
-        setTitle(displayName)
+        setTitle(displayName, null)
+        prefetchToken()
+        val settings = settingsStore.settings.value
+        isGridMode = settings.bandwidthProfileMode == BandwidthProfileMode.GRID.name
+        // The settings may have changed how every slice renders
+        renderedViewState = null
+        videoSinkController.contentPreferencesController.isManualContentPreferencesEnabled =
+                settings.videoContentPreferencesMode == VideoContentPreferencesMode.MANUAL.name
         roomViewModel.processInput(OnResume)
+        updateStatsSubscription()
+        if (isDebugLoggingEnabled) {
+            binding.nativeMemoryOverlay.visibility = View.VISIBLE
+            nativeMemoryOverlayUpdate.run()
+        }
     }
 
     override fun onPause() {
         super.onPause()
+        binding.root.removeCallbacks(nativeMemoryOverlayUpdate)
+        updateStatsSubscription(isActive = false)
         roomViewModel.processInput(OnPause)
     }
 
@@ -191,7 +253,10 @@ class RoomActivity : AppCompatActivity() {
         pauseVideoMenuItem = menu.findItem(R.id.pause_video_menu_item)
         pauseAudioMenuItem = menu.findItem(R.id.pause_audio_menu_item)
         screenCaptureMenuItem = menu.findItem(R.id.share_screen_menu_item)
+        switchRoomMenuItem = menu.findItem(R.id.switch_room_menu_item)
+        shareStatsMenuItem = menu.findItem(R.id.share_stats_menu_item)
         deviceMenuItem = menu.findItem(R.id.device_menu_item)
+        renderedViewState = null
 
         onStates(roomViewModel) { state ->
             if (state is RoomViewState) bindRoomViewState(state)
@@ -216,6 +281,14 @@ class RoomActivity : AppCompatActivity() {
                 }
                 true
             }
+            R.id.switch_room_menu_item -> {
+                displaySwitchRoomDialog()
+                true
+            }
+            R.id.share_stats_menu_item -> {
+                roomViewModel.processInput(ShareStats)
+                true
+            }
             R.id.device_menu_item -> {
                 displayAudioDeviceList()
                 true
@@ -293,15 +366,53 @@ class RoomActivity : AppCompatActivity() {
     private fun setupThumbnailRecyclerView() {
         val layoutManager = LinearLayoutManager(this, LinearLayoutManager.HORIZONTAL, false)
         binding.room.remoteVideoThumbnails.layoutManager = layoutManager
-        participantAdapter = ParticipantAdapter()
+        participantAdapter = ParticipantAdapter(videoSinkController)
         participantAdapter
                 .viewHolderEvents
                 .observe(this, { viewEvent: RoomViewEvent -> roomViewModel.processInput(viewEvent) })
         binding.room.remoteVideoThumbnails.adapter = participantAdapter
+        participantGridController = ParticipantGridController(binding.room, videoSinkController)
+        participantGridController
+                .viewHolderEvents
+                .observe(this, { viewEvent: RoomViewEvent -> roomViewModel.processInput(viewEvent) })
+    }
+
+    private fun setupStatsRecyclerView() {
+        statsListAdapter = StatsListAdapter(this)
+        binding.statsRecyclerView.adapter = statsListAdapter
+        binding.statsRecyclerView.layoutManager = LinearLayoutManager(this)
+    }
+
+    private fun setupStatsDrawer() {
+        binding.navigationDrawer.addDrawerListener(object : DrawerLayout.SimpleDrawerListener() {
+            override fun onDrawerOpened(drawerView: View) = updateStatsSubscription()
+
+            override fun onDrawerClosed(drawerView: View) = updateStatsSubscription()
+        })
+    }
+
+    /*
+     * Stats are only polled at the foreground rate while the stats drawer is open.
+     */
+    private fun updateStatsSubscription(isActive: Boolean = true) {
+        val subscribe = isActive && settingsStore.settings.value.enableStats &&
+                binding.navigationDrawer.isDrawerOpen(GravityCompat.END)
+        if (subscribe != isStatsSubscribed) {
+            isStatsSubscribed = subscribe
+            roomViewModel.processInput(if (subscribe) SubscribeToStats else UnsubscribeFromStats)
+        }
     }
 
     private fun roomNameTextChanged(text: CharSequence?) {
         binding.joinRoom.connect.isEnabled = !TextUtils.isEmpty(text)
+        prefetchToken()
+    }
+
+    private fun prefetchToken() {
+        val identity = displayName ?: return
+        if ((roomViewModel.getState() as? RoomViewState)?.configuration !is Lobby) return
+        val roomName = binding.joinRoom.roomName.text?.toString()
+        if (!roomName.isNullOrEmpty()) roomViewModel.processInput(PrefetchToken(identity, roomName))
     }
 
     private fun connectButtonClick() {
@@ -358,6 +469,7 @@ class RoomActivity : AppCompatActivity() {
         var connectButtonEnabled = isRoomTextNotEmpty
         var roomName = displayName
         var toolbarTitle = displayName
+        var toolbarSubtitle: String? = null
         var joinStatus = ""
         var recordingWarningVisibility = View.GONE
         when (roomViewState.configuration) {
@@ -382,6 +494,7 @@ class RoomActivity : AppCompatActivity() {
                 connectButtonEnabled = false
                 roomName = roomViewState.title
                 toolbarTitle = roomName
+                if (roomViewState.isReconnecting) toolbarSubtitle = getString(R.string.room_screen_reconnecting)
                 joinStatus = ""
                 binding.recordingIndicator.visibility =
                         if (roomViewState.isRecording) View.VISIBLE else View.GONE
@@ -401,14 +514,11 @@ class RoomActivity : AppCompatActivity() {
         val videoDrawable = if (roomViewState.isVideoOff || !isLocalMediaEnabled) R.drawable.ic_videocam_off_gray_24px else R.drawable.ic_videocam_white_24px
         binding.localAudio.setImageResource(micDrawable)
         binding.localVideo.setImageResource(videoDrawable)
-        statsListAdapter = StatsListAdapter(this)
-        binding.statsRecyclerView.adapter = statsListAdapter
-        binding.statsRecyclerView.layoutManager = LinearLayoutManager(this)
         binding.disconnect.visibility = disconnectButtonState
         binding.joinRoom.joinRoomLayout.visibility = joinRoomLayoutState
         binding.joinStatusLayout.visibility = joinStatusLayoutState
         binding.joinRoom.connect.isEnabled = connectButtonEnabled
-        setTitle(toolbarTitle)
+        setTitle(toolbarTitle, toolbarSubtitle)
         binding.joinStatus.text = joinStatus
         binding.joinRoomName.text = roomName
         binding.recordingNotice.visibility = recordingWarningVisibility
@@ -420,6 +530,8 @@ class RoomActivity : AppCompatActivity() {
         // TODO: Remove when we use a Service to obtainTokenAndConnect to a room
         settingsMenuItem.isVisible = settingsMenuItemState
         screenCaptureMenuItem.isVisible = screenCaptureMenuItemState
+        switchRoomMenuItem.isVisible = roomViewState.configuration == RoomViewConfiguration.Connected
+        shareStatsMenuItem.isVisible = roomViewState.configuration == RoomViewConfiguration.Connected
         val screenCaptureResources = if (roomViewState.isScreenCaptureOn) {
             R.drawable.ic_stop_screen_share_white_24dp to getString(R.string.stop_screen_share)
         } else {
@@ -430,10 +542,11 @@ class RoomActivity : AppCompatActivity() {
         screenCaptureMenuItem.title = screenCaptureResources.second
     }
 
-    private fun setTitle(toolbarTitle: String?) {
+    private fun setTitle(toolbarTitle: String?, toolbarSubtitle: String?) {
         val actionBar = supportActionBar
         if (actionBar != null) {
             actionBar.title = toolbarTitle
+            actionBar.subtitle = toolbarSubtitle
         }
     }
 
@@ -459,9 +572,7 @@ class RoomActivity : AppCompatActivity() {
     }
 
     private fun updateStatsUI(roomViewState: RoomViewState) {
-        val enableStats = sharedPreferences.getBoolean(
-                Preferences.ENABLE_STATS, Preferences.ENABLE_STATS_DEFAULT)
-        if (enableStats) {
+        if (settingsStore.settings.value.enableStats) {
             when (roomViewState.configuration) {
                 RoomViewConfiguration.Connected -> {
                     statsListAdapter.updateStatsData(roomViewState.roomStats)
@@ -500,13 +611,44 @@ class RoomActivity : AppCompatActivity() {
         roomViewModel.processInput(viewEvent)
     }
 
+    /*
+     * Only the slices that changed since the last rendered state are rendered again, so that e.g. a
+     * stats update does not rebind the primary view and the thumbnails.
+     */
     private fun bindRoomViewState(roomViewState: RoomViewState) {
-        deviceMenuItem.isVisible = roomViewState.availableAudioDevices?.isNotEmpty() ?: false
-        renderPrimaryView(roomViewState.primaryParticipant)
-        renderThumbnails(roomViewState)
-        updateLayout(roomViewState)
-        updateAudioDeviceIcon(roomViewState.selectedDevice)
-        updateStatsUI(roomViewState)
+        val changedSlices = changedRoomViewSlices(renderedViewState, roomViewState)
+        renderedViewState = roomViewState
+        // Follows the options the room was connected with, not the current settings
+        videoSinkController.isManualSwitchOffEnabled = roomViewState.isManualSwitchOffEnabled
+        val isGridShown = isGridMode &&
+                roomViewState.configuration is RoomViewConfiguration.Connected
+        val qualityLevel = roomViewState.qualityLevel
+        val isLowBandwidth = roomViewState.isLowBandwidth
+        if (RoomViewSlice.PRIMARY_VIEW in changedSlices || RoomViewSlice.THUMBNAILS in changedSlices) {
+            videoSinkController.contentPreferencesController.maxRenderDimensions =
+                    if (qualityLevel >= QualityLevel.REDUCED_SUBSCRIPTION || isLowBandwidth) {
+                        REDUCED_SUBSCRIPTION_VIDEO_DIMENSIONS
+                    } else null
+        }
+        if (RoomViewSlice.PRIMARY_VIEW in changedSlices) {
+            if (isGridShown) {
+                primaryParticipantController.clear()
+            } else {
+                renderPrimaryView(roomViewState.primaryParticipant,
+                        isVideoShown = qualityLevel < QualityLevel.AUDIO_ONLY &&
+                                (!isLowBandwidth || roomViewState.isDominantSpeakerVideoKept))
+            }
+        }
+        if (RoomViewSlice.THUMBNAILS in changedSlices) {
+            renderThumbnails(roomViewState, isGridShown,
+                    isVideoShown = qualityLevel < QualityLevel.NO_THUMBNAILS && !isLowBandwidth)
+        }
+        if (RoomViewSlice.CONTROLS in changedSlices) {
+            deviceMenuItem.isVisible = roomViewState.availableAudioDevices?.isNotEmpty() ?: false
+            updateLayout(roomViewState)
+            updateAudioDeviceIcon(roomViewState.selectedDevice)
+        }
+        if (RoomViewSlice.STATS in changedSlices) updateStatsUI(roomViewState)
     }
 
     private fun bindRoomViewEffects(roomViewEffect: RoomViewEffect) {
@@ -532,9 +674,18 @@ class RoomActivity : AppCompatActivity() {
                 handleTokenError(error)
             }
             PermissionsDenied -> requestPermissions()
+            is ShowStatsShareSheet -> shareStats(roomViewEffect.csv)
         }
     }
 
+    private fun shareStats(csv: String) {
+        val intent = Intent(Intent.ACTION_SEND)
+                .setType("text/csv")
+                .putExtra(Intent.EXTRA_SUBJECT, getString(R.string.share_stats_subject))
+                .putExtra(Intent.EXTRA_TEXT, csv)
+        startActivity(Intent.createChooser(intent, getString(R.string.share_stats)))
+    }
+
     private fun getConnectFailureMessage(roomViewEffect: RoomViewEffect) =
             getString(
                     when (roomViewEffect) {
@@ -553,22 +704,36 @@ class RoomActivity : AppCompatActivity() {
         this.deviceMenuItem.setIcon(audioDeviceMenuIcon)
     }
 
-    private fun renderPrimaryView(primaryParticipant: ParticipantViewState) {
+    private fun renderPrimaryView(primaryParticipant: ParticipantViewState, isVideoShown: Boolean) {
         primaryParticipant.run {
             primaryParticipantController.renderAsPrimary(
                     if (isLocalParticipant) getString(R.string.you) else identity,
-                    screenTrack,
-                    videoTrack,
+                    screenTrack?.takeIf { isVideoShown },
+                    videoTrack?.takeIf { isVideoShown },
                     isMuted,
-                    isMirrored)
+                    isMirrored,
+                    isVideoDegraded)
             binding.room.primaryVideo.showIdentityBadge(!primaryParticipant.isLocalParticipant)
         }
     }
 
-    private fun renderThumbnails(roomViewState: RoomViewState) {
+    /*
+     * Thumbnails that do not show video are rendered without their tracks, which are then switched
+     * off like the tracks of any thumbnail that is not on screen.
+     */
+    private fun renderThumbnails(roomViewState: RoomViewState, isGridShown: Boolean, isVideoShown: Boolean) {
         val newThumbnails = if (roomViewState.configuration is RoomViewConfiguration.Connected)
             roomViewState.participantThumbnails else null
-        participantAdapter.submitList(newThumbnails)
+        val renderedThumbnails = if (isVideoShown) newThumbnails else newThumbnails?.map {
+            it.copy(videoTrack = null, screenTrack = null)
+        }
+        binding.room.primaryVideo.isVisible = !isGridShown
+        binding.room.remoteVideoThumbnails.isVisible = !isGridShown
+        participantAdapter.submitList(if (isGridShown) null else renderedThumbnails)
+        participantGridController.render(if (isGridShown) renderedThumbnails.orEmpty() else emptyList())
+        videoSinkController.retainTracks(newThumbnails.orEmpty().flatMapTo(HashSet()) {
+            listOfNotNull(it.videoTrack?.videoTrack, it.screenTrack?.videoTrack)
+        })
     }
 
     private fun displayAudioDeviceList() {
@@ -610,6 +775,35 @@ class RoomActivity : AppCompatActivity() {
         return builder.create()
     }
 
+    /*
+     * The call stays in its room until the other one is joined, see RoomManager.switchRoom. The
+     * typed room is preconnected meanwhile and dropped again if the dialog is cancelled.
+     */
+    private fun displaySwitchRoomDialog() {
+        val roomNameInput = EditText(this).apply {
+            hint = getString(R.string.room_name)
+            isSingleLine = true
+            doOnTextChanged { text, _, _, _ ->
+                val roomName = text?.toString()?.trim()
+                roomViewModel.processInput(if (roomName.isNullOrEmpty()) CancelPreconnect
+                        else PreconnectRoom(roomName))
+            }
+        }
+        AlertDialog.Builder(this, R.style.AppTheme_Dialog)
+                .setTitle(getString(R.string.switch_room))
+                .setView(roomNameInput)
+                .setPositiveButton(getString(R.string.switch_room_confirm)) { _, _ ->
+                    val roomName = roomNameInput.text.toString().trim()
+                    roomViewModel.processInput(if (roomName.isNotEmpty()) SwitchRoom(roomName)
+                            else CancelPreconnect)
+                }
+                .setNegativeButton(getString(android.R.string.cancel)) { _, _ ->
+                    roomViewModel.processInput(CancelPreconnect)
+                }
+                .setOnCancelListener { roomViewModel.processInput(CancelPreconnect) }
+                .show()
+    }
+
     private fun handleTokenError(error: AuthServiceError?) {
         val errorMessage = if (error === AuthServiceError.EXPIRED_PASSCODE_ERROR) R.string.room_screen_token_expired_message else R.string.room_screen_token_retrieval_failure_message
         AlertDialog.Builder(this, R.style.AppTheme_Dialog)
@@ -622,6 +816,7 @@ class RoomActivity : AppCompatActivity() {
     companion object {
         private const val PERMISSIONS_REQUEST_CODE = 100
         private const val MEDIA_PROJECTION_REQUEST_CODE = 101
+        private const val NATIVE_MEMORY_OVERLAY_INTERVAL_MILLIS = 1000L
 
         // This will be used instead of real local participant sid,
         // because that information is unknown until room connection is fully established
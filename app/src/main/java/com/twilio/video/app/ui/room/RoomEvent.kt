@@ -5,6 +5,7 @@ import com.twilio.video.Participant
 import com.twilio.video.Room
 import com.twilio.video.VideoTrack
 import com.twilio.video.app.data.api.AuthServiceError
+import com.twilio.video.app.sdk.QualityLevel
 import com.twilio.video.app.sdk.RoomStats
 
 sealed class RoomEvent {
@@ -13,16 +14,32 @@ sealed class RoomEvent {
     data class Connected(
         val participants: List<Participant>,
         val room: Room,
-        val roomName: String
+        val roomName: String,
+        /** The call moved to [room] from another room, see [com.twilio.video.app.sdk.RoomManager.switchRoom]. */
+        val isRoomSwitch: Boolean = false,
+        /** The room was connected with [com.twilio.video.ClientTrackSwitchOffControl.MANUAL]. */
+        val isManualSwitchOffEnabled: Boolean = false
     ) : RoomEvent()
     object Disconnected : RoomEvent()
+    /** The room is lost, the view keeps its layout until [Reconnected] or [Connected] follows. */
+    object Reconnecting : RoomEvent()
+    object Reconnected : RoomEvent()
     object ConnectFailure : RoomEvent()
     object MaxParticipantFailure : RoomEvent()
+    /** The call could not move to [roomName] and stays in its room. */
+    data class RoomSwitchFailure(val roomName: String) : RoomEvent()
     object RecordingStarted : RoomEvent()
     object RecordingStopped : RoomEvent()
     data class TokenError(val serviceError: AuthServiceError? = null) : RoomEvent()
     data class DominantSpeakerChanged(val newDominantSpeakerSid: String?) : RoomEvent()
+    /** See [com.twilio.video.app.sdk.SpeakerPrediction]. */
+    data class SpeakerPredicted(val speakerSid: String?, val nextSpeakerSid: String?) : RoomEvent()
     data class StatsUpdate(val roomStats: RoomStats) : RoomEvent()
+    data class QualityLevelChanged(val qualityLevel: QualityLevel) : RoomEvent()
+    data class LowBandwidthModeChanged(
+        val isLowBandwidth: Boolean,
+        val isDominantSpeakerVideoKept: Boolean
+    ) : RoomEvent()
 
     sealed class RemoteParticipantEvent : RoomEvent() {
 
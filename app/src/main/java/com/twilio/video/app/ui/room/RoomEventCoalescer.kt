@@ -0,0 +1,145 @@
+package com.twilio.video.app.ui.room
+
+import com.twilio.video.app.ui.room.RoomEvent.DominantSpeakerChanged
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.MuteRemoteParticipant
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.NetworkQualityLevelChange
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParticipantConnected
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParticipantDisconnected
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.ScreenTrackUpdated
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.TrackSwitchOff
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.VideoTrackUpdated
+import com.twilio.video.app.ui.room.RoomEvent.SpeakerPredicted
+import com.twilio.video.app.ui.room.RoomEvent.StatsUpdate
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.android.awaitFrame
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.channelFlow
+import kotlinx.coroutines.flow.collect
+import kotlinx.coroutines.flow.map
+import kotlinx.coroutines.launch
+
+/** Determines how long [RoomEvent]s are gathered before they are handed over as one batch. */
+sealed class RoomEventPacing {
+    /** Every event is delivered on its own. */
+    object Immediate : RoomEventPacing()
+    /** Events are gathered until the next Choreographer frame. */
+    object Frame : RoomEventPacing()
+    /** Events are gathered for a fixed window starting with the first event of the batch. */
+    data class Window(val windowMillis: Long) : RoomEventPacing()
+}
+
+/**
+ * @param events the events of the batch in the order they were sent.
+ * @param mergedCount the number of events dropped because a later event of the batch superseded them
+ * or their participant had disconnected.
+ */
+data class RoomEventBatch(val events: List<RoomEvent>, val mergedCount: Int = 0)
+
+/**
+ * Batches the [RoomEvent]s sent by [com.twilio.video.app.sdk.RoomManager] so that a burst of SDK
+ * callbacks results in a single view state change. Within a batch only the last event of a kind
+ * survives for a given participant, e.g. only the last [NetworkQualityLevelChange] of a sid, and
+ * none survive the [RemoteParticipantDisconnected] of the participant.
+ */
+class RoomEventCoalescer(private val pacing: RoomEventPacing) {
+
+    /** Total number of events merged away since this coalescer was created. */
+    var mergedEventCount = 0L
+        private set
+
+    /*
+     * The pending events are shared between the collector and the flush job without
+     * synchronization, so the returned flow has to be collected on a single threaded dispatcher
+     * such as the view model scope.
+     */
+    fun coalesce(roomEvents: Flow<RoomEvent>): Flow<RoomEventBatch> =
+            if (pacing is RoomEventPacing.Immediate) {
+                roomEvents.map { RoomEventBatch(listOf(it)) }
+            } else {
+                channelFlow {
+                    val pendingEvents = mutableListOf<RoomEvent>()
+                    var flushJob: Job? = null
+                    roomEvents.collect { roomEvent ->
+                        pendingEvents.add(roomEvent)
+                        if (flushJob == null) {
+                            flushJob = launch {
+                                awaitFlush()
+                                val events = compact(pendingEvents)
+                                val mergedCount = pendingEvents.size - events.size
+                                pendingEvents.clear()
+                                flushJob = null
+                                mergedEventCount += mergedCount
+                                send(RoomEventBatch(events, mergedCount))
+                            }
+                        }
+                    }
+                }
+            }
+
+    private suspend fun awaitFlush() {
+        when (pacing) {
+            RoomEventPacing.Frame -> awaitFrame()
+            is RoomEventPacing.Window -> delay(pacing.windowMillis)
+            RoomEventPacing.Immediate -> Unit
+        }
+    }
+
+    /*
+     * Superseded events are dropped from the end of the batch backwards, so the remaining events
+     * keep their order. A disconnect ends the events of its participant: the ones before it are
+     * superseded, and the ones after it until the participant connects again would bring back a
+     * tile that was removed.
+     */
+    internal fun compact(roomEvents: List<RoomEvent>): List<RoomEvent> {
+        val isStale = BooleanArray(roomEvents.size)
+        val departedSids = HashSet<String>()
+        roomEvents.forEachIndexed { index, roomEvent ->
+            when (roomEvent) {
+                is RemoteParticipantConnected -> departedSids.remove(roomEvent.participant.sid)
+                is RemoteParticipantDisconnected -> departedSids.add(roomEvent.sid)
+                else -> isStale[index] = participantSid(roomEvent) in departedSids
+            }
+        }
+        val supersededKeys = HashSet<SupersedeKey>()
+        val leavingSids = HashSet<String>()
+        val compactedEvents = ArrayList<RoomEvent>(roomEvents.size)
+        for (index in roomEvents.indices.reversed()) {
+            val roomEvent = roomEvents[index]
+            when (roomEvent) {
+                is RemoteParticipantConnected -> leavingSids.remove(roomEvent.participant.sid)
+                is RemoteParticipantDisconnected -> leavingSids.add(roomEvent.sid)
+                else -> if (isStale[index] || participantSid(roomEvent) in leavingSids) continue
+            }
+            val key = supersedeKey(roomEvent)
+            if (key == null || supersededKeys.add(key)) compactedEvents.add(roomEvent)
+        }
+        compactedEvents.reverse()
+        return compactedEvents
+    }
+
+    private fun participantSid(roomEvent: RoomEvent): String? = when (roomEvent) {
+        is NetworkQualityLevelChange -> roomEvent.sid
+        is MuteRemoteParticipant -> roomEvent.sid
+        is VideoTrackUpdated -> roomEvent.sid
+        is TrackSwitchOff -> roomEvent.sid
+        is ScreenTrackUpdated -> roomEvent.sid
+        else -> null
+    }
+
+    private fun supersedeKey(roomEvent: RoomEvent): SupersedeKey? = when (roomEvent) {
+        is NetworkQualityLevelChange -> SupersedeKey(Kind.NETWORK_QUALITY, roomEvent.sid)
+        is MuteRemoteParticipant -> SupersedeKey(Kind.MUTE, roomEvent.sid)
+        is VideoTrackUpdated -> SupersedeKey(Kind.VIDEO_TRACK, roomEvent.sid)
+        is TrackSwitchOff -> SupersedeKey(Kind.VIDEO_TRACK, roomEvent.sid)
+        is ScreenTrackUpdated -> SupersedeKey(Kind.SCREEN_TRACK, roomEvent.sid)
+        is DominantSpeakerChanged -> SupersedeKey(Kind.DOMINANT_SPEAKER, null)
+        is SpeakerPredicted -> SupersedeKey(Kind.PREDICTED_SPEAKER, null)
+        is StatsUpdate -> SupersedeKey(Kind.STATS, null)
+        else -> null
+    }
+
+    private enum class Kind { NETWORK_QUALITY, MUTE, VIDEO_TRACK, SCREEN_TRACK, DOMINANT_SPEAKER, PREDICTED_SPEAKER, STATS }
+
+    private data class SupersedeKey(val kind: Kind, val sid: String?)
+}
@@ -13,4 +13,7 @@ sealed class RoomViewEffect : UIEvent() {
     object ShowConnectFailureDialog : RoomViewEffect()
     object ShowMaxParticipantFailureDialog : RoomViewEffect()
     data class ShowTokenErrorDialog(val serviceError: AuthServiceError? = null) : RoomViewEffect()
+
+    /** The track stats of the room as CSV, see [com.twilio.video.app.sdk.RoomManager.exportStats]. */
+    data class ShowStatsShareSheet(val csv: String) : RoomViewEffect()
 }
@@ -2,6 +2,7 @@ package com.twilio.video.app.ui.room
 
 import android.content.Intent
 import com.twilio.audioswitch.AudioDevice
+import com.twilio.video.VideoTrack
 
 sealed class RoomViewEvent {
     object OnResume : RoomViewEvent()
@@ -18,9 +19,17 @@ sealed class RoomViewEvent {
     data class SelectAudioDevice(val device: AudioDevice) : RoomViewEvent()
     object ActivateAudioDevice : RoomViewEvent()
     object DeactivateAudioDevice : RoomViewEvent()
+    data class PrefetchToken(val identity: String, val roomName: String) : RoomViewEvent()
     data class Connect(val identity: String, val roomName: String) : RoomViewEvent()
+    data class PreconnectRoom(val roomName: String) : RoomViewEvent()
+    object CancelPreconnect : RoomViewEvent()
+    data class SwitchRoom(val roomName: String) : RoomViewEvent()
     data class PinParticipant(val sid: String) : RoomViewEvent()
     data class VideoTrackRemoved(val sid: String) : RoomViewEvent()
     data class ScreenTrackRemoved(val sid: String) : RoomViewEvent()
+    data class RenderQualityChanged(val videoTrack: VideoTrack, val quality: RenderQuality) : RoomViewEvent()
+    object SubscribeToStats : RoomViewEvent()
+    object UnsubscribeFromStats : RoomViewEvent()
+    object ShareStats : RoomViewEvent()
     object Disconnect : RoomViewEvent()
 }
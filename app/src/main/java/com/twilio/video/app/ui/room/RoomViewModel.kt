@@ -12,6 +12,7 @@ import com.twilio.video.Participant
 import com.twilio.video.app.participant.ParticipantManager
 import com.twilio.video.app.participant.buildParticipantViewState
 import com.twilio.video.app.sdk.RoomManager
+import com.twilio.video.app.sdk.RoomStats
 import com.twilio.video.app.sdk.VideoTrackViewState
 import com.twilio.video.app.ui.room.RoomEvent.ConnectFailure
 import com.twilio.video.app.ui.room.RoomEvent.Connected
@@ -28,6 +29,10 @@ import com.twilio.video.app.ui.room.RoomEvent.LocalParticipantEvent.ScreenCaptur
 import com.twilio.video.app.ui.room.RoomEvent.LocalParticipantEvent.VideoDisabled
 import com.twilio.video.app.ui.room.RoomEvent.LocalParticipantEvent.VideoEnabled
 import com.twilio.video.app.ui.room.RoomEvent.MaxParticipantFailure
+import com.twilio.video.app.ui.room.RoomEvent.LowBandwidthModeChanged
+import com.twilio.video.app.ui.room.RoomEvent.QualityLevelChanged
+import com.twilio.video.app.ui.room.RoomEvent.Reconnected
+import com.twilio.video.app.ui.room.RoomEvent.Reconnecting
 import com.twilio.video.app.ui.room.RoomEvent.RecordingStarted
 import com.twilio.video.app.ui.room.RoomEvent.RecordingStopped
 import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent
@@ -37,15 +42,20 @@ import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParti
 import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParticipantDisconnected
 import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.ScreenTrackUpdated
 import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.TrackSwitchOff
+import com.twilio.video.app.ui.room.RoomEvent.RoomSwitchFailure
+import com.twilio.video.app.ui.room.RoomEvent.SpeakerPredicted
 import com.twilio.video.app.ui.room.RoomEvent.StatsUpdate
 import com.twilio.video.app.ui.room.RoomEvent.TokenError
 import com.twilio.video.app.ui.room.RoomViewConfiguration.Lobby
 import com.twilio.video.app.ui.room.RoomViewEffect.PermissionsDenied
 import com.twilio.video.app.ui.room.RoomViewEffect.ShowConnectFailureDialog
 import com.twilio.video.app.ui.room.RoomViewEffect.ShowMaxParticipantFailureDialog
+import com.twilio.video.app.ui.room.RoomViewEffect.ShowStatsShareSheet
 import com.twilio.video.app.ui.room.RoomViewEffect.ShowTokenErrorDialog
 import com.twilio.video.app.ui.room.RoomViewEvent.ActivateAudioDevice
+import com.twilio.video.app.ui.room.RoomViewEvent.CancelPreconnect
 import com.twilio.video.app.ui.room.RoomViewEvent.Connect
+import com.twilio.video.app.ui.room.RoomViewEvent.PrefetchToken
 import com.twilio.video.app.ui.room.RoomViewEvent.DeactivateAudioDevice
 import com.twilio.video.app.ui.room.RoomViewEvent.DisableLocalAudio
 import com.twilio.video.app.ui.room.RoomViewEvent.DisableLocalVideo
@@ -55,37 +65,69 @@ import com.twilio.video.app.ui.room.RoomViewEvent.EnableLocalVideo
 import com.twilio.video.app.ui.room.RoomViewEvent.OnPause
 import com.twilio.video.app.ui.room.RoomViewEvent.OnResume
 import com.twilio.video.app.ui.room.RoomViewEvent.PinParticipant
+import com.twilio.video.app.ui.room.RoomViewEvent.PreconnectRoom
+import com.twilio.video.app.ui.room.RoomViewEvent.RenderQualityChanged
 import com.twilio.video.app.ui.room.RoomViewEvent.ScreenTrackRemoved
 import com.twilio.video.app.ui.room.RoomViewEvent.SelectAudioDevice
+import com.twilio.video.app.ui.room.RoomViewEvent.ShareStats
 import com.twilio.video.app.ui.room.RoomViewEvent.StartScreenCapture
 import com.twilio.video.app.ui.room.RoomViewEvent.StopScreenCapture
+import com.twilio.video.app.ui.room.RoomViewEvent.SubscribeToStats
 import com.twilio.video.app.ui.room.RoomViewEvent.SwitchCamera
+import com.twilio.video.app.ui.room.RoomViewEvent.SwitchRoom
 import com.twilio.video.app.ui.room.RoomViewEvent.ToggleLocalAudio
 import com.twilio.video.app.ui.room.RoomViewEvent.ToggleLocalVideo
+import com.twilio.video.app.ui.room.RoomViewEvent.UnsubscribeFromStats
 import com.twilio.video.app.ui.room.RoomViewEvent.VideoTrackRemoved
 import com.twilio.video.app.util.PermissionUtil
+import com.twilio.video.app.util.debugLog
+import dagger.Lazy
 import dagger.hilt.android.lifecycle.HiltViewModel
 import io.uniflow.android.AndroidDataFlow
+import io.uniflow.core.dispatcher.UniFlowDispatcher
 import io.uniflow.core.flow.data.UIState
 import io.uniflow.core.flow.onState
 import javax.inject.Inject
 import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.collect
 import kotlinx.coroutines.launch
 import timber.log.Timber
 
+const val TOKEN_PREFETCH_DELAY_MILLIS = 500L
+const val ROOM_PRECONNECT_DELAY_MILLIS = 1000L
+
+/*
+ * Room events are handled on the main thread, where the participant manager lives, and its
+ * immutable snapshots are handed to the reducers. The reducers copy RoomViewState on the default
+ * dispatcher, so the main thread only renders the slices that changed.
+ */
 @HiltViewModel
 class RoomViewModel @Inject constructor(
     private val roomManager: RoomManager,
-    private val audioSwitch: AudioSwitch,
+    /** Built once the permissions are granted, not while the room screen starts. */
+    private val lazyAudioSwitch: Lazy<AudioSwitch>,
     private val permissionUtil: PermissionUtil,
     private val participantManager: ParticipantManager = ParticipantManager(),
-    initialViewState: RoomViewState = RoomViewState(participantManager.primaryParticipant)
-) : AndroidDataFlow(defaultState = initialViewState) {
+    initialViewState: RoomViewState = RoomViewState(participantManager.primaryParticipant),
+    roomEventPacing: RoomEventPacing = RoomEventPacing.Frame
+) : AndroidDataFlow(
+        defaultState = initialViewState,
+        defaultDispatcher = UniFlowDispatcher.dispatcher.default()
+) {
 
     private var permissionCheckRetry = false
+    private var isAudioSwitchBuilt = false
+    private val audioSwitch: AudioSwitch
+        get() = lazyAudioSwitch.get().also { isAudioSwitchBuilt = true }
+    private val roomEventCoalescer = RoomEventCoalescer(roomEventPacing)
+    private var isParticipantViewStateStale = false
+    private var pendingRoomStats: RoomStats? = null
+    private var isReconnecting = false
     @VisibleForTesting(otherwise = PRIVATE)
     internal var roomManagerJob: Job? = null
+    private var tokenPrefetchJob: Job? = null
+    private var preconnectJob: Job? = null
 
     init {
         subscribeToRoomEvents()
@@ -94,12 +136,13 @@ class RoomViewModel @Inject constructor(
     @VisibleForTesting(otherwise = PROTECTED)
     public override fun onCleared() {
         super.onCleared()
-        audioSwitch.stop()
+        if (isAudioSwitchBuilt) audioSwitch.stop()
         roomManagerJob?.cancel()
+        roomManager.releaseIfIdle()
     }
 
     fun processInput(viewEvent: RoomViewEvent) {
-        Timber.d("View Event: $viewEvent")
+        debugLog { "View Event: $viewEvent" }
 
         when (viewEvent) {
             OnResume -> checkPermissions()
@@ -109,9 +152,20 @@ class RoomViewModel @Inject constructor(
             }
             ActivateAudioDevice -> { audioSwitch.activate() }
             DeactivateAudioDevice -> { audioSwitch.deactivate() }
+            is PrefetchToken -> prefetchToken(viewEvent.identity, viewEvent.roomName)
             is Connect -> {
+                tokenPrefetchJob?.cancel()
                 connect(viewEvent.identity, viewEvent.roomName)
             }
+            is PreconnectRoom -> preconnect(viewEvent.roomName)
+            CancelPreconnect -> {
+                preconnectJob?.cancel()
+                roomManager.cancelPreconnect()
+            }
+            is SwitchRoom -> {
+                preconnectJob?.cancel()
+                roomManager.switchRoom(viewEvent.roomName)
+            }
             is PinParticipant -> {
                 participantManager.changePinnedParticipant(viewEvent.sid)
                 updateParticipantViewState()
@@ -134,6 +188,16 @@ class RoomViewModel @Inject constructor(
                 participantManager.updateParticipantScreenTrack(viewEvent.sid, null)
                 updateParticipantViewState()
             }
+            is RenderQualityChanged -> {
+                if (viewEvent.quality == RenderQuality.FROZEN) roomManager.onRenderFreeze()
+                if (participantManager.updateRenderQuality(viewEvent.videoTrack,
+                                viewEvent.quality != RenderQuality.GOOD)) {
+                    updateParticipantViewState()
+                }
+            }
+            SubscribeToStats -> roomManager.subscribeToStats()
+            UnsubscribeFromStats -> roomManager.unsubscribeFromStats()
+            ShareStats -> action { sendEvent { ShowStatsShareSheet(roomManager.exportStats()) } }
             Disconnect -> roomManager.disconnect()
         }
     }
@@ -142,7 +206,7 @@ class RoomViewModel @Inject constructor(
         roomManager.roomEvents.let { sharedFlow ->
             roomManagerJob = viewModelScope.launch {
                 Timber.d("Listening for RoomEvents")
-                sharedFlow.collect { observeRoomEvents(it) }
+                roomEventCoalescer.coalesce(sharedFlow).collect { observeRoomEventBatch(it) }
             }
         }
     }
@@ -168,16 +232,44 @@ class RoomViewModel @Inject constructor(
             roomManager.onResume()
         } else {
             if (!permissionCheckRetry) {
-                action {
-                    sendEvent {
-                        permissionCheckRetry = true
-                        PermissionsDenied
-                    }
-                }
+                permissionCheckRetry = true
+                action { sendEvent { PermissionsDenied } }
             }
         }
     }
 
+    private fun observeRoomEventBatch(roomEventBatch: RoomEventBatch) {
+        if (roomEventBatch.mergedCount > 0) {
+            Timber.d("Merged %d superseded RoomEvents, %d merged in total",
+                    roomEventBatch.mergedCount, roomEventCoalescer.mergedEventCount)
+        }
+        roomEventBatch.events.forEach { observeRoomEvents(it) }
+        flushRoomEventBatch()
+    }
+
+    /*
+     * Participant and stats events only update the participant manager and the pending stats, the
+     * view state is updated once for the whole batch.
+     */
+    private fun flushRoomEventBatch() {
+        val roomStats = pendingRoomStats
+        if (!isParticipantViewStateStale && roomStats == null) return
+        val updateParticipants = isParticipantViewStateStale
+        isParticipantViewStateStale = false
+        pendingRoomStats = null
+        val participantThumbnails = participantManager.participantThumbnails
+        val primaryParticipant = participantManager.primaryParticipant
+        updateState { currentState ->
+            currentState.copy(
+                    participantThumbnails = if (updateParticipants) participantThumbnails
+                            else currentState.participantThumbnails,
+                    primaryParticipant = if (updateParticipants) primaryParticipant
+                            else currentState.primaryParticipant,
+                    roomStats = roomStats ?: currentState.roomStats
+            )
+        }
+    }
+
     private fun observeRoomEvents(roomEvent: RoomEvent) {
         Timber.d("observeRoomEvents: %s", roomEvent)
         when (roomEvent) {
@@ -185,36 +277,54 @@ class RoomViewModel @Inject constructor(
                 showConnectingViewState()
             }
             is Connected -> {
-                showConnectedViewState(roomEvent.roomName)
-                checkParticipants(roomEvent.participants)
-                action { sendEvent { RoomViewEffect.Connected(roomEvent.room) } }
+                val isRejoined = isReconnecting || roomEvent.isRoomSwitch
+                showConnectedViewState(roomEvent.roomName, roomEvent.isManualSwitchOffEnabled)
+                checkParticipants(roomEvent.participants, isRejoined)
+                if (!isRejoined) action { sendEvent { RoomViewEffect.Connected(roomEvent.room) } }
             }
             is Disconnected -> showLobbyViewState()
+            Reconnecting -> {
+                isReconnecting = true
+                updateState { currentState -> currentState.copy(isReconnecting = true) }
+            }
+            Reconnected -> {
+                isReconnecting = false
+                updateState { currentState -> currentState.copy(isReconnecting = false) }
+            }
             is DominantSpeakerChanged -> {
                 participantManager.changeDominantSpeaker(roomEvent.newDominantSpeakerSid)
-                updateParticipantViewState()
+                isParticipantViewStateStale = true
             }
-            is ConnectFailure -> action {
-                sendEvent {
-                    showLobbyViewState()
-                    ShowConnectFailureDialog
-                }
+            is SpeakerPredicted -> {
+                participantManager.changePredictedSpeaker(roomEvent.speakerSid, roomEvent.nextSpeakerSid)
+                isParticipantViewStateStale = true
             }
-            is MaxParticipantFailure -> action {
-                sendEvent { ShowMaxParticipantFailureDialog }
+            is ConnectFailure -> {
+                action { sendEvent { ShowConnectFailureDialog } }
                 showLobbyViewState()
             }
-            is TokenError -> action {
-                sendEvent {
-                    showLobbyViewState()
-                    ShowTokenErrorDialog(roomEvent.serviceError)
-                }
+            is RoomSwitchFailure -> action { sendEvent { ShowConnectFailureDialog } }
+            is MaxParticipantFailure -> {
+                action { sendEvent { ShowMaxParticipantFailureDialog } }
+                showLobbyViewState()
+            }
+            is TokenError -> {
+                action { sendEvent { ShowTokenErrorDialog(roomEvent.serviceError) } }
+                showLobbyViewState()
             }
             RecordingStarted -> updateState { currentState -> currentState.copy(isRecording = true) }
             RecordingStopped -> updateState { currentState -> currentState.copy(isRecording = false) }
             is RemoteParticipantEvent -> handleRemoteParticipantEvent(roomEvent)
             is LocalParticipantEvent -> handleLocalParticipantEvent(roomEvent)
-            is StatsUpdate -> updateState { currentState -> currentState.copy(roomStats = roomEvent.roomStats) }
+            is StatsUpdate -> pendingRoomStats = roomEvent.roomStats
+            is QualityLevelChanged -> {
+                participantManager.qualityLevel = roomEvent.qualityLevel
+                updateState { currentState -> currentState.copy(qualityLevel = roomEvent.qualityLevel) }
+            }
+            is LowBandwidthModeChanged -> updateState { currentState ->
+                currentState.copy(isLowBandwidth = roomEvent.isLowBandwidth,
+                        isDominantSpeakerVideoKept = roomEvent.isDominantSpeakerVideoKept)
+            }
         }
     }
 
@@ -224,32 +334,32 @@ class RoomViewModel @Inject constructor(
             is RemoteParticipantEvent.VideoTrackUpdated -> {
                 participantManager.updateParticipantVideoTrack(remoteParticipantEvent.sid,
                         remoteParticipantEvent.videoTrack?.let { VideoTrackViewState(it) })
-                updateParticipantViewState()
+                isParticipantViewStateStale = true
             }
             is TrackSwitchOff -> {
                 participantManager.updateParticipantVideoTrack(remoteParticipantEvent.sid,
                         VideoTrackViewState(remoteParticipantEvent.videoTrack,
                                 remoteParticipantEvent.switchOff))
-                updateParticipantViewState()
+                isParticipantViewStateStale = true
             }
             is ScreenTrackUpdated -> {
                 participantManager.updateParticipantScreenTrack(remoteParticipantEvent.sid,
                         remoteParticipantEvent.screenTrack?.let { VideoTrackViewState(it) })
-                updateParticipantViewState()
+                isParticipantViewStateStale = true
             }
             is MuteRemoteParticipant -> {
                 participantManager.muteParticipant(remoteParticipantEvent.sid,
                         remoteParticipantEvent.mute)
-                updateParticipantViewState()
+                isParticipantViewStateStale = true
             }
             is NetworkQualityLevelChange -> {
                 participantManager.updateNetworkQuality(remoteParticipantEvent.sid,
                         remoteParticipantEvent.networkQualityLevel)
-                updateParticipantViewState()
+                isParticipantViewStateStale = true
             }
             is RemoteParticipantDisconnected -> {
                 participantManager.removeParticipant(remoteParticipantEvent.sid)
-                updateParticipantViewState()
+                isParticipantViewStateStale = true
             }
         }
     }
@@ -276,13 +386,15 @@ class RoomViewModel @Inject constructor(
     private fun addParticipant(participant: Participant) {
         val participantViewState = buildParticipantViewState(participant)
         participantManager.addParticipant(participantViewState)
-        updateParticipantViewState()
+        isParticipantViewStateStale = true
     }
 
     private fun showLobbyViewState() {
+        isReconnecting = false
         action { sendEvent { RoomViewEffect.Disconnected } }
+        pendingRoomStats = null
         updateState { currentState ->
-            currentState.copy(configuration = Lobby)
+            currentState.copy(configuration = Lobby, roomStats = null)
         }
         participantManager.clearRemoteParticipants()
         updateParticipantViewState()
@@ -294,32 +406,68 @@ class RoomViewModel @Inject constructor(
         }
     }
 
-    private fun showConnectedViewState(roomName: String) {
+    private fun showConnectedViewState(roomName: String, isManualSwitchOffEnabled: Boolean) {
         updateState { currentState ->
-            currentState.copy(configuration = RoomViewConfiguration.Connected, title = roomName)
+            currentState.copy(configuration = RoomViewConfiguration.Connected, title = roomName,
+                    isReconnecting = false, isManualSwitchOffEnabled = isManualSwitchOffEnabled)
         }
     }
 
-    private fun checkParticipants(participants: List<Participant>) {
-        for ((index, participant) in participants.withIndex()) {
-            if (index == 0) { // local participant
-                participantManager.updateLocalParticipantSid(participant.sid)
-            } else {
-                participantManager.addParticipant(buildParticipantViewState(participant))
-            }
+    /** A rejoined room keeps the layout of the participants that are still in it. */
+    private fun checkParticipants(participants: List<Participant>, isRejoined: Boolean = false) {
+        participantManager.updateLocalParticipantSid(participants.first().sid)
+        val remoteParticipants = participants.drop(1).map { buildParticipantViewState(it) }
+        if (isRejoined) {
+            participantManager.rejoinRemoteParticipants(remoteParticipants)
+        } else {
+            remoteParticipants.forEach { participantManager.addParticipant(it) }
         }
         updateParticipantViewState()
     }
 
+    /*
+     * The participant manager is only touched on the main thread. Its state is read before the
+     * action is queued, so the reducer stays pure when uniflow runs it on its action dispatcher.
+     */
     private fun updateParticipantViewState() {
+        val participantThumbnails = participantManager.participantThumbnails
+        val primaryParticipant = participantManager.primaryParticipant
+        if (roomManager.isTrackSubscriptionScheduled) {
+            roomManager.updateSubscriptionPriorities(primaryParticipant.sid,
+                    participantThumbnails.map { it.sid })
+        }
         updateState { currentState ->
             currentState.copy(
-                    participantThumbnails = participantManager.participantThumbnails,
-                    primaryParticipant = participantManager.primaryParticipant
+                    participantThumbnails = participantThumbnails,
+                    primaryParticipant = primaryParticipant
             )
         }
     }
 
+    /*
+     * The prefetch waits for the room name to stop changing so that typing a room name does not
+     * request a token per keystroke.
+     */
+    private fun prefetchToken(identity: String, roomName: String) {
+        tokenPrefetchJob?.cancel()
+        tokenPrefetchJob = viewModelScope.launch {
+            delay(TOKEN_PREFETCH_DELAY_MILLIS)
+            roomManager.prefetchToken(identity, roomName)
+        }
+    }
+
+    /*
+     * The room typed in the switch room dialog is connected on standby once the name stops
+     * changing, so that confirming the switch does not wait for the room to be joined.
+     */
+    private fun preconnect(roomName: String) {
+        preconnectJob?.cancel()
+        preconnectJob = viewModelScope.launch {
+            delay(ROOM_PRECONNECT_DELAY_MILLIS)
+            roomManager.preconnect(roomName)
+        }
+    }
+
     private fun connect(identity: String, roomName: String) =
             viewModelScope.launch {
                 roomManager.connect(
@@ -333,7 +481,7 @@ class RoomViewModel @Inject constructor(
     @Suppress("UNCHECKED_CAST")
     class RoomViewModelFactory(
         private val roomManager: RoomManager,
-        private val audioDeviceSelector: AudioSwitch,
+        private val audioDeviceSelector: Lazy<AudioSwitch>,
         private val permissionUtil: PermissionUtil
     ) : ViewModelProvider.Factory {
 
@@ -27,6 +27,11 @@ class RoomViewModelModule {
     @ViewModelScoped
     fun providesInitialViewState(participantManager: ParticipantManager) = RoomViewState(participantManager.primaryParticipant)
 
+    @Provides
+    @ViewModelScoped
+    fun providesRoomEventPacing(): RoomEventPacing = RoomEventPacing.Frame
+
+    /* AudioSwitch registers for the audio devices as it is built, so RoomViewModel takes a dagger.Lazy of it. */
     @Provides
     @ViewModelScoped
     fun providesAudioSwitch(application: Application): AudioSwitch =
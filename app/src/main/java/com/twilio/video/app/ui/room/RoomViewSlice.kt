@@ -0,0 +1,49 @@
+package com.twilio.video.app.ui.room
+
+import java.util.EnumSet
+
+/** The parts of a [RoomViewState] that [RoomActivity] renders independently of each other. */
+enum class RoomViewSlice {
+    PRIMARY_VIEW,
+    THUMBNAILS,
+    STATS,
+    /** The toolbar, the menu, the join layout and the local media buttons. */
+    CONTROLS
+}
+
+/**
+ * Returns the slices that have to be rendered again when [newState] replaces [oldState], or every
+ * slice without an [oldState]. The participant states are shared between the snapshots of the
+ * [com.twilio.video.app.participant.ParticipantManager], so unchanged participants compare by
+ * reference. Any property that is not part of another slice belongs to [RoomViewSlice.CONTROLS].
+ */
+fun changedRoomViewSlices(oldState: RoomViewState?, newState: RoomViewState): Set<RoomViewSlice> {
+    if (oldState == null) return EnumSet.allOf(RoomViewSlice::class.java)
+    val changedSlices = EnumSet.noneOf(RoomViewSlice::class.java)
+    if (oldState === newState) return changedSlices
+    val isConfigurationChanged = oldState.configuration != newState.configuration
+    val isQualityChanged = oldState.qualityLevel != newState.qualityLevel ||
+            oldState.isLowBandwidth != newState.isLowBandwidth
+    if (isConfigurationChanged || isQualityChanged ||
+            oldState.isDominantSpeakerVideoKept != newState.isDominantSpeakerVideoKept ||
+            oldState.primaryParticipant != newState.primaryParticipant) {
+        changedSlices.add(RoomViewSlice.PRIMARY_VIEW)
+    }
+    val areThumbnailsChanged = oldState.participantThumbnails != newState.participantThumbnails
+    if (isConfigurationChanged || isQualityChanged || areThumbnailsChanged) {
+        changedSlices.add(RoomViewSlice.THUMBNAILS)
+    }
+    if (isConfigurationChanged || oldState.roomStats != newState.roomStats ||
+            (areThumbnailsChanged && oldState.participantThumbnails?.size != newState.participantThumbnails?.size)) {
+        changedSlices.add(RoomViewSlice.STATS)
+    }
+    val controls = newState.copy(
+            primaryParticipant = oldState.primaryParticipant,
+            participantThumbnails = oldState.participantThumbnails,
+            roomStats = oldState.roomStats,
+            qualityLevel = oldState.qualityLevel,
+            isLowBandwidth = oldState.isLowBandwidth,
+            isDominantSpeakerVideoKept = oldState.isDominantSpeakerVideoKept)
+    if (controls != oldState) changedSlices.add(RoomViewSlice.CONTROLS)
+    return changedSlices
+}
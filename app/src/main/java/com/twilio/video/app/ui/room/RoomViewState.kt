@@ -2,6 +2,7 @@ package com.twilio.video.app.ui.room
 
 import com.twilio.audioswitch.AudioDevice
 import com.twilio.video.app.participant.ParticipantViewState
+import com.twilio.video.app.sdk.QualityLevel
 import com.twilio.video.app.sdk.RoomStats
 import com.twilio.video.app.sdk.VideoTrackViewState
 import com.twilio.video.app.ui.room.RoomViewConfiguration.Lobby
@@ -23,7 +24,13 @@ data class RoomViewState(
     val isVideoOff: Boolean = false,
     val isScreenCaptureOn: Boolean = false,
     val isRecording: Boolean = false,
-    val roomStats: RoomStats? = null
+    val isReconnecting: Boolean = false,
+    val roomStats: RoomStats? = null,
+    val qualityLevel: QualityLevel = QualityLevel.FULL,
+    val isLowBandwidth: Boolean = false,
+    val isDominantSpeakerVideoKept: Boolean = true,
+    /** The tracks no view renders are switched off by the app, see [VideoSinkController]. */
+    val isManualSwitchOffEnabled: Boolean = false
 ) : UIState()
 
 sealed class RoomViewConfiguration {
@@ -0,0 +1,115 @@
+package com.twilio.video.app.ui.room
+
+import android.view.View
+import com.twilio.video.RemoteVideoTrack
+import com.twilio.video.VideoContentPreferences
+import com.twilio.video.VideoDimensions
+import timber.log.Timber
+
+/** The render size requested for tracks that are prefetched without being rendered. */
+val PREFETCH_VIDEO_DIMENSIONS = VideoDimensions(160, 90)
+
+/** The largest render size requested from [com.twilio.video.app.sdk.QualityLevel.REDUCED_SUBSCRIPTION] on. */
+val REDUCED_SUBSCRIPTION_VIDEO_DIMENSIONS: VideoDimensions = VideoDimensions.VGA_VIDEO_DIMENSIONS
+
+/**
+ * Sends the pixel size a [RemoteVideoTrack] is rendered at as its content preferences so that
+ * thumbnails receive a small simulcast layer and the primary view the full one. The size of every
+ * view rendering a track is observed, so rotations and re-layouts update the preferences. A track
+ * rendered by several views prefers the largest of their sizes, and a prefetched track that no view
+ * renders prefers [PREFETCH_VIDEO_DIMENSIONS], i.e. the lowest simulcast layer. Render sizes above
+ * [maxRenderDimensions] are scaled down to fit.
+ *
+ * Content preferences only take effect if the room was connected with
+ * [com.twilio.video.VideoContentPreferencesMode.MANUAL], see [isManualContentPreferencesEnabled].
+ * Must only be used on the main thread.
+ */
+internal class VideoContentPreferencesController {
+
+    private val renderViews = HashMap<RemoteVideoTrack, MutableList<View>>()
+    private val layoutListeners = HashMap<View, View.OnLayoutChangeListener>()
+    private val sentDimensions = HashMap<RemoteVideoTrack, VideoDimensions>()
+    private val prefetchedTracks = HashSet<RemoteVideoTrack>()
+
+    var isManualContentPreferencesEnabled = false
+        set(value) {
+            if (field == value) return
+            field = value
+            sentDimensions.clear()
+            if (value) (renderViews.keys + prefetchedTracks).forEach { updateContentPreferences(it) }
+        }
+
+    var maxRenderDimensions: VideoDimensions? = null
+        set(value) {
+            if (field == value) return
+            field = value
+            sentDimensions.clear()
+            (renderViews.keys + prefetchedTracks).forEach { updateContentPreferences(it) }
+        }
+
+    fun onRenderStarted(videoTrack: RemoteVideoTrack, view: View) {
+        val views = renderViews.getOrPut(videoTrack) { ArrayList(2) }
+        if (view in views) return
+        views.add(view)
+        val layoutListener = View.OnLayoutChangeListener { _, left, top, right, bottom,
+            oldLeft, oldTop, oldRight, oldBottom ->
+            if (right - left != oldRight - oldLeft || bottom - top != oldBottom - oldTop) {
+                updateContentPreferences(videoTrack)
+            }
+        }
+        layoutListeners.put(view, layoutListener)?.let { view.removeOnLayoutChangeListener(it) }
+        view.addOnLayoutChangeListener(layoutListener)
+        updateContentPreferences(videoTrack)
+    }
+
+    fun onRenderStopped(videoTrack: RemoteVideoTrack, view: View) {
+        layoutListeners.remove(view)?.let { view.removeOnLayoutChangeListener(it) }
+        val views = renderViews[videoTrack] ?: return
+        views.remove(view)
+        if (views.isEmpty()) {
+            renderViews.remove(videoTrack)
+            if (videoTrack !in prefetchedTracks) {
+                sentDimensions.remove(videoTrack)
+                return
+            }
+        }
+        updateContentPreferences(videoTrack)
+    }
+
+    fun onPrefetchStarted(videoTrack: RemoteVideoTrack) {
+        if (prefetchedTracks.add(videoTrack)) updateContentPreferences(videoTrack)
+    }
+
+    fun onPrefetchStopped(videoTrack: RemoteVideoTrack) {
+        if (prefetchedTracks.remove(videoTrack) && videoTrack !in renderViews) {
+            sentDimensions.remove(videoTrack)
+        }
+    }
+
+    private fun updateContentPreferences(videoTrack: RemoteVideoTrack) {
+        if (!isManualContentPreferencesEnabled) return
+        val views = renderViews[videoTrack]
+        var width = if (views == null) PREFETCH_VIDEO_DIMENSIONS.width else 0
+        var height = if (views == null) PREFETCH_VIDEO_DIMENSIONS.height else 0
+        views?.forEach { view ->
+            width = maxOf(width, view.width)
+            height = maxOf(height, view.height)
+        }
+        // Views that have not been laid out yet are updated by their layout listener
+        if (width == 0 || height == 0) return
+        maxRenderDimensions?.let { maxDimensions ->
+            val scale = minOf(maxDimensions.width.toFloat() / width,
+                    maxDimensions.height.toFloat() / height)
+            if (scale < 1) {
+                width = (width * scale).toInt().coerceAtLeast(1)
+                height = (height * scale).toInt().coerceAtLeast(1)
+            }
+        }
+        val sent = sentDimensions[videoTrack]
+        if (sent != null && sent.width == width && sent.height == height) return
+        val renderDimensions = VideoDimensions(width, height)
+        sentDimensions[videoTrack] = renderDimensions
+        Timber.d("Rendering track %s at %s", videoTrack.sid, renderDimensions)
+        videoTrack.setContentPreferences(VideoContentPreferences(renderDimensions))
+    }
+}
@@ -0,0 +1,46 @@
+package com.twilio.video.app.ui.room
+
+import android.content.Context
+import android.util.AttributeSet
+import android.view.Gravity
+import android.view.ViewGroup.LayoutParams.WRAP_CONTENT
+import android.widget.FrameLayout
+import com.twilio.video.VideoTextureView
+
+/**
+ * Hosts the [VideoTextureView] a [VideoRendererPool] lends to a [ParticipantView], or the idle
+ * renderers of the pool. Renderers are moved between two attached layouts without being detached
+ * from the window because a [VideoTextureView] releases its EGL renderer when it is detached.
+ */
+internal class VideoRendererLayout @JvmOverloads constructor(
+    context: Context,
+    attrs: AttributeSet? = null,
+    defStyleAttr: Int = 0
+) : FrameLayout(context, attrs, defStyleAttr) {
+
+    val renderer: VideoTextureView?
+        get() = if (childCount > 0) getChildAt(0) as VideoTextureView else null
+
+    /** Moves [renderer] into this layout. Only the parking layout of a pool hosts several. */
+    fun adopt(renderer: VideoTextureView) {
+        val parent = renderer.parent as VideoRendererLayout?
+        if (parent === this) return
+        if (parent != null && parent.isAttachedToWindow && isAttachedToWindow) {
+            parent.detachRenderer(renderer)
+            attachViewToParent(renderer, childCount, rendererLayoutParams())
+            requestLayout()
+            invalidate()
+        } else {
+            parent?.removeView(renderer)
+            addView(renderer, rendererLayoutParams())
+        }
+    }
+
+    private fun detachRenderer(renderer: VideoTextureView) {
+        detachViewFromParent(renderer)
+        requestLayout()
+        invalidate()
+    }
+
+    private fun rendererLayoutParams() = LayoutParams(WRAP_CONTENT, WRAP_CONTENT, Gravity.CENTER)
+}
@@ -0,0 +1,70 @@
+package com.twilio.video.app.ui.room
+
+import android.content.Context
+import com.twilio.video.VideoTextureView
+import com.twilio.video.VideoTrack
+import timber.log.Timber
+
+const val MAX_VIDEO_RENDERERS = 12
+const val MAX_IDLE_VIDEO_RENDERERS = 4
+
+/**
+ * Lends [VideoTextureView]s to the [ParticipantView]s that render a video track so that the
+ * number of renderers, and therefore of EGL contexts and GPU buffers, is bounded by the views on
+ * screen instead of by the size of the room. Returned renderers wait in [parking], which keeps them
+ * attached to the window and initialized, and a renderer that last rendered the track a view asks
+ * for is preferred so that the view shows the last frame of the track instead of a black one.
+ *
+ * Must only be used on the main thread.
+ */
+internal class VideoRendererPool(
+    private val parking: VideoRendererLayout,
+    private val maxRenderers: Int = MAX_VIDEO_RENDERERS,
+    private val maxIdleRenderers: Int = MAX_IDLE_VIDEO_RENDERERS,
+    private val createRenderer: (Context) -> VideoTextureView = ::VideoTextureView
+) {
+    // Ordered from the least to the most recently returned renderer
+    private val idleRenderers = ArrayList<IdleRenderer>(maxIdleRenderers)
+    private var lentRendererCount = 0
+
+    /**
+     * Returns the renderer of [view], lending it one first if needed, or null if [maxRenderers]
+     * renderers are lent already.
+     */
+    fun acquire(view: ParticipantView, videoTrack: VideoTrack): VideoTextureView? {
+        view.videoTextureView?.let { return it }
+        val index = idleRenderers.indexOfLast { it.lastVideoTrack == videoTrack }
+                .takeIf { it >= 0 } ?: idleRenderers.lastIndex
+        val renderer = if (index >= 0) {
+            idleRenderers.removeAt(index).renderer
+        } else {
+            if (lentRendererCount >= maxRenderers) {
+                Timber.w("All %d video renderers are in use", maxRenderers)
+                return null
+            }
+            createRenderer(view.context)
+        }
+        lentRendererCount++
+        view.attachVideoTextureView(renderer)
+        return renderer
+    }
+
+    /** Takes the renderer back from [view] once it no longer renders [lastVideoTrack]. */
+    fun release(view: ParticipantView, lastVideoTrack: VideoTrack?) {
+        val renderer = view.videoTextureView ?: return
+        lentRendererCount--
+        if (idleRenderers.size == maxIdleRenderers) {
+            // The least recently used renderer is released when it is detached from the window
+            parking.removeView(idleRenderers.removeAt(0).renderer)
+        }
+        idleRenderers.add(IdleRenderer(renderer, lastVideoTrack))
+        parking.adopt(renderer)
+    }
+
+    /** Drops the renderers of tracks that are no longer part of the room from the preference. */
+    fun retainTracks(videoTracks: Collection<VideoTrack>) {
+        idleRenderers.forEach { if (it.lastVideoTrack !in videoTracks) it.lastVideoTrack = null }
+    }
+
+    private class IdleRenderer(val renderer: VideoTextureView, var lastVideoTrack: VideoTrack?)
+}
@@ -5,6 +5,8 @@ import android.content.Context
 import android.content.Intent
 import android.os.Build
 import android.os.IBinder
+import com.twilio.video.app.sdk.QualityGovernor
+import com.twilio.video.app.sdk.QualityLevel
 import com.twilio.video.app.sdk.RoomManager
 import dagger.hilt.android.AndroidEntryPoint
 import io.reactivex.disposables.CompositeDisposable
@@ -36,10 +38,14 @@ class VideoService(
     }
 
     @Inject lateinit var roomManager: RoomManager
+    private val qualityGovernor by lazy {
+        QualityGovernor(this) { qualityLevel -> roomManager.setQualityLevel(qualityLevel) }
+    }
 
     override fun onStartCommand(intent: Intent?, flags: Int, startId: Int): Int {
         super.onStartCommand(intent, flags, startId)
         setupForegroundService(intent)
+        qualityGovernor.start()
         Timber.d("VideoService created")
         return START_NOT_STICKY
     }
@@ -48,6 +54,8 @@ class VideoService(
         super.onDestroy()
         Timber.d("VideoService destroyed")
         rxDisposables.clear()
+        qualityGovernor.stop()
+        roomManager.setQualityLevel(QualityLevel.FULL)
     }
 
     override fun onBind(intent: Intent?): IBinder? {
@@ -0,0 +1,223 @@
+package com.twilio.video.app.ui.room
+
+import android.os.Handler
+import android.os.Looper
+import com.twilio.video.RemoteVideoTrack
+import com.twilio.video.VideoTextureView
+import com.twilio.video.VideoTrack
+import timber.log.Timber
+
+const val SWITCH_OFF_DELAY_MILLIS = 1000L
+
+/**
+ * Adds and removes the sinks of the views rendering video tracks and counts the sinks of every
+ * track. When [isManualSwitchOffEnabled] is set, i.e. the room was connected with
+ * [com.twilio.video.ClientTrackSwitchOffControl.MANUAL], a [RemoteVideoTrack] that is not rendered
+ * by any view is switched off after [switchOffDelayMillis] and switched back on as soon as a view
+ * renders it again. The delay keeps a fast scroll through the thumbnails from toggling tracks.
+ * The render size of remote tracks is forwarded to the [VideoContentPreferencesController].
+ * Views borrow their renderer from the [VideoRendererPool] while they render a track, and the
+ * [RenderQualityMonitor] watches the frames of every rendered remote track for freezes. Once every
+ * renderer is lent, a view takes the renderer of the least recently served view that is not shown,
+ * or shows the [ParticipantView.State.SWITCHED_OFF] stub and waits for the next returned renderer.
+ *
+ * Must only be used on the main thread.
+ */
+internal class VideoSinkController(
+    private val rendererPool: VideoRendererPool,
+    private val handler: Handler = Handler(Looper.getMainLooper()),
+    private val switchOffDelayMillis: Long = SWITCH_OFF_DELAY_MILLIS,
+    val contentPreferencesController: VideoContentPreferencesController =
+            VideoContentPreferencesController(),
+    val renderQualityMonitor: RenderQualityMonitor = RenderQualityMonitor(handler)
+) {
+    private val sinkCounts = HashMap<VideoTrack, Int>()
+    private val pendingSwitchOffs = HashMap<RemoteVideoTrack, Runnable>()
+    private val switchedOffTracks = HashSet<RemoteVideoTrack>()
+    private val prefetchedTracks = HashSet<RemoteVideoTrack>()
+    private val roomSwitchedOffTracks = HashSet<VideoTrack>()
+    // Ordered from the least to the most recently served view
+    private val renderingViews = LinkedHashMap<ParticipantView, VideoTrack>()
+    private val waitingViews = LinkedHashMap<ParticipantView, VideoTrack>()
+
+    var isManualSwitchOffEnabled = false
+        set(value) {
+            if (field == value) return
+            field = value
+            if (!value) {
+                pendingSwitchOffs.values.forEach { handler.removeCallbacks(it) }
+                pendingSwitchOffs.clear()
+                switchedOffTracks.forEach { it.switchOn() }
+                switchedOffTracks.clear()
+            }
+        }
+
+    fun addSink(videoTrack: VideoTrack, view: ParticipantView) {
+        if (!videoTrack.isEnabled) return
+        val renderer = acquireRenderer(view, videoTrack) ?: run {
+            waitingViews[view] = videoTrack
+            view.setState(ParticipantView.State.SWITCHED_OFF)
+            return
+        }
+        waitingViews.remove(view)
+        renderingViews.remove(view)
+        renderingViews[view] = videoTrack
+        if (videoTrack.sinks.contains(renderer)) return
+        videoTrack.addSink(renderer)
+        if (videoTrack is RemoteVideoTrack) {
+            contentPreferencesController.onRenderStarted(videoTrack, renderer)
+        }
+        val sinkCount = sinkCounts[videoTrack] ?: 0
+        sinkCounts[videoTrack] = sinkCount + 1
+        if (sinkCount == 0 && videoTrack is RemoteVideoTrack) {
+            switchOn(videoTrack)
+            renderQualityMonitor.start(videoTrack)
+        }
+    }
+
+    /**
+     * Removes the sink of [view] from [videoTrack]. A view that goes on to render another track
+     * right away passes [keepRenderer] so that the handoff only moves the sink of its renderer.
+     */
+    fun removeSink(videoTrack: VideoTrack?, view: ParticipantView, keepRenderer: Boolean = false) {
+        waitingViews.remove(view)
+        if (!releaseRenderer(videoTrack, view, keepRenderer)) return
+        if (!keepRenderer) serveWaitingView()
+    }
+
+    /** True while [view] shows the stub because every renderer is lent, see [addSink]. */
+    fun isWaitingForRenderer(view: ParticipantView) = view in waitingViews
+
+    /**
+     * Marks [videoTrack] as switched off by the room, the [RenderQualityMonitor] does not judge
+     * it until it is switched on since it delivers no frames.
+     */
+    fun setSwitchedOff(videoTrack: VideoTrack, isSwitchedOff: Boolean) {
+        if (isSwitchedOff) roomSwitchedOffTracks.add(videoTrack) else roomSwitchedOffTracks.remove(videoTrack)
+        renderQualityMonitor.setSwitchedOff(videoTrack, isSwitchedOff)
+    }
+
+    /**
+     * Keeps the remote tracks of [videoTracks] switched on at a low layer while no view renders
+     * them, e.g. those of the next page of the grid, so that they show video as soon as they are
+     * rendered. Replaces the tracks prefetched before.
+     */
+    fun prefetchTracks(videoTracks: Collection<VideoTrack>) {
+        val remoteVideoTracks = videoTracks.filterIsInstanceTo(HashSet<RemoteVideoTrack>())
+        val stoppedTracks = prefetchedTracks.filter { it !in remoteVideoTracks }
+        prefetchedTracks.removeAll(stoppedTracks)
+        for (videoTrack in stoppedTracks) {
+            contentPreferencesController.onPrefetchStopped(videoTrack)
+            if (videoTrack !in sinkCounts) scheduleSwitchOff(videoTrack)
+        }
+        for (videoTrack in remoteVideoTracks) {
+            if (prefetchedTracks.add(videoTrack)) {
+                contentPreferencesController.onPrefetchStarted(videoTrack)
+                switchOn(videoTrack)
+            }
+        }
+    }
+
+    /**
+     * Forgets the tracks that are no longer part of the room and schedules the remote tracks that
+     * no view renders to be switched off, e.g. those of thumbnails that have never been on screen.
+     */
+    fun retainTracks(videoTracks: Collection<VideoTrack>) {
+        rendererPool.retainTracks(videoTracks)
+        roomSwitchedOffTracks.retainAll(videoTracks)
+        waitingViews.values.retainAll(videoTracks)
+        renderQualityMonitor.retainTracks(videoTracks)
+        sinkCounts.keys.retainAll(videoTracks)
+        switchedOffTracks.retainAll(videoTracks)
+        prefetchedTracks.removeAll { videoTrack ->
+            (videoTrack !in videoTracks).also {
+                if (it) contentPreferencesController.onPrefetchStopped(videoTrack)
+            }
+        }
+        pendingSwitchOffs.entries.removeAll { (videoTrack, switchOff) ->
+            (videoTrack !in videoTracks).also { if (it) handler.removeCallbacks(switchOff) }
+        }
+        for (videoTrack in videoTracks) {
+            if (videoTrack is RemoteVideoTrack && videoTrack !in sinkCounts) {
+                scheduleSwitchOff(videoTrack)
+            }
+        }
+    }
+
+    private fun acquireRenderer(view: ParticipantView, videoTrack: VideoTrack): VideoTextureView? {
+        rendererPool.acquire(view, videoTrack)?.let { return it }
+        val hiddenView = renderingViews.keys.firstOrNull { it !== view && !it.isShown }
+        if (hiddenView == null) {
+            Timber.w("No video renderer left for track %s", videoTrack.name)
+            return null
+        }
+        val hiddenVideoTrack = renderingViews.getValue(hiddenView)
+        Timber.d("Taking the video renderer of a view that is not shown")
+        releaseRenderer(hiddenVideoTrack, hiddenView, keepRenderer = false)
+        waitingViews[hiddenView] = hiddenVideoTrack
+        hiddenView.setState(ParticipantView.State.SWITCHED_OFF)
+        return rendererPool.acquire(view, videoTrack)
+    }
+
+    /** Returns false if [view] had no renderer. */
+    private fun releaseRenderer(videoTrack: VideoTrack?, view: ParticipantView, keepRenderer: Boolean): Boolean {
+        val renderer = view.videoTextureView ?: return false
+        if (videoTrack != null && videoTrack.sinks.contains(renderer)) {
+            videoTrack.removeSink(renderer)
+            onSinkRemoved(videoTrack, renderer)
+        }
+        if (!keepRenderer) {
+            renderingViews.remove(view)
+            rendererPool.release(view, videoTrack)
+        }
+        return true
+    }
+
+    /* Lends a returned renderer to the view that waits the longest, preferring views shown. */
+    private fun serveWaitingView() {
+        val view = waitingViews.keys.firstOrNull { it.isShown } ?: waitingViews.keys.firstOrNull() ?: return
+        val videoTrack = waitingViews.remove(view) ?: return
+        addSink(videoTrack, view)
+        if (view.videoTextureView != null) {
+            view.setState(if (videoTrack in roomSwitchedOffTracks) ParticipantView.State.SWITCHED_OFF
+                    else ParticipantView.State.VIDEO)
+        }
+    }
+
+    private fun onSinkRemoved(videoTrack: VideoTrack, renderer: VideoTextureView) {
+        if (videoTrack is RemoteVideoTrack) {
+            contentPreferencesController.onRenderStopped(videoTrack, renderer)
+        }
+        val sinkCount = (sinkCounts[videoTrack] ?: 1) - 1
+        if (sinkCount > 0) {
+            sinkCounts[videoTrack] = sinkCount
+        } else {
+            sinkCounts.remove(videoTrack)
+            renderQualityMonitor.stop(videoTrack)
+            if (videoTrack is RemoteVideoTrack) scheduleSwitchOff(videoTrack)
+        }
+    }
+
+    private fun switchOn(videoTrack: RemoteVideoTrack) {
+        pendingSwitchOffs.remove(videoTrack)?.let { handler.removeCallbacks(it) }
+        if (switchedOffTracks.remove(videoTrack)) {
+            Timber.d("Switching on rendered track %s", videoTrack.sid)
+            videoTrack.switchOn()
+        }
+    }
+
+    private fun scheduleSwitchOff(videoTrack: RemoteVideoTrack) {
+        if (!isManualSwitchOffEnabled || videoTrack in switchedOffTracks ||
+                videoTrack in pendingSwitchOffs || videoTrack in prefetchedTracks) return
+        val switchOff = Runnable {
+            pendingSwitchOffs.remove(videoTrack)
+            if (videoTrack !in sinkCounts && videoTrack !in prefetchedTracks &&
+                    switchedOffTracks.add(videoTrack)) {
+                Timber.d("Switching off track %s that is not rendered", videoTrack.sid)
+                videoTrack.switchOff()
+            }
+        }
+        pendingSwitchOffs[videoTrack] = switchOff
+        handler.postDelayed(switchOff, switchOffDelayMillis)
+    }
+}
@@ -17,6 +17,7 @@ import com.twilio.video.Vp9Codec
 import com.twilio.video.app.R
 import com.twilio.video.app.data.Preferences
 import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION
+import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION_AUTOMATIC
 import com.twilio.video.app.data.Preferences.VIDEO_DIMENSIONS
 import com.twilio.video.app.util.isInternalFlavor
 
@@ -34,13 +35,13 @@ class AdvancedSettingsFragment : BaseSettingsFragment() {
         setHasOptionsMenu(true)
 
         (findPreference(VIDEO_CAPTURE_RESOLUTION) as ListPreference?)?.run {
-            entries = VIDEO_DIMENSIONS.map { "${it.width}x${it.height}" }.toTypedArray()
-            entryValues = (0..VIDEO_DIMENSIONS.lastIndex).map { it.toString() }.toTypedArray()
+            entries = (listOf(getString(R.string.settings_screen_video_resolution_automatic)) +
+                    VIDEO_DIMENSIONS.map { "${it.width}x${it.height}" }).toTypedArray()
+            entryValues = (listOf(VIDEO_CAPTURE_RESOLUTION_AUTOMATIC) +
+                    (0..VIDEO_DIMENSIONS.lastIndex).map { it.toString() }).toTypedArray()
             setSummaryProvider { preference ->
                 (preference as ListPreference).let { listPreference ->
-                    VIDEO_DIMENSIONS[listPreference.value.toInt()].let { dimensions ->
-                        entries.find { it == "${dimensions.width}x${dimensions.height}" }
-                    }
+                    listPreference.entry
                 }
             }
         }
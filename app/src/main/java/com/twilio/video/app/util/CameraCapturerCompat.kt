@@ -2,6 +2,7 @@ package com.twilio.video.app.util
 
 import android.content.Context
 import android.graphics.ImageFormat
+import android.graphics.SurfaceTexture
 import android.hardware.camera2.CameraCharacteristics
 import android.hardware.camera2.CameraManager
 import android.hardware.camera2.CameraMetadata
@@ -9,6 +10,7 @@ import android.os.Build
 import com.twilio.video.Camera2Capturer
 import com.twilio.video.CameraCapturer
 import com.twilio.video.VideoCapturer
+import com.twilio.video.VideoDimensions
 import timber.log.Timber
 import tvi.webrtc.Camera1Enumerator
 import tvi.webrtc.Camera2Enumerator
@@ -20,9 +22,12 @@ class CameraCapturerCompat(
     private val frontCameraId: String?,
     private val backCameraId: String?,
     private val cameraCapturer: CameraCapturer? = null,
-    private val camera2Capturer: Camera2Capturer? = null
+    private val camera2Capturer: Camera2Capturer? = null,
+    private val frameProcessors: List<FrameProcessor> = emptyList()
 ) : VideoCapturer {
 
+    private var frameProcessorPipeline: FrameProcessorPipeline? = null
+
     val cameraId: String
         get() = cameraCapturer?.cameraId
                 ?: camera2Capturer?.cameraId
@@ -33,8 +38,11 @@ class CameraCapturerCompat(
         context: Context,
         capturerObserver: CapturerObserver
     ) {
-        cameraCapturer?.initialize(surfaceTextureHelper, context, capturerObserver)
-                ?: camera2Capturer?.initialize(surfaceTextureHelper, context, capturerObserver)
+        val observer = if (frameProcessors.isEmpty()) capturerObserver
+        else FrameProcessorPipeline(surfaceTextureHelper, frameProcessors, capturerObserver)
+                .also { frameProcessorPipeline = it }
+        cameraCapturer?.initialize(surfaceTextureHelper, context, observer)
+                ?: camera2Capturer?.initialize(surfaceTextureHelper, context, observer)
     }
 
     override fun startCapture(width: Int, height: Int, framerate: Int) {
@@ -45,6 +53,19 @@ class CameraCapturerCompat(
         cameraCapturer?.stopCapture() ?: camera2Capturer?.stopCapture()
     }
 
+    /** Restarts capturing with a new format without recreating the video track. */
+    override fun changeCaptureFormat(width: Int, height: Int, framerate: Int) {
+        stopCapture()
+        startCapture(width, height, framerate)
+    }
+
+    /* Must be called before the video track is released, see FrameProcessorPipeline.release. */
+    override fun dispose() {
+        frameProcessorPipeline?.release()
+        frameProcessorPipeline = null
+        cameraCapturer?.dispose() ?: camera2Capturer?.dispose()
+    }
+
     override fun isScreencast() = cameraCapturer?.isScreencast ?: camera2Capturer?.isScreencast ?: false
 
     fun switchCamera() {
@@ -56,22 +77,55 @@ class CameraCapturerCompat(
     }
 
     companion object {
-        fun newInstance(context: Context): CameraCapturerCompat? {
-            return if (Camera2Capturer.isSupported(context)) {
+        fun newInstance(
+            context: Context,
+            frameProcessors: List<FrameProcessor> = emptyList()
+        ): CameraCapturerCompat? {
+            return if (isCamera2Supported(context)) {
                 Camera2Enumerator(context).getFrontAndBackCameraIds(context)?.let { cameraIds ->
                     val cameraCapturer = Camera2Capturer(context, cameraIds.first
                             ?: cameraIds.second ?: "")
-                    CameraCapturerCompat(cameraIds.first, cameraIds.second, camera2Capturer = cameraCapturer)
+                    CameraCapturerCompat(cameraIds.first, cameraIds.second,
+                            camera2Capturer = cameraCapturer, frameProcessors = frameProcessors)
                 }
             } else {
                 Camera1Enumerator().getFrontAndBackCameraIds(context, isCamera2 = false)?.let { cameraIds ->
                     val cameraCapturer = CameraCapturer(context, cameraIds.first ?: cameraIds.second
                     ?: "", getCameraListener())
-                    CameraCapturerCompat(cameraIds.first, cameraIds.second, cameraCapturer = cameraCapturer)
+                    CameraCapturerCompat(cameraIds.first, cameraIds.second,
+                            cameraCapturer = cameraCapturer, frameProcessors = frameProcessors)
                 }
             }
         }
 
+        /**
+         * Returns the output sizes and the highest frame rate of the camera that [newInstance]
+         * captures from first, or null if the device does not support Camera2.
+         */
+        fun getCaptureCapabilities(context: Context): Pair<List<VideoDimensions>, Int>? {
+            if (!isCamera2Supported(context)) return null
+            val cameraIds = Camera2Enumerator(context).getFrontAndBackCameraIds(context) ?: return null
+            val cameraId = cameraIds.first ?: cameraIds.second ?: return null
+            val cameraManager = context.getSystemService(Context.CAMERA_SERVICE) as CameraManager
+            val cameraCharacteristics: CameraCharacteristics = try {
+                cameraManager.getCameraCharacteristics(cameraId)
+            } catch (e: Exception) {
+                Timber.e(e)
+                return null
+            }
+            val outputSizes = cameraCharacteristics.get(CameraCharacteristics.SCALER_STREAM_CONFIGURATION_MAP)
+                    ?.getOutputSizes(SurfaceTexture::class.java)
+                    ?.map { VideoDimensions(it.width, it.height) }
+                    ?: return null
+            /*
+             * Some legacy devices report the frame rate ranges multiplied by 1000.
+             */
+            val maxFrameRate = cameraCharacteristics.get(CameraCharacteristics.CONTROL_AE_AVAILABLE_TARGET_FPS_RANGES)
+                    ?.maxOfOrNull { if (it.upper >= 1000) it.upper / 1000 else it.upper }
+                    ?: return null
+            return outputSizes to maxFrameRate
+        }
+
         private fun getCameraListener() = object : CameraCapturer.Listener {
             override fun onFirstFrameAvailable() { }
 
@@ -80,20 +134,38 @@ class CameraCapturerCompat(
             override fun onError(errorCode: Int) {}
         }
 
-        private fun CameraEnumerator.getFrontAndBackCameraIds(context: Context, isCamera2: Boolean = true): Pair<String?, String?>? {
-            val cameraIds = deviceNames.find { isFrontFacing(it) && isCameraIdSupported(isCamera2, context, it) } to
-                    deviceNames.find { isBackFacing(it) && isCameraIdSupported(isCamera2, context, it) }
-            return if (isAtLeastOneCameraAvailable(cameraIds.first, cameraIds.second)) cameraIds
-            else {
+        /*
+         * The cameras of a device do not change while the process runs, so they are enumerated
+         * and their characteristics are read once per camera API, see CameraEnumerationCache.
+         */
+        private val enumerationCache = CameraEnumerationCache()
+
+        private fun isCamera2Supported(context: Context) =
+                enumerationCache.isCamera2Supported { Camera2Capturer.isSupported(context) }
+
+        private fun CameraEnumerator.getFrontAndBackCameraIds(context: Context, isCamera2: Boolean = true): Pair<String?, String?>? =
+                enumerationCache.getFrontAndBackCameraIds(isCamera2) { enumerateFrontAndBackCameraIds(context, isCamera2) }
+
+        private fun CameraEnumerator.enumerateFrontAndBackCameraIds(context: Context, isCamera2: Boolean): CameraEnumeration {
+            var isComplete = true
+            val isSupported = { cameraId: String ->
+                isCameraIdSupported(isCamera2, context, cameraId) ?: false.also { isComplete = false }
+            }
+            val cameraIds = deviceNames.find { isFrontFacing(it) && isSupported(it) } to
+                    deviceNames.find { isBackFacing(it) && isSupported(it) }
+            return if (isAtLeastOneCameraAvailable(cameraIds.first, cameraIds.second)) {
+                CameraEnumeration(cameraIds, isComplete)
+            } else {
                 Timber.w("No cameras are available on this device")
-                null
+                CameraEnumeration(null, isComplete)
             }
         }
 
-        private fun isCameraIdSupported(isCamera2: Boolean, context: Context, cameraId: String) =
+        /* Returns null if the characteristics of the camera could not be read. */
+        private fun isCameraIdSupported(isCamera2: Boolean, context: Context, cameraId: String): Boolean? =
                 if (isCamera2) isCameraIdSupported(context, cameraId) else true
 
-        private fun isCameraIdSupported(context: Context, cameraId: String): Boolean {
+        private fun isCameraIdSupported(context: Context, cameraId: String): Boolean? {
             val cameraManager = context.getSystemService(Context.CAMERA_SERVICE) as CameraManager
             var isMonoChromeSupported = false
             var isPrivateImageFormatSupported = false
@@ -101,7 +173,7 @@ class CameraCapturerCompat(
                 cameraManager.getCameraCharacteristics(cameraId)
             } catch (e: Exception) {
                 Timber.e(e)
-                return false
+                return null
             }
             /*
              * This is a temporary work around for a RuntimeException that occurs on devices which contain cameras
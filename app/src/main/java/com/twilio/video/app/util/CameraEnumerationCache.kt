@@ -0,0 +1,29 @@
+package com.twilio.video.app.util
+
+/**
+ * Remembers for the lifetime of the process whether Camera2 is supported and the front and back
+ * camera ids of each camera API. Only a successful result is remembered: a failed check, a camera
+ * whose characteristics could not be read or a device without cameras is checked again next time,
+ * e.g. once the camera service is back or the permission was granted.
+ */
+internal class CameraEnumerationCache {
+
+    private var isCamera2Supported = false
+    private val cameraIds = HashMap<Boolean, Pair<String?, String?>>()
+
+    @Synchronized
+    fun isCamera2Supported(check: () -> Boolean): Boolean =
+            isCamera2Supported || check().also { isCamera2Supported = it }
+
+    @Synchronized
+    fun getFrontAndBackCameraIds(isCamera2: Boolean, enumerate: () -> CameraEnumeration): Pair<String?, String?>? =
+            cameraIds[isCamera2] ?: enumerate().let { enumeration ->
+                enumeration.cameraIds?.also { if (enumeration.isComplete) cameraIds[isCamera2] = it }
+            }
+}
+
+/**
+ * The front and back camera ids found by an enumeration, or null without any. It [isComplete] when
+ * the characteristics of every camera were read.
+ */
+internal class CameraEnumeration(val cameraIds: Pair<String?, String?>?, val isComplete: Boolean)
@@ -0,0 +1,15 @@
+package com.twilio.video.app.util
+
+import com.twilio.video.app.BuildConfig
+import timber.log.Timber
+
+/** Whether the planted tree keeps debug logs, see [com.twilio.video.app.TreeModule]. */
+val isDebugLoggingEnabled: Boolean get() = BuildConfig.DEBUG || isInternalFlavor
+
+/**
+ * Logs the message built by [message] at the debug priority. Hot paths use this instead of
+ * [Timber.d] so that release builds neither build the message nor format its arguments.
+ */
+inline fun debugLog(message: () -> String) {
+    if (isDebugLoggingEnabled) Timber.d(message())
+}
@@ -0,0 +1,235 @@
+package com.twilio.video.app.util
+
+import android.graphics.Matrix
+import android.opengl.GLES20
+import androidx.core.os.TraceCompat
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+import timber.log.Timber
+import tvi.webrtc.CapturerObserver
+import tvi.webrtc.GlRectDrawer
+import tvi.webrtc.GlTextureFrameBuffer
+import tvi.webrtc.SurfaceTextureHelper
+import tvi.webrtc.TextureBufferImpl
+import tvi.webrtc.VideoFrame
+import tvi.webrtc.VideoFrameDrawer
+import tvi.webrtc.YuvConverter
+
+const val FRAME_PROCESSOR_STATS_INTERVAL_FRAMES = 300
+const val MAX_IDLE_PROCESSOR_TEXTURES = 3
+private const val FRAME_PROCESSOR_RELEASE_TIMEOUT_MILLIS = 500L
+
+/**
+ * A stage of the [FrameProcessorPipeline] of a camera track, e.g. a background blur.
+ *
+ * Every method is called on the thread of the [SurfaceTextureHelper] of the capturer, which has the
+ * EGL context of the camera textures current. Stages can therefore sample the OES texture of a
+ * [VideoFrame.TextureBuffer] and render into a texture of the [TextureFramePool] without a round
+ * trip through the CPU.
+ */
+interface FrameProcessor {
+    /** Names the stage in its latency stats and trace sections. */
+    val name: String
+
+    /** Called before the first frame is processed. */
+    fun initialize(texturePool: TextureFramePool) {}
+
+    /**
+     * Returns [frame] to pass it on unchanged, a new frame that replaces it or null to drop it.
+     * [frame] must not be released, the pipeline releases every frame it did not receive from the
+     * capturer once the next stage is done with it.
+     */
+    fun process(frame: VideoFrame): VideoFrame?
+
+    /** Called once the capturer is disposed. */
+    fun release() {}
+}
+
+/**
+ * @param averageMillis the average time the stage took per frame over the last stats interval.
+ * @param maxMillis the longest time the stage took for a frame over the last stats interval.
+ */
+data class FrameProcessorStats(val name: String, val averageMillis: Double, val maxMillis: Double)
+
+/**
+ * Recycles the RGBA textures that [FrameProcessor]s render their output into, or that [copy]
+ * renders a frame into, so that processing a frame does not create a texture. A texture returns to
+ * the pool once every consumer released the frame wrapping it, at most [maxIdleTextures] textures
+ * are kept. The GL objects are only created once they are first used.
+ *
+ * Must only be used on the thread of [surfaceTextureHelper].
+ */
+class TextureFramePool(
+    private val surfaceTextureHelper: SurfaceTextureHelper,
+    private val maxIdleTextures: Int = MAX_IDLE_PROCESSOR_TEXTURES
+) {
+
+    private val idleTextures = ArrayDeque<PooledTexture>(maxIdleTextures)
+    private val lazyYuvConverter = lazy { YuvConverter() }
+    private val yuvConverter by lazyYuvConverter
+    private val identityMatrix by lazy { Matrix() }
+    private val lazyFrameDrawer = lazy { VideoFrameDrawer() }
+    private val frameDrawer by lazyFrameDrawer
+    private val lazyRectDrawer = lazy { GlRectDrawer() }
+    private val rectDrawer by lazyRectDrawer
+    private var isReleased = false
+
+    /** Returns a texture of [width] x [height] to render into through its frame buffer. */
+    fun acquire(width: Int, height: Int): PooledTexture {
+        val texture = idleTextures.removeFirstOrNull() ?: PooledTexture()
+        texture.frameBuffer.setSize(width, height)
+        return texture
+    }
+
+    /** Wraps [texture] into a frame that returns the texture to the pool once it is released. */
+    fun wrap(texture: PooledTexture, rotation: Int, timestampNs: Long): VideoFrame {
+        val frameBuffer = texture.frameBuffer
+        val buffer = TextureBufferImpl(frameBuffer.width, frameBuffer.height,
+                VideoFrame.TextureBuffer.Type.RGB, frameBuffer.textureId, identityMatrix,
+                surfaceTextureHelper.handler, yuvConverter, texture.releaseCallback)
+        return VideoFrame(buffer, rotation, timestampNs)
+    }
+
+    /**
+     * Renders [frame], a [VideoFrame.TextureBuffer] frame, into a texture of the pool, e.g. to keep
+     * its content without keeping the texture of a capturer, which delivers no other frame until
+     * its texture is released. The copy keeps the rotation and the timestamp of [frame].
+     */
+    fun copy(frame: VideoFrame): VideoFrame {
+        val buffer = frame.buffer
+        val texture = acquire(buffer.width, buffer.height)
+        GLES20.glBindFramebuffer(GLES20.GL_FRAMEBUFFER, texture.frameBuffer.frameBufferId)
+        // Drawn unrotated, the copy is rotated along with its frame
+        frameDrawer.drawFrame(VideoFrame(buffer, 0, frame.timestampNs), rectDrawer, null,
+                0, 0, buffer.width, buffer.height)
+        GLES20.glBindFramebuffer(GLES20.GL_FRAMEBUFFER, 0)
+        return wrap(texture, frame.rotation, frame.timestampNs)
+    }
+
+    fun release() {
+        isReleased = true
+        idleTextures.forEach { it.frameBuffer.release() }
+        idleTextures.clear()
+        if (lazyYuvConverter.isInitialized()) yuvConverter.release()
+        if (lazyFrameDrawer.isInitialized()) frameDrawer.release()
+        if (lazyRectDrawer.isInitialized()) rectDrawer.release()
+    }
+
+    private fun recycle(texture: PooledTexture) {
+        if (!isReleased && idleTextures.size < maxIdleTextures) {
+            idleTextures.addLast(texture)
+        } else {
+            texture.frameBuffer.release()
+        }
+    }
+
+    /*
+     * The release callback may run on the encoder thread, so it only posts the recycling to the
+     * texture thread. It is created once per texture instead of once per frame.
+     */
+    inner class PooledTexture internal constructor() {
+        val frameBuffer = GlTextureFrameBuffer(GLES20.GL_RGBA)
+        private val recycleRunnable = Runnable { recycle(this) }
+        internal val releaseCallback = Runnable { surfaceTextureHelper.handler.post(recycleRunnable) }
+    }
+}
+
+/**
+ * Runs the frames of a capturer through [processors] before they reach the [CapturerObserver] of
+ * the video track. The time every stage takes is traced as a [TraceCompat] section and aggregated
+ * into [latestStats] every [FRAME_PROCESSOR_STATS_INTERVAL_FRAMES] frames. Processing a frame does
+ * not allocate beyond the frames the stages create.
+ */
+class FrameProcessorPipeline(
+    private val surfaceTextureHelper: SurfaceTextureHelper,
+    processors: List<FrameProcessor>,
+    private val downstream: CapturerObserver,
+    private val clock: () -> Long = System::nanoTime
+) : CapturerObserver {
+
+    private val processors = processors.toTypedArray()
+    private val sectionNames = Array(processors.size) { "FrameProcessor ${processors[it].name}" }
+    private val totalNanos = LongArray(processors.size)
+    private val maxNanos = LongArray(processors.size)
+    private var intervalFrameCount = 0
+    private var isInitialized = false
+    private val texturePool by lazy { TextureFramePool(surfaceTextureHelper) }
+
+    /** The stats of the last complete interval, empty before the first one. */
+    @Volatile
+    var latestStats: List<FrameProcessorStats> = emptyList()
+        private set
+
+    override fun onCapturerStarted(success: Boolean) = downstream.onCapturerStarted(success)
+
+    override fun onCapturerStopped() = downstream.onCapturerStopped()
+
+    override fun onFrameCaptured(frame: VideoFrame) {
+        if (!isInitialized) {
+            isInitialized = true
+            processors.forEach { it.initialize(texturePool) }
+        }
+        var current: VideoFrame? = frame
+        for (index in processors.indices) {
+            val input = current ?: break
+            val startNanos = clock()
+            TraceCompat.beginSection(sectionNames[index])
+            current = try {
+                processors[index].process(input)
+            } finally {
+                TraceCompat.endSection()
+            }
+            record(index, clock() - startNanos)
+            if (current !== input && input !== frame) input.release()
+        }
+        current?.let { output ->
+            downstream.onFrameCaptured(output)
+            if (output !== frame) output.release()
+        }
+        if (++intervalFrameCount == FRAME_PROCESSOR_STATS_INTERVAL_FRAMES) publishStats()
+    }
+
+    /**
+     * Releases the stages and the pooled textures on the texture thread and waits for it, so that
+     * the capturer has to be disposed before the video track, which disposes the
+     * [SurfaceTextureHelper]. A texture thread that is already gone took its EGL context, and with
+     * it the textures, along.
+     */
+    fun release() {
+        val handler = surfaceTextureHelper.handler
+        if (handler.looper?.thread === Thread.currentThread()) return releaseStages()
+        val released = CountDownLatch(1)
+        if (!handler.post { releaseStages(); released.countDown() }) {
+            Timber.w("The texture thread is gone, the frame processors are not released")
+        } else if (!released.await(FRAME_PROCESSOR_RELEASE_TIMEOUT_MILLIS, TimeUnit.MILLISECONDS)) {
+            Timber.w("Timed out waiting for the frame processors to be released")
+        }
+    }
+
+    private fun releaseStages() {
+        if (!isInitialized) return
+        processors.forEach { it.release() }
+        texturePool.release()
+    }
+
+    private fun record(index: Int, nanos: Long) {
+        totalNanos[index] += nanos
+        if (nanos > maxNanos[index]) maxNanos[index] = nanos
+    }
+
+    private fun publishStats() {
+        latestStats = processors.indices.map { index ->
+            FrameProcessorStats(processors[index].name,
+                    totalNanos[index] / intervalFrameCount / NANOS_PER_MILLI,
+                    maxNanos[index] / NANOS_PER_MILLI)
+        }
+        Timber.d("Frame processor latency: %s", latestStats)
+        totalNanos.fill(0)
+        maxNanos.fill(0)
+        intervalFrameCount = 0
+    }
+
+    private companion object {
+        const val NANOS_PER_MILLI = 1_000_000.0
+    }
+}
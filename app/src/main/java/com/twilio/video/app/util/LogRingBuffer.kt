@@ -0,0 +1,75 @@
+package com.twilio.video.app.util
+
+import java.text.SimpleDateFormat
+import java.util.Date
+import java.util.Locale
+
+const val LOG_RING_BUFFER_CAPACITY = 256
+
+/**
+ * Keeps the latest [capacity] log events of a release build in memory, so that they only reach
+ * Crashlytics as the breadcrumbs of an error. Events are stored in preallocated parallel arrays and
+ * adding one never allocates, formats or does I/O on the calling thread. Once the buffer is full
+ * the oldest event is overwritten.
+ *
+ * Thread safe, events may be logged from any thread.
+ */
+class LogRingBuffer(
+    val capacity: Int = LOG_RING_BUFFER_CAPACITY,
+    private val clock: () -> Long = System::currentTimeMillis
+) {
+
+    private val timestamps = LongArray(capacity)
+    private val priorities = IntArray(capacity)
+    private val messages = arrayOfNulls<String>(capacity)
+    private var head = 0
+
+    @get:Synchronized
+    var size = 0
+        private set
+
+    @Synchronized
+    fun add(priority: Int, message: String) {
+        timestamps[head] = clock()
+        priorities[head] = priority
+        messages[head] = message
+        head = (head + 1) % capacity
+        if (size < capacity) size++
+    }
+
+    /** Removes every event from the buffer and returns them from the oldest to the newest. */
+    @Synchronized
+    fun drain(): Snapshot {
+        val snapshot = Snapshot(size)
+        val oldest = (head - size + capacity) % capacity
+        for (i in 0 until size) {
+            val index = (oldest + i) % capacity
+            snapshot.timestamps[i] = timestamps[index]
+            snapshot.priorities[i] = priorities[index]
+            snapshot.messages[i] = messages[index]
+            messages[index] = null
+        }
+        size = 0
+        return snapshot
+    }
+
+    class Snapshot internal constructor(val size: Int) {
+        internal val timestamps = LongArray(size)
+        internal val priorities = IntArray(size)
+        internal val messages = arrayOfNulls<String>(size)
+
+        fun priority(index: Int) = priorities[index]
+
+        /** Formats the event at [index] the first time it is read, i.e. once an error is reported. */
+        fun line(index: Int): String {
+            val timestamp = TIMESTAMP_FORMAT.get()!!.format(Date(timestamps[index]))
+            return "$timestamp ${messages[index]}"
+        }
+    }
+
+    companion object {
+        private val TIMESTAMP_FORMAT = object : ThreadLocal<SimpleDateFormat>() {
+            override fun initialValue() = SimpleDateFormat("HH:mm:ss.SSS", Locale.US)
+        }
+    }
+}
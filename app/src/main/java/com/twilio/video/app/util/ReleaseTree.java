@@ -22,31 +22,63 @@ import timber.log.Timber;
 
 public class ReleaseTree extends Timber.Tree {
     private final TreeRanger treeRanger;
+    private final LogRingBuffer ringBuffer;
 
     public ReleaseTree(TreeRanger treeRanger) {
+        this(treeRanger, new LogRingBuffer());
+    }
+
+    ReleaseTree(TreeRanger treeRanger, LogRingBuffer ringBuffer) {
         this.treeRanger = treeRanger;
+        this.ringBuffer = ringBuffer;
+    }
+
+    /**
+     * Flushes the latest events to the ranger before the previous handler, i.e. the one of
+     * Crashlytics, records a crash, so that fatal crashes carry the same breadcrumbs as errors.
+     */
+    public void installUncaughtExceptionHandler() {
+        Thread.UncaughtExceptionHandler previousHandler =
+                Thread.getDefaultUncaughtExceptionHandler();
+        Thread.setDefaultUncaughtExceptionHandler(
+                (thread, throwable) -> {
+                    flush(ringBuffer.drain());
+                    if (previousHandler != null) {
+                        previousHandler.uncaughtException(thread, throwable);
+                    }
+                });
+    }
+
+    @Override
+    protected boolean isLoggable(String tag, int priority) {
+        // Timber only formats the message of a loggable priority
+        return priority >= Log.INFO;
     }
 
     @Override
     protected void log(int priority, String tag, @NotNull String message, Throwable throwable) {
-        // No logging in release, but we allow the ranger to still act
+        // No logging in release, but the latest events are kept for the ranger to report an error
         switch (priority) {
-            case Log.VERBOSE:
-            case Log.DEBUG:
             case Log.INFO:
-                treeRanger.inform(message);
-                break;
             case Log.WARN:
-                treeRanger.caution(message);
+                ringBuffer.add(priority, message);
                 break;
             case Log.ERROR:
             case Log.ASSERT:
-                if (throwable == null) {
-                    treeRanger.alert(new Exception(message));
-                } else {
-                    treeRanger.alert(throwable);
-                }
+                // Reported before returning, the process may be about to die
+                flush(ringBuffer.drain());
+                treeRanger.alert(throwable == null ? new Exception(message) : throwable);
                 break;
         }
     }
+
+    private void flush(LogRingBuffer.Snapshot breadcrumbs) {
+        for (int i = 0; i < breadcrumbs.getSize(); i++) {
+            if (breadcrumbs.priority(i) == Log.WARN) {
+                treeRanger.caution(breadcrumbs.line(i));
+            } else {
+                treeRanger.inform(breadcrumbs.line(i));
+            }
+        }
+    }
 }
@@ -0,0 +1,167 @@
+package com.twilio.video.app.util
+
+import android.content.Context
+import android.os.Handler
+import com.twilio.video.ScreenCapturer
+import com.twilio.video.VideoCapturer
+import com.twilio.video.app.sdk.ScreenShareProfile
+import tvi.webrtc.CapturerObserver
+import tvi.webrtc.SurfaceTextureHelper
+import tvi.webrtc.VideoFrame
+import java.util.concurrent.TimeUnit
+
+/**
+ * Sends the frames of [screenCapturer] according to a [ScreenShareProfile], see
+ * [ScreenShareFrameFilter].
+ */
+class ScreenShareCapturer(
+    private val screenCapturer: ScreenCapturer,
+    private val profile: ScreenShareProfile
+) : VideoCapturer {
+
+    override fun initialize(
+        surfaceTextureHelper: SurfaceTextureHelper,
+        context: Context,
+        capturerObserver: CapturerObserver
+    ) {
+        screenCapturer.initialize(surfaceTextureHelper, context,
+                ScreenShareFrameFilter(surfaceTextureHelper.handler, profile, capturerObserver,
+                        { TextureFramePool(surfaceTextureHelper, maxIdleTextures = 2) }))
+    }
+
+    override fun startCapture(width: Int, height: Int, framerate: Int) =
+            screenCapturer.startCapture(width, height, framerate)
+
+    override fun stopCapture() = screenCapturer.stopCapture()
+
+    override fun changeCaptureFormat(width: Int, height: Int, framerate: Int) =
+            screenCapturer.changeCaptureFormat(width, height, framerate)
+
+    override fun dispose() = screenCapturer.dispose()
+
+    override fun isScreencast() = true
+}
+
+/**
+ * Passes screen frames to [downstream] at most at the frame rate of [profile] and downscaled to
+ * its target dimensions.
+ *
+ * The virtual display behind a screen capture only produces a frame when the screen content
+ * changes, so every captured frame is a dirty frame. A frame that arrives before its slot is
+ * retained until the slot, which keeps the [SurfaceTextureHelper] from delivering another one in
+ * the meantime, so a burst of changes collapses into the latest one. Downscaling a texture frame
+ * only changes its transform, the hardware encoder samples it on the GPU at the target size.
+ *
+ * With a keep-alive, the last sent frame is kept to be sent again. A texture frame is copied into a
+ * texture of the [TextureFramePool] of [createTexturePool] on the GPU, which neither reads it back
+ * to the CPU nor holds on to the texture of the capturer. The pool lives until the capture stops.
+ *
+ * Must only be called on the thread of [handler].
+ */
+class ScreenShareFrameFilter(
+    private val handler: Handler,
+    private val profile: ScreenShareProfile,
+    private val downstream: CapturerObserver,
+    private val createTexturePool: () -> TextureFramePool? = { null },
+    private val clock: () -> Long = System::nanoTime
+) : CapturerObserver {
+
+    private val frameIntervalNanos = TimeUnit.SECONDS.toNanos(1) / profile.maxFrameRate
+    private var lastSentNanos = 0L
+    private var hasSentFrame = false
+    private var heldFrame: VideoFrame? = null
+    private var keepAliveFrame: VideoFrame? = null
+    private var keepAliveFrameNanos = 0L
+    private var texturePool: TextureFramePool? = null
+    private val sendHeldFrameRunnable = Runnable {
+        heldFrame?.let { frame ->
+            heldFrame = null
+            send(frame)
+            frame.release()
+        }
+    }
+    private val keepAliveRunnable = Runnable { resendKeepAliveFrame() }
+
+    override fun onCapturerStarted(success: Boolean) = downstream.onCapturerStarted(success)
+
+    override fun onCapturerStopped() {
+        handler.removeCallbacks(sendHeldFrameRunnable)
+        handler.removeCallbacks(keepAliveRunnable)
+        heldFrame?.release()
+        heldFrame = null
+        keepAliveFrame?.release()
+        keepAliveFrame = null
+        texturePool?.release()
+        texturePool = null
+        hasSentFrame = false
+        downstream.onCapturerStopped()
+    }
+
+    override fun onFrameCaptured(frame: VideoFrame) {
+        val elapsedNanos = clock() - lastSentNanos
+        if (!hasSentFrame || elapsedNanos >= frameIntervalNanos) {
+            heldFrame?.release()
+            heldFrame = null
+            handler.removeCallbacks(sendHeldFrameRunnable)
+            send(frame)
+        } else {
+            frame.retain()
+            heldFrame?.release()
+            if (heldFrame == null) {
+                handler.postDelayed(sendHeldFrameRunnable,
+                        TimeUnit.NANOSECONDS.toMillis(frameIntervalNanos - elapsedNanos) + 1)
+            }
+            heldFrame = frame
+        }
+    }
+
+    private fun send(frame: VideoFrame) {
+        lastSentNanos = clock()
+        hasSentFrame = true
+        val scaledFrame = scale(frame)
+        downstream.onFrameCaptured(scaledFrame)
+        if (profile.keepAliveMillis > 0) {
+            keepAliveFrame?.release()
+            keepAliveFrame = keep(scaledFrame)
+            keepAliveFrameNanos = lastSentNanos
+            scheduleKeepAlive()
+        }
+        if (scaledFrame !== frame) scaledFrame.release()
+    }
+
+    /* Frames in memory do not hold on to the capturer, they are kept as they are. */
+    private fun keep(frame: VideoFrame): VideoFrame {
+        val buffer = frame.buffer
+        if (buffer !is VideoFrame.TextureBuffer) {
+            buffer.retain()
+            return VideoFrame(buffer, frame.rotation, frame.timestampNs)
+        }
+        val texturePool = texturePool ?: createTexturePool()?.also { texturePool = it }
+        return texturePool?.copy(frame) ?: VideoFrame(buffer.toI420(), frame.rotation, frame.timestampNs)
+    }
+
+    private fun resendKeepAliveFrame() {
+        val frame = keepAliveFrame ?: return
+        lastSentNanos = clock()
+        // The encoder drops frames that do not advance the timestamp
+        frame.buffer.retain()
+        val resentFrame = VideoFrame(frame.buffer, frame.rotation,
+                frame.timestampNs + lastSentNanos - keepAliveFrameNanos)
+        downstream.onFrameCaptured(resentFrame)
+        resentFrame.release()
+        scheduleKeepAlive()
+    }
+
+    private fun scheduleKeepAlive() {
+        handler.removeCallbacks(keepAliveRunnable)
+        handler.postDelayed(keepAliveRunnable, profile.keepAliveMillis)
+    }
+
+    private fun scale(frame: VideoFrame): VideoFrame {
+        val buffer = frame.buffer
+        val target = profile.targetDimensions(buffer.width, buffer.height)
+        if (target.width == buffer.width && target.height == buffer.height) return frame
+        return VideoFrame(buffer.cropAndScale(0, 0, buffer.width, buffer.height, target.width, target.height),
+                frame.rotation, frame.timestampNs)
+    }
+}
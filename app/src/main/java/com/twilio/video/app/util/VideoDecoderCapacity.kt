@@ -0,0 +1,51 @@
+package com.twilio.video.app.util
+
+import android.app.ActivityManager
+import android.content.Context
+import android.media.MediaCodecInfo
+import android.media.MediaCodecList
+import android.os.Build
+import androidx.core.content.getSystemService
+import timber.log.Timber
+
+internal const val VP8_MIME_TYPE = "video/x-vnd.on2.vp8"
+internal const val H264_MIME_TYPE = "video/avc"
+private val VIDEO_MIME_TYPES = listOf(VP8_MIME_TYPE, H264_MIME_TYPE)
+private val SOFTWARE_CODEC_PREFIXES = listOf("OMX.google.", "c2.android.")
+
+/**
+ * Estimates how many remote video tracks the device can decode concurrently. The capacity is the
+ * number of hardware decoder instances available for the codecs used by rooms or, without hardware
+ * decoders, the number of CPU cores. Low RAM devices report a single decoder.
+ */
+fun videoDecoderCapacity(context: Context): Int {
+    if (context.getSystemService<ActivityManager>()?.isLowRamDevice == true) return 1
+    val hardwareDecoderInstances = try {
+        hardwareDecoderInstances()
+    } catch (e: RuntimeException) {
+        Timber.w(e, "Unable to query the video decoders")
+        0
+    }
+    return hardwareDecoderInstances.takeIf { it > 0 } ?: Runtime.getRuntime().availableProcessors()
+}
+
+private fun hardwareDecoderInstances(): Int {
+    if (Build.VERSION.SDK_INT < Build.VERSION_CODES.M) return 0
+    return MediaCodecList(MediaCodecList.REGULAR_CODECS).codecInfos
+            .filter { !it.isEncoder && it.isHardwareCodec() }
+            .flatMap { codecInfo ->
+                codecInfo.supportedTypes.filter { it in VIDEO_MIME_TYPES }.map { mimeType ->
+                    mimeType to codecInfo.getCapabilitiesForType(mimeType).maxSupportedInstances
+                }
+            }
+            .groupBy({ it.first }, { it.second })
+            .values
+            .maxOfOrNull { it.sum() } ?: 0
+}
+
+internal fun MediaCodecInfo.isHardwareCodec() =
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q) {
+            isHardwareAccelerated
+        } else {
+            SOFTWARE_CODEC_PREFIXES.none { name.startsWith(it) }
+        }
@@ -0,0 +1,29 @@
+package com.twilio.video.app.util
+
+import android.media.MediaCodecList
+import com.twilio.video.H264Codec
+import com.twilio.video.Vp8Codec
+import timber.log.Timber
+
+/**
+ * Returns the names of the video codecs, [Vp8Codec.NAME] and [H264Codec.NAME], that the device can
+ * encode in hardware. Codecs missing from the set are encoded in software.
+ */
+fun hardwareVideoEncoders(): Set<String> {
+    return try {
+        MediaCodecList(MediaCodecList.REGULAR_CODECS).codecInfos
+                .filter { it.isEncoder && it.isHardwareCodec() }
+                .flatMap { it.supportedTypes.toList() }
+                .mapNotNull { mimeType ->
+                    when (mimeType) {
+                        VP8_MIME_TYPE -> Vp8Codec.NAME
+                        H264_MIME_TYPE -> H264Codec.NAME
+                        else -> null
+                    }
+                }
+                .toSet()
+    } catch (e: RuntimeException) {
+        Timber.w(e, "Unable to query the video encoders")
+        emptySet()
+    }
+}
@@ -0,0 +1,85 @@
+package com.twilio.video.app.data
+
+import android.content.SharedPreferences
+import android.content.SharedPreferences.OnSharedPreferenceChangeListener
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION
+import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION_AUTOMATIC
+import com.twilio.video.app.data.Preferences.VIDEO_CAPTURE_RESOLUTION_VERSION
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.any
+import org.mockito.kotlin.anyOrNull
+import org.mockito.kotlin.argumentCaptor
+import org.mockito.kotlin.doAnswer
+import org.mockito.kotlin.eq
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.never
+import org.mockito.kotlin.verify
+import org.mockito.kotlin.whenever
+
+class SettingsStoreTest : BaseUnitTest() {
+
+    private val sharedPreferences = mock<SharedPreferences> {
+        on { getBoolean(any(), any()) } doAnswer { it.getArgument(1) }
+        on { getInt(any(), any()) } doAnswer { it.getArgument(1) }
+        on { getString(any(), anyOrNull()) } doAnswer { it.getArgument(1) }
+    }
+
+    @Test
+    fun `settings should fall back to the defaults of the preferences`() {
+        assertThat(SettingsStore(sharedPreferences).settings.value, equalTo(Settings()))
+    }
+
+    @Test
+    fun `settings should be read again when a preference changes`() {
+        val settingsStore = SettingsStore(sharedPreferences)
+        val listener = argumentCaptor<OnSharedPreferenceChangeListener>()
+        verify(sharedPreferences).registerOnSharedPreferenceChangeListener(listener.capture())
+
+        whenever(sharedPreferences.getBoolean(eq(Preferences.ENABLE_STATS), any())).thenReturn(false)
+        whenever(sharedPreferences.getInt(eq(Preferences.MAX_VIDEO_BITRATE), any())).thenReturn(500)
+        listener.firstValue.onSharedPreferenceChanged(sharedPreferences, Preferences.ENABLE_STATS)
+
+        assertThat(settingsStore.settings.value,
+                equalTo(Settings(enableStats = false, maxVideoBitrate = 500)))
+    }
+
+    @Test
+    fun `a stored index 1 should be migrated to the automatic capture resolution`() {
+        val editor = mockEditor()
+        whenever(sharedPreferences.getString(eq(VIDEO_CAPTURE_RESOLUTION), anyOrNull())).thenReturn("1")
+
+        sharedPreferences.migrateVideoCaptureResolution()
+
+        verify(editor).putString(VIDEO_CAPTURE_RESOLUTION, VIDEO_CAPTURE_RESOLUTION_AUTOMATIC)
+        verify(editor).putInt(VIDEO_CAPTURE_RESOLUTION_VERSION, 2)
+        verify(editor).apply()
+    }
+
+    @Test
+    fun `any other capture resolution should be kept by the migration`() {
+        val editor = mockEditor()
+        whenever(sharedPreferences.getString(eq(VIDEO_CAPTURE_RESOLUTION), anyOrNull())).thenReturn("5")
+
+        sharedPreferences.migrateVideoCaptureResolution()
+
+        verify(editor, never()).putString(any(), anyOrNull())
+        verify(editor).putInt(VIDEO_CAPTURE_RESOLUTION_VERSION, 2)
+    }
+
+    @Test
+    fun `a migrated capture resolution of 1 should mean CIF`() {
+        whenever(sharedPreferences.getInt(eq(VIDEO_CAPTURE_RESOLUTION_VERSION), any())).thenReturn(2)
+        whenever(sharedPreferences.getString(eq(VIDEO_CAPTURE_RESOLUTION), anyOrNull())).thenReturn("1")
+
+        sharedPreferences.migrateVideoCaptureResolution()
+
+        verify(sharedPreferences, never()).edit()
+    }
+
+    private fun mockEditor() = mock<SharedPreferences.Editor>().also {
+        whenever(sharedPreferences.edit()).thenReturn(it)
+    }
+}
@@ -0,0 +1,86 @@
+package com.twilio.video.app.data.api
+
+import com.twilio.video.app.BaseUnitTest
+import java.util.concurrent.TimeUnit
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.test.runBlockingTest
+import okio.ByteString
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+
+@ExperimentalCoroutinesApi
+class TokenCacheTest : BaseUnitTest() {
+
+    private var nowMillis = TimeUnit.SECONDS.toMillis(1000)
+    private val tokenCache = TokenCache(expiryMarginMillis = 0, clock = { nowMillis })
+    private var requestCount = 0
+
+    @Test
+    fun `getToken should reuse a token until it expires`() = runBlockingTest {
+        val token = jwt(expiresAtSeconds = 2000)
+
+        tokenCache.getToken("identity", "room") { requestToken(token) }
+        nowMillis = TimeUnit.SECONDS.toMillis(1999)
+        val cachedToken = tokenCache.getToken("identity", "room") { requestToken(token) }
+
+        assertThat(cachedToken, equalTo(token))
+        assertThat(requestCount, equalTo(1))
+
+        nowMillis = TimeUnit.SECONDS.toMillis(2000)
+        tokenCache.getToken("identity", "room") { requestToken(token) }
+
+        assertThat(requestCount, equalTo(2))
+    }
+
+    @Test
+    fun `getToken should request a token per room`() = runBlockingTest {
+        tokenCache.getToken("identity", "room 1") { requestToken(jwt(2000)) }
+        tokenCache.getToken("identity", "room 2") { requestToken(jwt(2000)) }
+
+        assertThat(requestCount, equalTo(2))
+    }
+
+    @Test
+    fun `getToken should not wait for the request of another room`() = runBlockingTest {
+        val slowToken = CompletableDeferred<String>()
+        val slowRequest = launch { tokenCache.getToken("identity", "room 1") { slowToken.await() } }
+
+        val token = tokenCache.getToken("identity", "room 2") { requestToken(jwt(2000)) }
+
+        assertThat(token, equalTo(jwt(2000)))
+        assertThat(slowRequest.isActive, equalTo(true))
+        slowToken.complete(jwt(2000))
+    }
+
+    @Test
+    fun `getToken should share the request of the same room`() = runBlockingTest {
+        val token = CompletableDeferred<String>()
+        val firstRequest = launch { tokenCache.getToken("identity", "room") { requestToken(token.await()) } }
+        val secondRequest = launch { tokenCache.getToken("identity", "room") { requestToken(token.await()) } }
+
+        token.complete(jwt(2000))
+        firstRequest.join()
+        secondRequest.join()
+
+        assertThat(requestCount, equalTo(1))
+    }
+
+    @Test
+    fun `getToken should not cache a token without an expiry`() = runBlockingTest {
+        tokenCache.getToken("identity", "room") { requestToken("token") }
+        tokenCache.getToken("identity", "room") { requestToken("token") }
+
+        assertThat(requestCount, equalTo(2))
+    }
+
+    private fun requestToken(token: String): String {
+        requestCount++
+        return token
+    }
+
+    private fun jwt(expiresAtSeconds: Long) =
+            "header.${ByteString.encodeUtf8("{\"exp\":$expiresAtSeconds}").base64Url()}.signature"
+}
@@ -1,10 +1,13 @@
 package com.twilio.video.app.participant
 
 import com.twilio.video.LocalVideoTrack
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_ONE
 import com.twilio.video.RemoteVideoTrack
 import com.twilio.video.TrackPriority.HIGH
+import com.twilio.video.TrackPriority.LOW
 import com.twilio.video.VideoTrack
 import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.sdk.QualityLevel
 import com.twilio.video.app.sdk.VideoTrackViewState
 import junitparams.JUnitParamsRunner
 import org.hamcrest.CoreMatchers.`is`
@@ -16,6 +19,7 @@ import org.junit.Test
 import org.junit.runner.RunWith
 import org.mockito.kotlin.inOrder
 import org.mockito.kotlin.mock
+import org.mockito.kotlin.never
 import org.mockito.kotlin.times
 import org.mockito.kotlin.verify
 import org.mockito.kotlin.verifyZeroInteractions
@@ -276,6 +280,217 @@ class ParticipantManagerTest : BaseUnitTest() {
         }
     }
 
+    @Test
+    fun `updateNetworkQuality should update the participant in place without changing the thumbnail order`() {
+        setupThreeParticipantScenario()
+
+        participantManager.updateNetworkQuality("2", NETWORK_QUALITY_LEVEL_ONE)
+
+        val thumbnails = participantManager.participantThumbnails
+        assertThat(thumbnails.map { it.sid }, equalTo(listOf("1", "2", "3")))
+        assertThat(thumbnails[1].networkQualityLevel, equalTo(NETWORK_QUALITY_LEVEL_ONE))
+    }
+
+    @Test
+    fun `removeParticipant should assign the next remote participant to the primary view`() {
+        setupThreeParticipantScenario()
+
+        participantManager.removeParticipant("2")
+
+        assertThat(participantManager.primaryParticipant.sid, equalTo("3"))
+        assertThat(participantManager.getParticipant("2"), `is`(nullValue()))
+    }
+
+    @Test
+    fun `updateLocalParticipantSid should index the local participant by the new sid`() {
+        participantManager.updateLocalParticipantSid("1")
+
+        assertThat(participantManager.getParticipant("1")!!.isLocalParticipant, equalTo(true))
+        assertThat(participantManager.participantThumbnails.size, equalTo(1))
+    }
+
+    @Test
+    fun `clearing the pinned participant should fall back to the dominant speaker`() {
+        setupThreeParticipantScenario()
+        participantManager.changeDominantSpeaker("3")
+        participantManager.changePinnedParticipant("2")
+
+        participantManager.changePinnedParticipant("2")
+
+        assertThat(participantManager.primaryParticipant.sid, equalTo("3"))
+    }
+
+    @Test
+    fun `thumbnail VideoTrack priority should be low while subscriptions are reduced`() {
+        val participant3 = setupThreeParticipantScenario()
+
+        participantManager.qualityLevel = QualityLevel.REDUCED_SUBSCRIPTION
+
+        verify(participant3.getRemoteVideoTrack()!!).priority = LOW
+        verify(participantManager.primaryParticipant.getRemoteVideoTrack()!!, never()).priority = LOW
+    }
+
+    @Test
+    fun `thumbnail VideoTrack priority should be reset when subscriptions are no longer reduced`() {
+        val participant3 = setupThreeParticipantScenario()
+        participantManager.qualityLevel = QualityLevel.REDUCED_SUBSCRIPTION
+
+        participantManager.qualityLevel = QualityLevel.FULL
+
+        val videoTrack = participant3.getRemoteVideoTrack()!!
+        inOrder(videoTrack).run {
+            verify(videoTrack).priority = LOW
+            verify(videoTrack).priority = null
+        }
+    }
+
+    @Test
+    fun `a degraded thumbnail VideoTrack priority should be low until it recovers`() {
+        val participant3 = setupThreeParticipantScenario()
+        val videoTrack = participant3.getRemoteVideoTrack()!!
+
+        assertThat(participantManager.updateRenderQuality(videoTrack, true), `is`(true))
+        assertThat(participantManager.getParticipant("3")!!.isVideoDegraded, `is`(true))
+        participantManager.updateRenderQuality(videoTrack, false)
+
+        inOrder(videoTrack).run {
+            verify(videoTrack).priority = LOW
+            verify(videoTrack).priority = null
+        }
+    }
+
+    @Test
+    fun `a degraded primary participant VideoTrack priority should not be lowered`() {
+        setupThreeParticipantScenario()
+        val videoTrack = participantManager.primaryParticipant.getRemoteVideoTrack()!!
+
+        participantManager.updateRenderQuality(videoTrack, true)
+
+        assertThat(participantManager.primaryParticipant.isVideoDegraded, `is`(true))
+        verify(videoTrack, never()).priority = LOW
+    }
+
+    @Test
+    fun `a new VideoTrack should clear the degraded video of the participant`() {
+        val participant3 = setupThreeParticipantScenario()
+        participantManager.updateRenderQuality(participant3.getRemoteVideoTrack()!!, true)
+
+        participantManager.updateParticipantVideoTrack("3", VideoTrackViewState(mock<RemoteVideoTrack>()))
+
+        assertThat(participantManager.getParticipant("3")!!.isVideoDegraded, `is`(false))
+        assertThat(participantManager.updateRenderQuality(mock<RemoteVideoTrack>(), true), `is`(false))
+    }
+
+    @Test
+    fun `rejoinRemoteParticipants should keep the layout of the participants still in the room`() {
+        setupThreeParticipantScenario()
+        participantManager.changeDominantSpeaker("3")
+        val rejoinedTrack = mock<RemoteVideoTrack>()
+
+        participantManager.rejoinRemoteParticipants(listOf(
+                ParticipantViewState("3", "Participant 3"),
+                ParticipantViewState("4", "Participant 4")))
+        participantManager.updateParticipantVideoTrack("3", VideoTrackViewState(rejoinedTrack))
+
+        assertThat(participantManager.participantThumbnails.map { it.sid }, equalTo(listOf("1", "3", "4")))
+        assertThat(participantManager.primaryParticipant.sid, equalTo("3"))
+        assertThat(participantManager.primaryParticipant.isDominantSpeaker, `is`(true))
+        verify(rejoinedTrack).priority = HIGH
+    }
+
+    @Test
+    fun `the rejoined speaker VideoTrack priority should be reset once the room reports a dominant speaker`() {
+        setupThreeParticipantScenario()
+        participantManager.changeDominantSpeaker("3")
+        val rejoinedTrack = mock<RemoteVideoTrack>()
+        participantManager.rejoinRemoteParticipants(listOf(ParticipantViewState("2", "Participant 2"),
+                ParticipantViewState("3", "Participant 3")))
+        participantManager.updateParticipantVideoTrack("3", VideoTrackViewState(rejoinedTrack))
+
+        participantManager.changeDominantSpeaker("2")
+
+        inOrder(rejoinedTrack).run {
+            verify(rejoinedTrack).priority = HIGH
+            verify(rejoinedTrack).priority = null
+        }
+    }
+
+    @Test
+    fun `changePredictedSpeaker should assign the predicted speaker to the primary view without reordering`() {
+        setupThreeParticipantScenario()
+
+        participantManager.changePredictedSpeaker("3", null)
+
+        assertThat(participantManager.primaryParticipant.sid, equalTo("3"))
+        assertThat(participantManager.participantThumbnails.map { it.sid }, equalTo(listOf("1", "2", "3")))
+    }
+
+    @Test
+    fun `changePredictedSpeaker should set the VideoTrack priority of the next speaker to high`() {
+        val nextSpeaker = setupThreeParticipantScenario()
+
+        participantManager.changePredictedSpeaker("2", "3")
+
+        verify(nextSpeaker.getRemoteVideoTrack()!!).priority = HIGH
+    }
+
+    @Test
+    fun `the next speaker VideoTrack priority should be reset to low while subscriptions are reduced`() {
+        val nextSpeaker = setupThreeParticipantScenario()
+        val videoTrack = nextSpeaker.getRemoteVideoTrack()!!
+        participantManager.qualityLevel = QualityLevel.REDUCED_SUBSCRIPTION
+
+        participantManager.changePredictedSpeaker("2", "3")
+        participantManager.changeDominantSpeaker("2")
+
+        inOrder(videoTrack).run {
+            verify(videoTrack).priority = LOW
+            verify(videoTrack).priority = HIGH
+            verify(videoTrack).priority = LOW
+        }
+        verify(videoTrack, never()).priority = null
+    }
+
+    @Test
+    fun `the next speaker VideoTrack priority should be reset to low while its video is degraded`() {
+        val nextSpeaker = setupThreeParticipantScenario()
+        val videoTrack = nextSpeaker.getRemoteVideoTrack()!!
+        participantManager.updateRenderQuality(videoTrack, true)
+
+        participantManager.changePredictedSpeaker("2", "3")
+        participantManager.changePredictedSpeaker("2", null)
+
+        inOrder(videoTrack).run {
+            verify(videoTrack).priority = LOW
+            verify(videoTrack).priority = HIGH
+            verify(videoTrack).priority = LOW
+        }
+    }
+
+    @Test
+    fun `the next speaker VideoTrack priority should be cleared once it is no longer the next speaker`() {
+        val nextSpeaker = setupThreeParticipantScenario()
+        val videoTrack = nextSpeaker.getRemoteVideoTrack()!!
+
+        participantManager.changePredictedSpeaker("2", "3")
+        participantManager.changePredictedSpeaker("2", null)
+
+        inOrder(videoTrack).run {
+            verify(videoTrack).priority = HIGH
+            verify(videoTrack).priority = null
+        }
+    }
+
+    @Test
+    fun `changeDominantSpeaker should replace the predicted speaker`() {
+        setupThreeParticipantScenario()
+        participantManager.changePredictedSpeaker("3", null)
+
+        participantManager.changeDominantSpeaker("2")
+
+        assertThat(participantManager.primaryParticipant.sid, equalTo("2"))
+    }
+
     private fun setupExistingDominantSpeakerScenario() {
         val participant2 = ParticipantViewState("2", "Participant 2",
                 isDominantSpeaker = true)
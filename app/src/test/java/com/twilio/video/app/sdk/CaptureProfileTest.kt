@@ -0,0 +1,160 @@
+package com.twilio.video.app.sdk
+
+import android.content.SharedPreferences
+import com.twilio.video.H264Codec
+import com.twilio.video.VideoDimensions
+import com.twilio.video.Vp8Codec
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.data.Preferences
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.any
+import org.mockito.kotlin.anyOrNull
+import org.mockito.kotlin.doAnswer
+import org.mockito.kotlin.doReturn
+import org.mockito.kotlin.mock
+
+class CaptureProfileTest : BaseUnitTest() {
+
+    private val flagship = CaptureCapabilities(
+            cameraSizes = listOf(VideoDimensions(1920, 1080), VideoDimensions(1280, 720)),
+            maxCameraFrameRate = 60,
+            hardwareEncoders = setOf(Vp8Codec.NAME, H264Codec.NAME),
+            isLowRamDevice = false,
+            processorCount = 8)
+
+    @Test
+    fun `selectCaptureProfile should capture 720p at 30 fps on a flagship`() {
+        assertThat(selectCaptureProfile(flagship), equalTo(CaptureProfile(1280, 720, 30, Vp8Codec.NAME)))
+    }
+
+    @Test
+    fun `selectCaptureProfile should capture VGA at 15 fps on a low RAM device`() {
+        val capabilities = flagship.copy(isLowRamDevice = true)
+
+        assertThat(selectCaptureProfile(capabilities), equalTo(CaptureProfile(640, 480, 15)))
+    }
+
+    @Test
+    fun `selectCaptureProfile should capture VGA at 24 fps without hardware encoders on few cores`() {
+        val capabilities = flagship.copy(hardwareEncoders = emptySet(), processorCount = 4)
+
+        assertThat(selectCaptureProfile(capabilities), equalTo(CaptureProfile(640, 480, 24)))
+    }
+
+    @Test
+    fun `selectCaptureProfile should not exceed the camera sizes and frame rate`() {
+        val capabilities = flagship.copy(cameraSizes = listOf(VideoDimensions(800, 600)),
+                maxCameraFrameRate = 20)
+
+        assertThat(selectCaptureProfile(capabilities), equalTo(CaptureProfile(800, 480, 20)))
+    }
+
+    @Test
+    fun `selectCaptureProfile should pick H264 when only H264 is encoded in hardware`() {
+        val capabilities = flagship.copy(hardwareEncoders = setOf(H264Codec.NAME))
+
+        assertThat(selectCaptureProfile(capabilities).videoCodec, equalTo(H264Codec.NAME))
+    }
+
+    @Test
+    fun `downgradeCaptureProfile should lower the resolution before the frame rate`() {
+        val profiles = generateSequence(CaptureProfile(1280, 720, 30), ::downgradeCaptureProfile).toList()
+
+        assertThat(profiles, equalTo(listOf(
+                CaptureProfile(1280, 720, 30),
+                CaptureProfile(960, 540, 30),
+                CaptureProfile(800, 480, 30),
+                CaptureProfile(640, 480, 30),
+                CaptureProfile(352, 288, 30),
+                CaptureProfile(352, 288, 15))))
+    }
+
+    @Test
+    fun `governor should limit the format from the reduced capture quality level on`() {
+        val governor = CaptureFormatGovernor({ 0 }) {}
+        governor.govern(CaptureProfile(1280, 720, 30))
+
+        assertThat(governor.setQualityLevel(QualityLevel.REDUCED_CAPTURE), equalTo(REDUCED_CAPTURE_PROFILE))
+        assertThat(governor.govern(CaptureProfile(1280, 720, 30)), equalTo(REDUCED_CAPTURE_PROFILE))
+        assertThat(governor.setQualityLevel(QualityLevel.FULL), equalTo(CaptureProfile(1280, 720, 30)))
+    }
+
+    @Test
+    fun `governor should lower the base profile rather than the limited format`() {
+        val governor = CaptureFormatGovernor({ 0 }) {}
+        governor.govern(CaptureProfile(1280, 720, 30))
+
+        governor.setQualityLevel(QualityLevel.REDUCED_CAPTURE)
+        repeat(LOW_FRAME_RATE_SAMPLES) { governor.onFrameRate(5) }
+
+        assertThat(governor.setQualityLevel(QualityLevel.FULL), equalTo(CaptureProfile(960, 540, 30)))
+    }
+
+    @Test
+    fun `governor should lower the format after consecutive low frame rate samples`() {
+        val downgrades = mutableListOf<CaptureProfile>()
+        val governor = CaptureFormatGovernor({ 0 }) { downgrades.add(it) }
+        governor.govern(CaptureProfile(1280, 720, 30))
+
+        governor.onFrameRate(10)
+        governor.onFrameRate(10)
+        governor.onFrameRate(30)
+        governor.onFrameRate(10)
+        governor.onFrameRate(10)
+        assertThat(downgrades, equalTo(emptyList()))
+
+        governor.onFrameRate(10)
+        assertThat(downgrades, equalTo(listOf(CaptureProfile(960, 540, 30))))
+    }
+
+    @Test
+    fun `govern should return the downgraded format until the base profile changes`() {
+        val governor = CaptureFormatGovernor({ 0 }) {}
+        governor.govern(CaptureProfile(1280, 720, 30))
+        repeat(LOW_FRAME_RATE_SAMPLES) { governor.onFrameRate(10) }
+
+        assertThat(governor.govern(CaptureProfile(1280, 720, 30)), equalTo(CaptureProfile(960, 540, 30)))
+        assertThat(governor.govern(CaptureProfile(640, 480, 30)), equalTo(CaptureProfile(640, 480, 30)))
+    }
+
+    @Test
+    fun `store should probe once per build fingerprint`() {
+        val preferences = FakePreferences()
+        var probeCount = 0
+        val probe = { probeCount++; flagship }
+
+        CaptureProfileStore(preferences.sharedPreferences, "build 1", probe).get()
+        val cachedProfile = CaptureProfileStore(preferences.sharedPreferences, "build 1", probe).get()
+        assertThat(cachedProfile, equalTo(selectCaptureProfile(flagship)))
+        assertThat(probeCount, equalTo(1))
+
+        CaptureProfileStore(preferences.sharedPreferences, "build 2", probe).get()
+        assertThat(probeCount, equalTo(2))
+    }
+
+    @Test
+    fun `store should probe again when the cached profile is invalid`() {
+        val preferences = FakePreferences().apply { values[Preferences.CAPTURE_PROFILE] = "build 1;x" }
+
+        val profile = CaptureProfileStore(preferences.sharedPreferences, "build 1") { flagship }.get()
+
+        assertThat(profile, equalTo(selectCaptureProfile(flagship)))
+        assertThat(preferences.values[Preferences.CAPTURE_PROFILE], equalTo("build 1;1280;720;30;VP8"))
+    }
+
+    private class FakePreferences {
+        val values = mutableMapOf<String, String?>()
+        private val editor: SharedPreferences.Editor = mock {
+            on { putString(any(), anyOrNull()) } doAnswer {
+                values[it.getArgument(0)] = it.getArgument(1)
+                it.mock as SharedPreferences.Editor
+            }
+        }
+        val sharedPreferences: SharedPreferences = mock {
+            on { getString(any(), anyOrNull()) } doAnswer { values[it.getArgument(0)] }
+            on { edit() } doReturn editor
+        }
+    }
+}
@@ -0,0 +1,123 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.VideoTrack
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.sdk.JoinMilestone.CONNECT_OPTIONS_CREATED
+import com.twilio.video.app.sdk.JoinMilestone.CONNECT_OPTIONS_REQUESTED
+import com.twilio.video.app.sdk.JoinMilestone.FIRST_REMOTE_FRAME
+import com.twilio.video.app.sdk.JoinMilestone.JOIN_REQUESTED
+import com.twilio.video.app.sdk.JoinMilestone.ROOM_CONNECTED
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.argumentCaptor
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.never
+import org.mockito.kotlin.verify
+import tvi.webrtc.VideoFrame
+import tvi.webrtc.VideoSink
+
+class JoinTracerTest : BaseUnitTest() {
+
+    private var nowMillis = 1000L
+    private val joinTracer = JoinTracer({ it.run() }) { nowMillis }
+
+    @Test
+    fun `timeline should contain the time spent reaching every milestone`() {
+        joinTracer.start()
+        markAt(1100, CONNECT_OPTIONS_REQUESTED)
+        markAt(1400, CONNECT_OPTIONS_CREATED)
+        markAt(2400, ROOM_CONNECTED)
+        markAt(2500, FIRST_REMOTE_FRAME)
+
+        val timeline = joinTracer.timeline()
+
+        assertThat(timeline.totalMillis, equalTo(1500L))
+        assertThat(timeline.isComplete, equalTo(true))
+        assertThat(timeline.phaseMillis, equalTo(mapOf(
+                CONNECT_OPTIONS_REQUESTED to 100L,
+                CONNECT_OPTIONS_CREATED to 300L,
+                ROOM_CONNECTED to 1000L,
+                FIRST_REMOTE_FRAME to 100L)))
+        assertThat(joinTracer.isTracing, equalTo(false))
+    }
+
+    @Test
+    fun `mark should only count the first mark of a milestone`() {
+        joinTracer.start()
+        markAt(1100, ROOM_CONNECTED)
+        markAt(1500, ROOM_CONNECTED)
+
+        assertThat(joinTracer.timeline().marks, equalTo(listOf(
+                JoinMark(JOIN_REQUESTED, 0),
+                JoinMark(ROOM_CONNECTED, 100))))
+    }
+
+    @Test
+    fun `mark should be ignored before a join is started`() {
+        markAt(1100, ROOM_CONNECTED)
+
+        assertThat(joinTracer.timeline().marks, equalTo(emptyList()))
+    }
+
+    @Test
+    fun `finish should end an incomplete join`() {
+        joinTracer.start()
+        markAt(1100, ROOM_CONNECTED)
+
+        joinTracer.finish()
+        markAt(1200, FIRST_REMOTE_FRAME)
+
+        assertThat(joinTracer.timeline().isComplete, equalTo(false))
+        assertThat(joinTracer.timeline().export(),
+                equalTo("join total=100ms complete=false room_connected=100ms"))
+    }
+
+    @Test
+    fun `the first frame should remove the sinks of every traced track`() {
+        val firstTrack = mock<VideoTrack>()
+        val secondTrack = mock<VideoTrack>()
+        joinTracer.start()
+        joinTracer.traceFirstFrame(firstTrack)
+        joinTracer.traceFirstFrame(secondTrack)
+        val firstSink = addedSink(firstTrack)
+        val secondSink = addedSink(secondTrack)
+        verify(firstTrack, never()).removeSink(firstSink)
+
+        firstSink.onFrame(mock<VideoFrame>())
+
+        assertThat(joinTracer.timeline().isComplete, equalTo(true))
+        verify(firstTrack).removeSink(firstSink)
+        verify(secondTrack).removeSink(secondSink)
+    }
+
+    @Test
+    fun `finish should remove the sinks of a join without a remote frame`() {
+        val videoTrack = mock<VideoTrack>()
+        joinTracer.start()
+        joinTracer.traceFirstFrame(videoTrack)
+
+        joinTracer.finish()
+
+        verify(videoTrack).removeSink(addedSink(videoTrack))
+    }
+
+    @Test
+    fun `start should drop the timeline of the previous join`() {
+        joinTracer.start()
+        markAt(1100, ROOM_CONNECTED)
+        nowMillis = 5000
+
+        joinTracer.start()
+
+        assertThat(joinTracer.timeline().marks, equalTo(listOf(JoinMark(JOIN_REQUESTED, 0))))
+    }
+
+    private fun addedSink(videoTrack: VideoTrack): VideoSink =
+            argumentCaptor<VideoSink>().apply { verify(videoTrack).addSink(capture()) }.firstValue
+
+    private fun markAt(millis: Long, milestone: JoinMilestone) {
+        nowMillis = millis
+        joinTracer.mark(milestone)
+    }
+}
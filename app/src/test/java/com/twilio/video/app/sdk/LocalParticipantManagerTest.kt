@@ -0,0 +1,114 @@
+package com.twilio.video.app.sdk
+
+import android.content.Context
+import com.twilio.video.LocalParticipant
+import com.twilio.video.LocalVideoTrack
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.data.Settings
+import com.twilio.video.app.sdk.NativeObjectKind.CAMERA_CAPTURER
+import com.twilio.video.app.sdk.NativeObjectKind.LOCAL_VIDEO_TRACK
+import com.twilio.video.app.util.CameraCapturerCompat
+import kotlinx.coroutines.flow.MutableStateFlow
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Before
+import org.junit.Test
+import org.mockito.kotlin.any
+import org.mockito.kotlin.doReturn
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.never
+import org.mockito.kotlin.times
+import org.mockito.kotlin.verify
+import org.mockito.kotlin.whenever
+
+class LocalParticipantManagerTest : BaseUnitTest() {
+
+    private val nativeObjects = NativeObjectRegistry { 0 }
+    private val roomManager = mock<RoomManager> {
+        on { nativeObjects } doReturn nativeObjects
+    }
+    private val settings = MutableStateFlow(Settings(keepCameraAlive = true))
+    private val cameraCapturer = mock<CameraCapturerCompat>()
+    private val cameraVideoTrack = mock<LocalVideoTrack> {
+        on { name } doReturn CAMERA_TRACK_NAME
+        on { isEnabled } doReturn true
+    }
+    private val cameraTrackFactory = mock<CameraTrackFactory> {
+        on { createCapturer(any(), any()) } doReturn cameraCapturer
+        on { createTrack(any(), any(), any()) } doReturn cameraVideoTrack
+    }
+    private val localParticipant = mock<LocalParticipant>()
+    private val localParticipantManager = LocalParticipantManager(
+            mock<Context> { on { getString(any()) } doReturn "Camera" },
+            roomManager,
+            settings,
+            mock { on { get() } doReturn CaptureProfile(1280, 720, 24) },
+            cameraTrackFactory = cameraTrackFactory)
+
+    @Before
+    fun setUp() {
+        localParticipantManager.localParticipant = localParticipant
+        // The audio track is native, only the camera is under test
+        localParticipantManager.toggleLocalAudio()
+    }
+
+    @Test
+    fun `a paused camera should keep its capturer and track`() {
+        localParticipantManager.onResume()
+        localParticipantManager.onPause()
+
+        verify(cameraCapturer).stopCapture()
+        verify(cameraVideoTrack).enable(false)
+        verify(localParticipant, never()).unpublishTrack(any<LocalVideoTrack>())
+        assertThat(nativeObjects.liveCount(CAMERA_CAPTURER), equalTo(1))
+        assertThat(nativeObjects.liveCount(LOCAL_VIDEO_TRACK), equalTo(1))
+    }
+
+    @Test
+    fun `a resumed camera should capture again with the same capturer`() {
+        localParticipantManager.onResume()
+        localParticipantManager.onPause()
+        localParticipantManager.onResume()
+
+        verify(cameraCapturer).startCapture(1280, 720, 24)
+        verify(cameraVideoTrack).enable(true)
+        verify(cameraTrackFactory, times(1)).createCapturer(any(), any())
+        verify(cameraTrackFactory, times(1)).createTrack(any(), any(), any())
+    }
+
+    @Test
+    fun `a camera that was disabled before the pause should stay disabled once resumed`() {
+        whenever(cameraVideoTrack.isEnabled).thenReturn(false)
+        localParticipantManager.onResume()
+        localParticipantManager.onPause()
+        localParticipantManager.onResume()
+
+        verify(cameraVideoTrack, never()).enable(any())
+        verify(cameraCapturer).startCapture(1280, 720, 24)
+    }
+
+    @Test
+    fun `a switched camera should keep its capturer`() {
+        localParticipantManager.onResume()
+        localParticipantManager.switchCamera()
+
+        verify(cameraCapturer).switchCamera()
+        verify(cameraTrackFactory, times(1)).createCapturer(any(), any())
+    }
+
+    @Test
+    fun `a paused camera should be released without keep alive`() {
+        settings.value = Settings(keepCameraAlive = false)
+        localParticipantManager.onResume()
+        localParticipantManager.onPause()
+
+        verify(localParticipant).unpublishTrack(cameraVideoTrack)
+        verify(cameraCapturer).dispose()
+        verify(cameraVideoTrack).release()
+        assertThat(nativeObjects.liveCount(CAMERA_CAPTURER), equalTo(0))
+
+        localParticipantManager.onResume()
+
+        verify(cameraTrackFactory, times(2)).createCapturer(any(), any())
+    }
+}
@@ -0,0 +1,81 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_FOUR
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_ONE
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_TWO
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.CoreMatchers.nullValue
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+
+class LowBandwidthDetectorTest : BaseUnitTest() {
+
+    private var nowMillis = 0L
+    private val detector = LowBandwidthDetector({ nowMillis }, recoveryDelayMillis = 1000)
+
+    @Test
+    fun `should enter the low bandwidth mode on a poor network quality level`() {
+        assertThat(detector.onNetworkQualityLevel(NETWORK_QUALITY_LEVEL_TWO), nullValue())
+        assertThat(detector.onNetworkQualityLevel(NETWORK_QUALITY_LEVEL_ONE), equalTo(true))
+    }
+
+    @Test
+    fun `should enter the low bandwidth mode on a high packet loss`() {
+        assertThat(detector.onPacketLoss(5.0), nullValue())
+        assertThat(detector.onPacketLoss(LOW_BANDWIDTH_ENTER_PACKET_LOSS_PERCENT), equalTo(true))
+    }
+
+    @Test
+    fun `should not enter the low bandwidth mode on a single lossy remote track`() {
+        val trackRates = listOf(
+                trackStatsRates(packetLossPercent = 1.0, isLocal = true),
+                trackStatsRates(packetLossPercent = 40.0),
+                trackStatsRates(packetLossPercent = 0.0),
+                trackStatsRates(packetLossPercent = 2.0))
+
+        assertThat(detector.onTrackRates(trackRates), nullValue())
+    }
+
+    @Test
+    fun `should enter the low bandwidth mode on a lossy local track`() {
+        val trackRates = listOf(
+                trackStatsRates(packetLossPercent = 15.0, isLocal = true),
+                trackStatsRates(packetLossPercent = 0.0))
+
+        assertThat(detector.onTrackRates(trackRates), equalTo(true))
+    }
+
+    @Test
+    fun `packetLoss should take the median of the remote tracks`() {
+        val trackRates = listOf(1.0, 40.0, 3.0, 0.0).map { trackStatsRates(packetLossPercent = it) }
+
+        assertThat(packetLoss(trackRates), equalTo(PacketLoss(sendPercent = 0.0, receivePercent = 2.0)))
+    }
+
+    @Test
+    fun `should only leave the low bandwidth mode after a sustained recovery`() {
+        detector.onNetworkQualityLevel(NETWORK_QUALITY_LEVEL_ONE)
+
+        assertThat(detector.onNetworkQualityLevel(NETWORK_QUALITY_LEVEL_TWO), nullValue())
+        assertThat(detector.onNetworkQualityLevel(NETWORK_QUALITY_LEVEL_FOUR), nullValue())
+        nowMillis = 500
+        assertThat(detector.onPacketLoss(LOW_BANDWIDTH_EXIT_PACKET_LOSS_PERCENT), nullValue())
+        assertThat(detector.onPacketLoss(1.0), nullValue())
+        nowMillis = 1499
+        assertThat(detector.onPacketLoss(1.0), nullValue())
+        nowMillis = 1500
+        assertThat(detector.onPacketLoss(1.0), equalTo(false))
+        assertThat(detector.isLowBandwidth, equalTo(false))
+    }
+
+    @Test
+    fun `lowBandwidthVideoBitrate should cap the configured bitrate`() {
+        assertThat(lowBandwidthVideoBitrate(0), equalTo(LOW_BANDWIDTH_MAX_VIDEO_BITRATE))
+        assertThat(lowBandwidthVideoBitrate(1000), equalTo(LOW_BANDWIDTH_MAX_VIDEO_BITRATE))
+        assertThat(lowBandwidthVideoBitrate(100), equalTo(100))
+    }
+
+    private fun trackStatsRates(packetLossPercent: Double, isLocal: Boolean = false) =
+            TrackStatsRates(500, packetLossPercent, frameRateTrend = 0, jitterP95 = 0, isLocal = isLocal)
+}
@@ -0,0 +1,84 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.sdk.NativeObjectKind.CAMERA_CAPTURER
+import com.twilio.video.app.sdk.NativeObjectKind.LOCAL_VIDEO_TRACK
+import com.twilio.video.app.sdk.NativeObjectKind.REMOTE_PARTICIPANT
+import com.twilio.video.app.sdk.NativeObjectKind.REMOTE_VIDEO_TRACK
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+
+class NativeObjectRegistryTest : BaseUnitTest() {
+
+    private val registry = NativeObjectRegistry { 4096 }
+    private val releasedObjects = mutableListOf<String>()
+
+    @Test
+    fun `release should release a registered object once`() {
+        registry.register(LOCAL_VIDEO_TRACK, "camera") { releasedObjects.add("camera") }
+
+        registry.release("camera")
+        registry.release("camera")
+
+        assertThat(releasedObjects, equalTo(listOf("camera")))
+        assertThat(registry.liveCount(LOCAL_VIDEO_TRACK), equalTo(0))
+    }
+
+    @Test
+    fun `unregister should forget an object without releasing it`() {
+        registry.register(REMOTE_VIDEO_TRACK, "video") { releasedObjects.add("video") }
+
+        registry.unregister("video")
+
+        assertThat(releasedObjects, equalTo(emptyList()))
+        assertThat(registry.liveCount(REMOTE_VIDEO_TRACK), equalTo(0))
+    }
+
+    @Test
+    fun `releaseAll should only release the objects of the given kinds`() {
+        registry.register(LOCAL_VIDEO_TRACK, "camera") { releasedObjects.add("camera") }
+        registry.register(REMOTE_PARTICIPANT, "participant") { releasedObjects.add("participant") }
+        registry.register(REMOTE_VIDEO_TRACK, "video") { releasedObjects.add("video") }
+
+        val releasedCount = registry.releaseAll(REMOTE_NATIVE_OBJECT_KINDS)
+
+        assertThat(releasedCount, equalTo(2))
+        assertThat(releasedObjects.sorted(), equalTo(listOf("participant", "video")))
+        assertThat(registry.liveCount(LOCAL_VIDEO_TRACK), equalTo(1))
+    }
+
+    @Test
+    fun `releaseAll should release objects whose owner lost track of them`() {
+        registry.register(CAMERA_CAPTURER, "first capturer") { releasedObjects.add("first capturer") }
+        registry.register(CAMERA_CAPTURER, "second capturer") { releasedObjects.add("second capturer") }
+        registry.release("second capturer")
+
+        registry.releaseAll(LOCAL_NATIVE_OBJECT_KINDS)
+
+        assertThat(releasedObjects, equalTo(listOf("second capturer", "first capturer")))
+        assertThat(registry.liveCount(CAMERA_CAPTURER), equalTo(0))
+    }
+
+    @Test
+    fun `snapshot should report the live counts and the native heap`() {
+        registry.register(REMOTE_PARTICIPANT, "first participant")
+        registry.register(REMOTE_PARTICIPANT, "second participant")
+        registry.register(LOCAL_VIDEO_TRACK, "camera")
+
+        val snapshot = registry.snapshot()
+
+        assertThat(snapshot.liveCounts, equalTo(mapOf(REMOTE_PARTICIPANT to 2, LOCAL_VIDEO_TRACK to 1)))
+        assertThat(snapshot.liveCount(CAMERA_CAPTURER), equalTo(0))
+        assertThat(snapshot.nativeHeapAllocatedBytes, equalTo(4096L))
+    }
+
+    @Test
+    fun `format should list the native heap and the live count of every kind`() {
+        registry.register(REMOTE_PARTICIPANT, "participant")
+
+        assertThat(registry.snapshot().format(separator = "\n"), equalTo("native heap: 4 KiB\n" +
+                "local_audio_track: 0\nlocal_video_track: 0\ncamera_capturer: 0\n" +
+                "remote_participant: 1\nremote_video_track: 0"))
+    }
+}
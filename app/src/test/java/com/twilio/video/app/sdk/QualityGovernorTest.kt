@@ -0,0 +1,72 @@
+package com.twilio.video.app.sdk
+
+import android.os.PowerManager
+import com.twilio.video.app.BaseUnitTest
+import junitparams.JUnitParamsRunner
+import junitparams.Parameters
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.CoreMatchers.nullValue
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@RunWith(JUnitParamsRunner::class)
+class QualityGovernorTest : BaseUnitTest() {
+
+    private var nowMillis = 0L
+    private val stepper = QualityLevelStepper({ nowMillis }, recoveryDelayMillis = 1000)
+
+    @Test
+    @Parameters(method = "conditionsParams")
+    fun `targetQualityLevel should degrade with the thermal status and the battery level`(
+        conditions: DeviceConditions,
+        expectedLevel: QualityLevel
+    ) {
+        assertThat(targetQualityLevel(conditions), equalTo(expectedLevel))
+    }
+
+    @Test
+    fun `update should degrade right away`() {
+        assertThat(stepper.update(DeviceConditions(PowerManager.THERMAL_STATUS_SEVERE)),
+                equalTo(QualityLevel.NO_THUMBNAILS))
+    }
+
+    @Test
+    fun `update should recover one level at a time after the recovery delay`() {
+        stepper.update(DeviceConditions(PowerManager.THERMAL_STATUS_SEVERE))
+        val coolConditions = DeviceConditions(PowerManager.THERMAL_STATUS_NONE)
+
+        nowMillis = 999
+        assertThat(stepper.update(coolConditions), nullValue())
+        assertThat(stepper.isRecoveryPending(coolConditions), equalTo(true))
+
+        nowMillis = 1000
+        assertThat(stepper.update(coolConditions), equalTo(QualityLevel.REDUCED_SUBSCRIPTION))
+        nowMillis = 2000
+        assertThat(stepper.update(coolConditions), equalTo(QualityLevel.REDUCED_CAPTURE))
+        nowMillis = 3000
+        assertThat(stepper.update(coolConditions), equalTo(QualityLevel.FULL))
+        assertThat(stepper.isRecoveryPending(coolConditions), equalTo(false))
+    }
+
+    @Test
+    fun `update should not change the level for the same conditions`() {
+        val conditions = DeviceConditions(batteryPercent = 15)
+        stepper.update(conditions)
+
+        assertThat(stepper.update(conditions), nullValue())
+        assertThat(stepper.level, equalTo(QualityLevel.REDUCED_SUBSCRIPTION))
+    }
+
+    private fun conditionsParams() = arrayOf(
+            arrayOf(DeviceConditions(), QualityLevel.FULL),
+            arrayOf(DeviceConditions(PowerManager.THERMAL_STATUS_LIGHT, 80), QualityLevel.REDUCED_CAPTURE),
+            arrayOf(DeviceConditions(PowerManager.THERMAL_STATUS_MODERATE, 80), QualityLevel.REDUCED_SUBSCRIPTION),
+            arrayOf(DeviceConditions(PowerManager.THERMAL_STATUS_SEVERE, 80), QualityLevel.NO_THUMBNAILS),
+            arrayOf(DeviceConditions(PowerManager.THERMAL_STATUS_CRITICAL, 80), QualityLevel.AUDIO_ONLY),
+            arrayOf(DeviceConditions(batteryPercent = 20), QualityLevel.REDUCED_CAPTURE),
+            arrayOf(DeviceConditions(batteryPercent = 5), QualityLevel.AUDIO_ONLY),
+            arrayOf(DeviceConditions(batteryPercent = 5, isCharging = true), QualityLevel.FULL),
+            arrayOf(DeviceConditions(PowerManager.THERMAL_STATUS_LIGHT, 10), QualityLevel.NO_THUMBNAILS)
+    )
+}
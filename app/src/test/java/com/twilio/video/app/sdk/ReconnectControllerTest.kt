@@ -0,0 +1,67 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.TwilioException.ACCESS_TOKEN_EXPIRED_EXCEPTION
+import com.twilio.video.TwilioException.ROOM_MAX_PARTICIPANTS_EXCEEDED_EXCEPTION
+import com.twilio.video.TwilioException.SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.`is`
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.CoreMatchers.nullValue
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+
+class ReconnectControllerTest : BaseUnitTest() {
+
+    private val controller = ReconnectController(maxRejoinAttempts = 2, backoffMillis = 100)
+
+    @Test
+    fun `onDisconnected should not rejoin without an error`() {
+        assertThat(controller.onDisconnected(null), nullValue())
+        assertThat(controller.isRejoining, `is`(false))
+    }
+
+    @Test
+    fun `onDisconnected should not rejoin after an error that is not a network error`() {
+        assertThat(controller.onDisconnected(ROOM_MAX_PARTICIPANTS_EXCEEDED_EXCEPTION), nullValue())
+    }
+
+    @Test
+    fun `onDisconnected should rejoin after a network error`() {
+        assertThat(controller.onDisconnected(SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION), equalTo(100L))
+        assertThat(controller.isRejoining, `is`(true))
+        assertThat(controller.rejoinAttempts, equalTo(1))
+    }
+
+    @Test
+    fun `onConnectFailure should back off until the attempts are exhausted`() {
+        controller.onDisconnected(SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION)
+
+        assertThat(controller.onConnectFailure(ACCESS_TOKEN_EXPIRED_EXCEPTION), equalTo(200L))
+        assertThat(controller.onConnectFailure(SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION), nullValue())
+        assertThat(controller.isRejoining, `is`(false))
+    }
+
+    @Test
+    fun `onConnectFailure should not retry a first connect`() {
+        assertThat(controller.onConnectFailure(SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION), nullValue())
+    }
+
+    @Test
+    fun `onConnected should reset the attempts`() {
+        controller.onDisconnected(SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION)
+        controller.onConnected()
+
+        assertThat(controller.onDisconnected(SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION), equalTo(100L))
+    }
+
+    @Test
+    fun `a requested disconnect should stop rejoining`() {
+        controller.onDisconnected(SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION)
+        controller.onDisconnectRequested()
+
+        assertThat(controller.onConnectFailure(SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION), nullValue())
+
+        controller.onConnecting()
+        assertThat(controller.onDisconnected(SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION), equalTo(100L))
+    }
+}
@@ -0,0 +1,121 @@
+package com.twilio.video.app.sdk
+
+import androidx.test.core.app.ApplicationProvider
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import com.twilio.video.LocalParticipant
+import com.twilio.video.RemoteParticipant
+import com.twilio.video.Room
+import com.twilio.video.TwilioException
+import com.twilio.video.TwilioException.SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.data.Settings
+import com.twilio.video.app.sdk.NativeObjectKind.REMOTE_PARTICIPANT
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.test.TestCoroutineDispatcher
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.mockito.kotlin.any
+import org.mockito.kotlin.argumentCaptor
+import org.mockito.kotlin.doReturn
+import org.mockito.kotlin.eq
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.never
+import org.mockito.kotlin.verify
+import org.mockito.kotlin.verifyBlocking
+import org.mockito.kotlin.whenever
+
+@ExperimentalCoroutinesApi
+@RunWith(AndroidJUnit4::class)
+class RoomManagerTest : BaseUnitTest() {
+
+    private val testDispatcher = TestCoroutineDispatcher()
+    private val videoClient = mock<VideoClient>()
+    private val nativeObjects = NativeObjectRegistry { 0 }
+    private val roomManager = RoomManager(
+            ApplicationProvider.getApplicationContext(),
+            lazyOf(videoClient),
+            testDispatcher,
+            settings = MutableStateFlow(Settings()),
+            captureProfileStore = mock(),
+            nativeObjects = nativeObjects).apply {
+        localParticipantManager = mock()
+    }
+
+    @Test
+    fun `a lost room should drop its remote objects before it is rejoined`() = testDispatcher.runBlockingTest {
+        val lostRoom = room(remoteParticipantCount = 2)
+        val rejoinedRoom = room(remoteParticipantCount = 1)
+        val roomListener = connect(lostRoom)
+        whenever(videoClient.rejoin(any())).thenReturn(rejoinedRoom)
+        assertThat(nativeObjects.liveCount(REMOTE_PARTICIPANT), equalTo(2))
+
+        roomListener.onDisconnected(lostRoom, TwilioException(SIGNALING_CONNECTION_DISCONNECTED_EXCEPTION,
+                "Signaling connection disconnected", null))
+
+        assertThat(nativeObjects.liveCount(REMOTE_PARTICIPANT), equalTo(0))
+
+        advanceUntilIdle()
+        roomListener.onConnected(rejoinedRoom)
+
+        assertThat(nativeObjects.liveCount(REMOTE_PARTICIPANT), equalTo(1))
+    }
+
+    @Test
+    fun `a room left for good should drop its remote objects`() = testDispatcher.runBlockingTest {
+        val room = room(remoteParticipantCount = 2)
+        val roomListener = connect(room)
+
+        roomListener.onDisconnected(room, null)
+
+        assertThat(nativeObjects.liveCount(REMOTE_PARTICIPANT), equalTo(0))
+    }
+
+    @Test
+    fun `a cancelled preconnect should disconnect its standby room`() = testDispatcher.runBlockingTest {
+        connect(room(remoteParticipantCount = 0))
+        val standbyRoom = mock<Room>()
+        whenever(videoClient.preconnect(eq("identity"), eq("breakout"), any())).thenReturn(standbyRoom)
+
+        roomManager.preconnect("breakout")
+        advanceUntilIdle()
+        roomManager.cancelPreconnect()
+
+        verify(standbyRoom).disconnect()
+    }
+
+    @Test
+    fun `a preconnect the call is switching to should not be cancelled`() = testDispatcher.runBlockingTest {
+        connect(room(remoteParticipantCount = 0))
+        val standbyRoom = mock<Room>()
+        whenever(videoClient.preconnect(eq("identity"), eq("breakout"), any())).thenReturn(standbyRoom)
+
+        roomManager.preconnect("breakout")
+        advanceUntilIdle()
+        roomManager.switchRoom("breakout")
+        roomManager.cancelPreconnect()
+
+        verify(standbyRoom, never()).disconnect()
+    }
+
+    private suspend fun connect(room: Room): Room.Listener {
+        roomManager.connect("identity", "room")
+        val roomListener = argumentCaptor<Room.Listener>().apply {
+            verifyBlocking(videoClient) { connect(eq("identity"), eq("room"), capture()) }
+        }.firstValue
+        roomListener.onConnected(room)
+        return roomListener
+    }
+
+    private fun room(remoteParticipantCount: Int): Room {
+        val localParticipant = mock<LocalParticipant>()
+        val remoteParticipants = List(remoteParticipantCount) { mock<RemoteParticipant>() }
+        return mock {
+            on { name } doReturn "room"
+            on { this.localParticipant } doReturn localParticipant
+            on { this.remoteParticipants } doReturn remoteParticipants
+        }
+    }
+}
@@ -0,0 +1,56 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.CoreMatchers.nullValue
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+
+class SpeakerDetectorTest : BaseUnitTest() {
+
+    private var nowMillis = 0L
+    private val detector = SpeakerDetector({ nowMillis }, holdMillis = 1000)
+
+    @Test
+    fun `should predict the loudest participant`() {
+        assertThat(detector.onAudioLevels(mapOf("1" to 5000, "2" to 100)),
+                equalTo(SpeakerPrediction("1", null)))
+    }
+
+    @Test
+    fun `should not predict a speaker below the minimum level`() {
+        assertThat(detector.onAudioLevels(mapOf("1" to 500, "2" to 100)), nullValue())
+    }
+
+    @Test
+    fun `should hold the speaker and prewarm the next one`() {
+        detector.onAudioLevels(mapOf("1" to 5000, "2" to 0))
+
+        nowMillis = 500
+        assertThat(detector.onAudioLevels(mapOf("1" to 0, "2" to 20000)),
+                equalTo(SpeakerPrediction("1", "2")))
+        nowMillis = 1000
+        assertThat(detector.onAudioLevels(mapOf("1" to 0, "2" to 20000)),
+                equalTo(SpeakerPrediction("2", null)))
+    }
+
+    @Test
+    fun `should not switch to a participant that is not clearly louder`() {
+        detector.onAudioLevels(mapOf("1" to 10000, "2" to 0))
+        nowMillis = 1000
+
+        assertThat(detector.onAudioLevels(mapOf("1" to 10000, "2" to 24000)),
+                equalTo(SpeakerPrediction("1", "2")))
+    }
+
+    @Test
+    fun `onDominantSpeaker should replace the prediction`() {
+        detector.onAudioLevels(mapOf("1" to 5000, "2" to 0))
+        nowMillis = 1000
+
+        detector.onDominantSpeaker("2")
+
+        assertThat(detector.onAudioLevels(mapOf("1" to 5000, "2" to 0)),
+                equalTo(SpeakerPrediction("2", "1")))
+    }
+}
@@ -0,0 +1,94 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.RemoteAudioTrack
+import com.twilio.video.RemoteAudioTrackPublication
+import com.twilio.video.RemoteParticipant
+import com.twilio.video.Room
+import com.twilio.video.TwilioException
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.any
+import org.mockito.kotlin.argumentCaptor
+import org.mockito.kotlin.doReturn
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.never
+import org.mockito.kotlin.verify
+import org.mockito.kotlin.verifyNoInteractions
+
+class StandbyRoomTest : BaseUnitTest() {
+
+    private val roomListener = mock<Room.Listener>()
+    private val connectedRooms = mutableListOf<StandbyRoom>()
+    private val failures = mutableListOf<Pair<StandbyRoom, TwilioException?>>()
+    private val standbyRoom = StandbyRoom("Breakout Room", roomListener,
+            { connectedRooms.add(it) }, { standbyRoom, e -> failures.add(standbyRoom to e) })
+    private val audioTrack = mock<RemoteAudioTrack>()
+    private val audioTrackPublication = mock<RemoteAudioTrackPublication> {
+        on { remoteAudioTrack } doReturn audioTrack
+    }
+    private val remoteParticipant = mock<RemoteParticipant> {
+        on { remoteAudioTracks } doReturn listOf(audioTrackPublication)
+    }
+    private val room = mock<Room> {
+        on { name } doReturn "Breakout Room"
+        on { remoteParticipants } doReturn listOf(remoteParticipant)
+    }
+
+    @Test
+    fun `a connected standby room should keep its events and audio to itself`() {
+        standbyRoom.onConnected(room)
+        standbyRoom.onDominantSpeakerChanged(room, remoteParticipant)
+        standbyRoom.onParticipantDisconnected(room, remoteParticipant)
+
+        val participantListener = argumentCaptor<RemoteParticipant.Listener>()
+        verify(remoteParticipant).setListener(participantListener.capture())
+        participantListener.firstValue.onAudioTrackSubscribed(remoteParticipant,
+                audioTrackPublication, audioTrack)
+        verify(audioTrack).enablePlayback(false)
+        verifyNoInteractions(roomListener)
+        assertThat(connectedRooms, equalTo(listOf(standbyRoom)))
+        assertThat(standbyRoom.isConnected, equalTo(true))
+    }
+
+    @Test
+    fun `an activated standby room should play its audio and hand its events to the room listener`() {
+        standbyRoom.onConnected(room)
+
+        standbyRoom.activate()
+        standbyRoom.onDominantSpeakerChanged(room, remoteParticipant)
+        standbyRoom.onDisconnected(room, null)
+
+        verify(audioTrack).enablePlayback(true)
+        verify(roomListener).onDominantSpeakerChanged(room, remoteParticipant)
+        verify(roomListener).onDisconnected(room, null)
+        assertThat(failures, equalTo(emptyList()))
+    }
+
+    @Test
+    fun `a standby room disconnected while connecting should leave as soon as it is connected`() {
+        standbyRoom.disconnect()
+
+        standbyRoom.onConnected(room)
+        standbyRoom.onDisconnected(room, null)
+
+        verify(room).disconnect()
+        verify(remoteParticipant, never()).setListener(any())
+        assertThat(connectedRooms, equalTo(emptyList()))
+        assertThat(failures, equalTo(emptyList()))
+    }
+
+    @Test
+    fun `a lost standby room should be reported as failed`() {
+        val twilioException = mock<TwilioException>()
+        standbyRoom.onConnected(room)
+
+        standbyRoom.onDisconnected(room, twilioException)
+
+        assertThat(failures, equalTo(listOf<Pair<StandbyRoom, TwilioException?>>(
+                standbyRoom to twilioException)))
+        assertThat(standbyRoom.isConnected, equalTo(false))
+        verifyNoInteractions(roomListener)
+    }
+}
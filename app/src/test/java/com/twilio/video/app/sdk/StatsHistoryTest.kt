@@ -0,0 +1,55 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+
+class StatsHistoryTest : BaseUnitTest() {
+
+    private val statsHistory = StatsHistory(capacity = 4, windowMillis = 10_000)
+
+    @Test
+    fun `rates should not count the lost packets of a local track twice`() {
+        statsHistory.recordTrack("local", isLocal = true, 0, bytes = 0, packets = 0, packetsLost = 0)
+        statsHistory.recordTrack("local", isLocal = true, 1000, bytes = 1000, packets = 100,
+                packetsLost = 10)
+
+        assertThat(statsHistory.rates().getValue("local").packetLossPercent, equalTo(10.0))
+        assertThat(statsHistory.rates().getValue("local").isLocal, equalTo(true))
+    }
+
+    @Test
+    fun `rates should count the lost packets of a remote track on top of the received ones`() {
+        statsHistory.recordTrack("remote", isLocal = false, 0, bytes = 0, packets = 0, packetsLost = 0)
+        statsHistory.recordTrack("remote", isLocal = false, 1000, bytes = 1000, packets = 90,
+                packetsLost = 10)
+
+        assertThat(statsHistory.rates().getValue("remote").packetLossPercent, equalTo(10.0))
+        assertThat(statsHistory.rates().getValue("remote").isLocal, equalTo(false))
+    }
+
+    @Test
+    fun `record should drop the tracks missing from the reports`() {
+        statsHistory.recordTrack("remote", isLocal = false, 0, bytes = 0, packets = 0, packetsLost = 0)
+        statsHistory.recordTrack("remote", isLocal = false, 1000, bytes = 1000, packets = 10, packetsLost = 0)
+
+        assertThat(statsHistory.record(emptyList(), 2000), equalTo(emptyMap()))
+        assertThat(statsHistory.export(), equalTo(StatsHistory.EXPORT_HEADER))
+    }
+
+    @Test
+    fun `export should write a line per track with rates sorted by sid`() {
+        for (trackSid in listOf("b", "a")) {
+            statsHistory.recordTrack(trackSid, isLocal = false, 0, bytes = 0, packets = 0, packetsLost = 0,
+                    jitter = 4)
+            statsHistory.recordTrack(trackSid, isLocal = false, 1000, bytes = 125_000, packets = 95,
+                    packetsLost = 5, frameRate = 24, jitter = 8)
+        }
+        statsHistory.recordTrack("c", isLocal = false, 0, bytes = 0, packets = 0, packetsLost = 0)
+
+        assertThat(statsHistory.export(), equalTo(StatsHistory.EXPORT_HEADER +
+                "\na,2,1000,5.00,24,8" +
+                "\nb,2,1000,5.00,24,8"))
+    }
+}
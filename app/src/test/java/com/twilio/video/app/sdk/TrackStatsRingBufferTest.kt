@@ -0,0 +1,74 @@
+package com.twilio.video.app.sdk
+
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.CoreMatchers.nullValue
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+
+class TrackStatsRingBufferTest : BaseUnitTest() {
+
+    private val ringBuffer = TrackStatsRingBuffer(capacity = 4)
+
+    @Test
+    fun `rates should be null until two samples are recorded`() {
+        ringBuffer.add(0, bytes = 0, packets = 0, packetsLost = 0)
+
+        assertThat(ringBuffer.rates(), nullValue())
+    }
+
+    @Test
+    fun `rates should be derived from the deltas of the counters`() {
+        ringBuffer.add(0, bytes = 0, packets = 0, packetsLost = 0, frameRate = 30)
+        ringBuffer.add(1000, bytes = 125_000, packets = 95, packetsLost = 5, frameRate = 24)
+
+        assertThat(ringBuffer.rates(), equalTo(TrackStatsRates(
+                bitrateKbps = 1000,
+                packetLossPercent = 5.0,
+                frameRateTrend = -6,
+                jitterP95 = 0)))
+    }
+
+    @Test
+    fun `rates of a local track should take the lost packets as part of the sent ones`() {
+        val ringBuffer = TrackStatsRingBuffer(capacity = 4, isLocal = true)
+        ringBuffer.add(0, bytes = 0, packets = 0, packetsLost = 0)
+        ringBuffer.add(1000, bytes = 1000, packets = 100, packetsLost = 5)
+
+        assertThat(ringBuffer.rates()?.packetLossPercent, equalTo(5.0))
+    }
+
+    @Test
+    fun `rates should only use the samples of the window`() {
+        ringBuffer.add(0, bytes = 0, packets = 0, packetsLost = 0)
+        ringBuffer.add(1000, bytes = 1000, packets = 10, packetsLost = 0)
+        ringBuffer.add(2000, bytes = 3000, packets = 20, packetsLost = 0)
+
+        assertThat(ringBuffer.rates(windowMillis = 1000)?.bitrateKbps, equalTo(16L))
+    }
+
+    @Test
+    fun `add should overwrite the oldest sample once full`() {
+        for (second in 0L..5L) {
+            ringBuffer.add(second * 1000, bytes = second * 1000, packets = second, packetsLost = 0,
+                    jitter = second.toInt())
+        }
+
+        assertThat(ringBuffer.size, equalTo(4))
+        assertThat(ringBuffer.rates(windowMillis = 60_000), equalTo(TrackStatsRates(
+                bitrateKbps = 8,
+                packetLossPercent = 0.0,
+                frameRateTrend = 0,
+                jitterP95 = 5)))
+    }
+
+    @Test
+    fun `add should clear the history when a counter goes backwards`() {
+        ringBuffer.add(0, bytes = 5000, packets = 50, packetsLost = 0)
+        ringBuffer.add(1000, bytes = 6000, packets = 60, packetsLost = 0)
+        ringBuffer.add(2000, bytes = 100, packets = 1, packetsLost = 0)
+
+        assertThat(ringBuffer.size, equalTo(1))
+        assertThat(ringBuffer.rates(), nullValue())
+    }
+}
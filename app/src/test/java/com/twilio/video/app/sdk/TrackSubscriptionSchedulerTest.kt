@@ -0,0 +1,112 @@
+package com.twilio.video.app.sdk
+
+import android.os.Handler
+import com.twilio.video.RemoteVideoTrack
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.ui.room.RoomEvent
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.VideoTrackUpdated
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.argumentCaptor
+import org.mockito.kotlin.eq
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.verify
+import tvi.webrtc.VideoFrame
+import tvi.webrtc.VideoSink
+
+class TrackSubscriptionSchedulerTest : BaseUnitTest() {
+
+    private val deliveredEvents = mutableListOf<RoomEvent>()
+    private val slotReleases = mutableMapOf<RemoteVideoTrack, () -> Unit>()
+    private val scheduler = TrackSubscriptionScheduler(
+            deliveredEvents::add,
+            maxInFlight = 2,
+            awaitFirstFrame = { videoTrack, onSlotReleased -> slotReleases[videoTrack] = onSlotReleased }
+    ).apply { isEnabled = true }
+    private val deliveredSids get() = deliveredEvents.map { (it as VideoTrackUpdated).sid }
+
+    @Test
+    fun `should deliver every track as it arrives while disabled`() {
+        scheduler.isEnabled = false
+
+        repeat(3) { subscribe("$it") }
+
+        assertThat(deliveredSids, equalTo(listOf("0", "1", "2")))
+    }
+
+    @Test
+    fun `should hold back tracks while the slots are taken`() {
+        repeat(3) { subscribe("$it") }
+
+        assertThat(deliveredSids, equalTo(listOf("0", "1")))
+    }
+
+    @Test
+    fun `should deliver the primary participant and then the thumbnails in layout order`() {
+        val tracks = (0..3).map { subscribe("$it") }
+        scheduler.updatePriorities("3", listOf("local", "2", "1"))
+
+        slotReleases.getValue(tracks[0])()
+        slotReleases.getValue(tracks[1])()
+
+        assertThat(deliveredSids, equalTo(listOf("0", "1", "3", "2")))
+    }
+
+    @Test
+    fun `should free the slot of an unsubscribed track`() {
+        val track = subscribe("0")
+        subscribe("1")
+        subscribe("2")
+
+        scheduler.onVideoTrackUnsubscribed(track, VideoTrackUpdated("0", null))
+
+        assertThat(deliveredSids, equalTo(listOf("0", "1", "0", "2")))
+    }
+
+    @Test
+    fun `should drop a queued track that is unsubscribed`() {
+        subscribe("0")
+        subscribe("1")
+        val queuedTrack = subscribe("2")
+
+        scheduler.onVideoTrackUnsubscribed(queuedTrack, VideoTrackUpdated("2", null))
+
+        assertThat(deliveredSids, equalTo(listOf("0", "1")))
+    }
+
+    @Test
+    fun `reset should drop the queue and free the slots`() {
+        repeat(3) { subscribe("$it") }
+
+        scheduler.reset()
+        subscribe("3")
+
+        assertThat(deliveredSids, equalTo(listOf("0", "1", "3")))
+    }
+
+    @Test
+    fun `awaitFirstFrameOrTimeout should release the slot once on the first frame`() {
+        val videoTrack = mock<RemoteVideoTrack>()
+        val handler = mock<Handler>()
+        var releases = 0
+        awaitFirstFrameOrTimeout(videoTrack, { releases++ }, handler)
+        val sink = argumentCaptor<VideoSink>().apply { verify(videoTrack).addSink(capture()) }.firstValue
+        val timeout = argumentCaptor<Runnable>()
+                .apply { verify(handler).postDelayed(capture(), eq(VIDEO_TRACK_SLOT_TIMEOUT_MILLIS)) }.firstValue
+
+        sink.onFrame(mock<VideoFrame>())
+        sink.onFrame(mock<VideoFrame>())
+        argumentCaptor<Runnable>().apply { verify(handler).post(capture()) }.firstValue.run()
+        timeout.run()
+
+        assertThat(releases, equalTo(1))
+        verify(videoTrack).removeSink(sink)
+    }
+
+    private fun subscribe(sid: String): RemoteVideoTrack {
+        val videoTrack = mock<RemoteVideoTrack>()
+        scheduler.onVideoTrackSubscribed(sid, videoTrack, VideoTrackUpdated(sid, videoTrack))
+        return videoTrack
+    }
+}
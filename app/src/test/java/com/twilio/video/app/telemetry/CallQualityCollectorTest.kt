@@ -0,0 +1,113 @@
+package com.twilio.video.app.telemetry
+
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.CoreMatchers.nullValue
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+
+class CallQualityCollectorTest : BaseUnitTest() {
+
+    private val collector = CallQualityCollector()
+
+    @Test
+    fun `finish should not report a call that was never started`() {
+        collector.record(500, 500, 0, 0, 100, emptyMap())
+
+        assertThat(collector.finish(10_000, -1), nullValue())
+    }
+
+    @Test
+    fun `finish should not report a call without stats`() {
+        collector.start(0)
+
+        assertThat(collector.finish(10_000, -1), nullValue())
+    }
+
+    @Test
+    fun `finish should report the percentiles of the samples rounded up to their buckets`() {
+        collector.start(0)
+        repeat(19) { collector.record(400, 900, 0, 0, 80, mapOf("video" to 30)) }
+        collector.record(2500, 100, 40, 0, 450, mapOf("video" to 4))
+
+        val summary = collector.finish(60_000, 1200)!!
+
+        assertThat(summary.durationSeconds, equalTo(60))
+        assertThat(summary.joinMillis, equalTo(1200))
+        assertThat(summary.sampleCount, equalTo(20))
+        assertThat(summary.sendBitrateKbpsP50, equalTo(500))
+        assertThat(summary.sendBitrateKbpsP95, equalTo(500))
+        assertThat(summary.receiveBitrateKbpsP50, equalTo(1000))
+        assertThat(summary.sendPacketLossPermilleP50, equalTo(0))
+        assertThat(summary.roundTripTimeMillisP50, equalTo(100))
+        assertThat(summary.frameRateP5, equalTo(5))
+        assertThat(summary.frameRateP50, equalTo(30))
+    }
+
+    @Test
+    fun `finish should report the send and the receive loss apart`() {
+        collector.start(0)
+        repeat(2) { collector.record(500, 500, 30, 5, 100, emptyMap()) }
+
+        val summary = collector.finish(10_000, -1)!!
+
+        assertThat(summary.sendPacketLossPermilleP50, equalTo(30))
+        assertThat(summary.receivePacketLossPermilleP50, equalTo(5))
+    }
+
+    @Test
+    fun `a remote video track dropping to zero frames should count as a freeze`() {
+        collector.start(0)
+        collector.record(500, 500, 0, 0, 100, mapOf("video" to 30))
+        collector.record(500, 500, 0, 0, 100, mapOf("video" to 0))
+        collector.record(500, 500, 0, 0, 100, mapOf("video" to 0))
+        collector.record(500, 500, 0, 0, 100, mapOf("video" to 24))
+        collector.record(500, 500, 0, 0, 100, mapOf("video" to 0))
+
+        assertThat(collector.finish(10_000, -1)!!.freezeCount, equalTo(2))
+    }
+
+    @Test
+    fun `a switched off remote video track should not count as a freeze`() {
+        collector.start(0)
+        collector.record(500, 500, 0, 0, 100, mapOf("video" to 30))
+        collector.onTrackSwitchOff("video", true, 1000)
+        collector.record(500, 500, 0, 0, 100, mapOf("video" to 0))
+        collector.onTrackSwitchOff("video", false, 4000)
+        collector.record(500, 500, 0, 0, 100, mapOf("video" to 0))
+
+        val summary = collector.finish(10_000, -1)!!
+
+        assertThat(summary.freezeCount, equalTo(0))
+        assertThat(summary.switchOffSeconds, equalTo(3))
+    }
+
+    @Test
+    fun `finish should report the render freezes of the call`() {
+        collector.onRenderFreeze()
+        collector.start(0)
+        collector.record(500, 500, 0, 0, 100, emptyMap())
+        collector.onRenderFreeze()
+        collector.onRenderFreeze()
+
+        assertThat(collector.finish(10_000, -1)!!.renderFreezeCount, equalTo(2))
+    }
+
+    @Test
+    fun `finish should count the switch off time of tracks still switched off`() {
+        collector.start(0)
+        collector.record(500, 500, 0, 0, 100, emptyMap())
+        collector.onTrackSwitchOff("video", true, 5000)
+
+        assertThat(collector.finish(7000, -1)!!.switchOffSeconds, equalTo(2))
+    }
+
+    @Test
+    fun `start should keep the call of a rejoined room`() {
+        collector.start(0)
+        collector.record(500, 500, 0, 0, 100, emptyMap())
+        collector.start(30_000)
+
+        assertThat(collector.finish(60_000, -1)!!.durationSeconds, equalTo(60))
+    }
+}
@@ -0,0 +1,114 @@
+package com.twilio.video.app.telemetry
+
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Rule
+import org.junit.Test
+import org.junit.rules.TemporaryFolder
+
+class TelemetryStoreTest : BaseUnitTest() {
+
+    @get:Rule
+    val temporaryFolder = TemporaryFolder()
+
+    private val store by lazy {
+        TelemetryStore(temporaryFolder.root.resolve("telemetry/pending.bin"), maxBytes = 64)
+    }
+    private val summary = CallQualitySummary(
+            durationSeconds = 1800,
+            joinMillis = 1450,
+            sampleCount = 1800,
+            sendBitrateKbpsP50 = 1000,
+            sendBitrateKbpsP95 = 1500,
+            receiveBitrateKbpsP50 = 2000,
+            receiveBitrateKbpsP95 = 3000,
+            sendPacketLossPermilleP50 = 0,
+            sendPacketLossPermilleP95 = 20,
+            roundTripTimeMillisP50 = 50,
+            roundTripTimeMillisP95 = 150,
+            frameRateP5 = 15,
+            frameRateP50 = 30,
+            freezeCount = 2,
+            switchOffSeconds = 120,
+            renderFreezeCount = 2,
+            receivePacketLossPermilleP50 = 5,
+            receivePacketLossPermilleP95 = 30)
+
+    @Test
+    fun `a summary should decode to the summary it was encoded from`() {
+        assertThat(CallQualitySummary.decode(summary.encode()), equalTo(summary))
+    }
+
+    @Test
+    fun `a summary without a join latency should decode to the summary it was encoded from`() {
+        val summary = summary.copy(joinMillis = -1)
+
+        assertThat(CallQualitySummary.decode(summary.encode()), equalTo(summary))
+    }
+
+    @Test
+    fun `a version 1 summary should decode without render freezes`() {
+        val encoded = summary.encode()
+        encoded[0] = 1
+
+        val decoded = CallQualitySummary.decode(encoded.copyOf(encoded.size - 3))
+
+        assertThat(decoded, equalTo(summary.copy(
+                renderFreezeCount = 0,
+                receivePacketLossPermilleP50 = 0,
+                receivePacketLossPermilleP95 = 20)))
+    }
+
+    @Test
+    fun `a version 2 summary should decode the loss of the worst track as both directions`() {
+        val encoded = summary.encode()
+        encoded[0] = 2
+
+        val decoded = CallQualitySummary.decode(encoded.copyOf(encoded.size - 2))
+
+        assertThat(decoded, equalTo(summary.copy(
+                receivePacketLossPermilleP50 = 0,
+                receivePacketLossPermilleP95 = 20)))
+    }
+
+    @Test
+    fun `readBatch should return the appended records in order`() {
+        store.append(byteArrayOf(1, 2))
+        store.append(byteArrayOf(3))
+
+        val records = TelemetryStore.records(store.readBatch())
+
+        assertThat(records.map { it.toList() }, equalTo(listOf(listOf<Byte>(1, 2), listOf<Byte>(3))))
+    }
+
+    @Test
+    fun `remove should keep the records appended after the batch was read`() {
+        store.append(byteArrayOf(1))
+        val batch = store.readBatch()
+        store.append(byteArrayOf(2))
+
+        store.remove(batch.size)
+        val records = TelemetryStore.records(store.readBatch())
+
+        assertThat(records.map { it.toList() }, equalTo(listOf(listOf<Byte>(2))))
+        assertThat(store.isEmpty, equalTo(false))
+    }
+
+    @Test
+    fun `remove should empty the store once every record is uploaded`() {
+        store.append(byteArrayOf(1))
+
+        store.remove(store.readBatch().size)
+
+        assertThat(store.isEmpty, equalTo(true))
+    }
+
+    @Test
+    fun `append should drop records once the store is full`() {
+        assertThat(store.append(ByteArray(60)), equalTo(true))
+        assertThat(store.append(ByteArray(10)), equalTo(false))
+
+        assertThat(TelemetryStore.records(store.readBatch()).size, equalTo(1))
+    }
+}
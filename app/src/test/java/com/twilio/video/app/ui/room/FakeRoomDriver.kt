@@ -0,0 +1,293 @@
+package com.twilio.video.app.ui.room
+
+import androidx.recyclerview.widget.DiffUtil
+import androidx.recyclerview.widget.ListUpdateCallback
+import com.twilio.audioswitch.AudioSwitch
+import com.twilio.video.LocalParticipant
+import com.twilio.video.NetworkQualityLevel
+import com.twilio.video.RemoteParticipant
+import com.twilio.video.Room
+import com.twilio.video.app.data.Settings
+import com.twilio.video.app.participant.ParticipantViewState
+import com.twilio.video.app.sdk.LocalParticipantManager
+import com.twilio.video.app.sdk.NativeObjectRegistry
+import com.twilio.video.app.sdk.RoomManager
+import com.twilio.video.app.sdk.RoomStats
+import com.twilio.video.app.ui.room.RoomEvent.Connected
+import com.twilio.video.app.ui.room.RoomEvent.DominantSpeakerChanged
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.NetworkQualityLevelChange
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParticipantConnected
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParticipantDisconnected
+import com.twilio.video.app.ui.room.RoomEvent.StatsUpdate
+import com.twilio.video.app.util.MainCoroutineScopeRule
+import dagger.Lazy
+import io.uniflow.android.test.TestViewObserver
+import io.uniflow.android.test.createTestObserver
+import java.lang.management.ManagementFactory
+import kotlin.random.Random
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.MutableStateFlow
+import org.junit.Assert.assertTrue
+import org.mockito.kotlin.doReturn
+import org.mockito.kotlin.mock
+
+/** The window the view model gathers room events in, standing in for a Choreographer frame. */
+const val STRESS_FRAME_MILLIS = 16L
+
+/**
+ * What a [FakeRoomDriver] plays, all times are virtual. A rate of 0 turns its event source off.
+ *
+ * @param participantCount the remote participants that join at the start, one per [joinIntervalMillis].
+ * @param churnIntervalMillis how often a random participant leaves and a new one joins in its place.
+ * @param dominantSpeakerIntervalMillis how often the dominant speaker changes between the first
+ * [speakerCount] participants in the room.
+ * @param networkQualityIntervalMillis how often every participant reports a new network quality.
+ * @param statsIntervalMillis how often a stats report arrives.
+ */
+data class FakeRoomScenario(
+    val participantCount: Int,
+    val durationMillis: Long,
+    val joinIntervalMillis: Long = 10,
+    val churnIntervalMillis: Long = 0,
+    val dominantSpeakerIntervalMillis: Long = 0,
+    val speakerCount: Int = 3,
+    val networkQualityIntervalMillis: Long = 0,
+    val statsIntervalMillis: Long = 0,
+    val seed: Int = 0
+)
+
+/**
+ * Upper bounds for a [StressReport]. Allocations are measured in bytes since the JVM counts bytes
+ * rather than objects per thread. The test thread is the main thread of the view model.
+ */
+data class StressBudget(
+    val maxStateUpdates: Int,
+    val maxAdapterUpdates: Int,
+    val maxAllocatedBytesPerEvent: Long,
+    val maxMainThreadMillis: Long
+)
+
+/**
+ * @param adapterUpdates the rows inserted, removed, moved and changed in the thumbnail list, i.e.
+ * what the [ParticipantAdapter] would bind.
+ * @param allocatedBytes the bytes allocated on the main thread, or -1 if the JVM does not count them.
+ * @param mainThreadMillis the CPU time of the main thread, its wall time if the JVM does not count it.
+ */
+data class StressReport(
+    val eventCount: Int,
+    val stateUpdates: Int,
+    val adapterUpdates: Int,
+    val allocatedBytes: Long,
+    val mainThreadMillis: Long
+) {
+
+    fun assertWithin(budget: StressBudget) {
+        assertCountsWithin(budget)
+        assertTrue("Too many allocations, $this over $budget",
+                allocatedBytes <= budget.maxAllocatedBytesPerEvent * eventCount)
+        assertTrue("Too much main thread time, $this over $budget",
+                mainThreadMillis <= budget.maxMainThreadMillis)
+    }
+
+    /** Only checks the update counts, which unlike the allocations and the time are deterministic. */
+    fun assertCountsWithin(budget: StressBudget) {
+        assertTrue("Too many state updates, $this over $budget",
+                stateUpdates <= budget.maxStateUpdates)
+        assertTrue("Too many adapter updates, $this over $budget",
+                adapterUpdates <= budget.maxAdapterUpdates)
+    }
+}
+
+/**
+ * Drives a real [RoomManager] and [RoomViewModel] with the events of a fake room, as the SDK
+ * callbacks of a busy call would send them, and feeds every view state to a stand-in for the
+ * [ParticipantAdapter]. Time is virtual, so a minute long scenario runs in well under a second.
+ *
+ * The test has to install the uniflow dispatchers on [coroutineScope] and run live data
+ * instantly, see RoomStressTest. The driver must be [close]d at the end of the test so that no
+ * coroutine outlives it.
+ */
+@ExperimentalCoroutinesApi
+class FakeRoomDriver(
+    private val coroutineScope: MainCoroutineScopeRule,
+    pacing: RoomEventPacing = RoomEventPacing.Window(STRESS_FRAME_MILLIS)
+) {
+    private val roomManager = RoomManager(mock(), mock(), coroutineScope.dispatcher,
+            settings = MutableStateFlow(Settings()), captureProfileStore = mock(), nativeObjects = NativeObjectRegistry { 0 }).apply {
+        localParticipantManager = mock<LocalParticipantManager>()
+    }
+    private val viewModel = RoomViewModel(roomManager, Lazy { mock<AudioSwitch>() }, mock(), roomEventPacing = pacing)
+    private val testObserver: TestViewObserver = viewModel.createTestObserver()
+    private val thumbnails = RecordingParticipantList()
+    private var recordedValues = 0
+
+    /** Plays [scenario] after connecting to the fake room and measures the whole call. */
+    fun run(scenario: FakeRoomScenario): StressReport {
+        val timeline = buildTimeline(scenario)
+        val localParticipant = mock<LocalParticipant>(stubOnly = true) {
+            on { sid } doReturn "local"
+        }
+        val room = mock<Room>(stubOnly = true) { on { name } doReturn "Stress Room" }
+        val firstValue = testObserver.values.size
+        recordedValues = firstValue
+        val measurement = ThreadMeasurement()
+
+        roomManager.sendRoomEvent(Connected(listOf(localParticipant), room, "Stress Room"))
+        var nowMillis = 0L
+        for ((timeMillis, roomEvent) in timeline) {
+            if (timeMillis > nowMillis) {
+                coroutineScope.advanceTimeBy(timeMillis - nowMillis)
+                nowMillis = timeMillis
+                recordStates()
+            }
+            roomManager.sendRoomEvent(roomEvent)
+        }
+        coroutineScope.advanceUntilIdle()
+        recordStates()
+
+        return StressReport(
+                eventCount = timeline.size,
+                stateUpdates = testObserver.values.drop(firstValue).count { it is RoomViewState },
+                adapterUpdates = thumbnails.updateCount,
+                allocatedBytes = measurement.allocatedBytes(),
+                mainThreadMillis = measurement.cpuMillis())
+    }
+
+    fun close() {
+        coroutineScope.advanceUntilIdle()
+        viewModel.onCleared()
+    }
+
+    private fun recordStates() {
+        val values = testObserver.values
+        for (index in recordedValues until values.size) {
+            (values[index] as? RoomViewState)?.participantThumbnails?.let { thumbnails.submit(it) }
+        }
+        recordedValues = values.size
+    }
+
+    /*
+     * The events are built ahead of the measurement, in the order the SDK would report them. Every
+     * source fires at multiples of its interval so that a scenario replays the same way each time.
+     */
+    private fun buildTimeline(scenario: FakeRoomScenario): List<Pair<Long, RoomEvent>> {
+        val random = Random(scenario.seed)
+        val timeline = ArrayList<Pair<Long, RoomEvent>>()
+        val present = ArrayList<RemoteParticipant>()
+        var joinedCount = 0
+        var nextParticipant = 0
+        var speakerIndex = 0
+        val stats = RoomStats(emptyMap(), emptyMap())
+        fun isDue(timeMillis: Long, intervalMillis: Long) =
+                intervalMillis > 0 && timeMillis > 0 && timeMillis % intervalMillis == 0L
+
+        for (timeMillis in 0..scenario.durationMillis) {
+            while (joinedCount < scenario.participantCount &&
+                    timeMillis >= joinedCount * scenario.joinIntervalMillis) {
+                val participant = fakeParticipant(nextParticipant++)
+                joinedCount++
+                present.add(participant)
+                timeline.add(timeMillis to RemoteParticipantConnected(participant))
+            }
+            if (isDue(timeMillis, scenario.churnIntervalMillis) && present.isNotEmpty()) {
+                val leaving = present.removeAt(random.nextInt(present.size))
+                timeline.add(timeMillis to RemoteParticipantDisconnected(leaving.sid))
+                val participant = fakeParticipant(nextParticipant++)
+                present.add(participant)
+                timeline.add(timeMillis to RemoteParticipantConnected(participant))
+            }
+            if (isDue(timeMillis, scenario.dominantSpeakerIntervalMillis) && present.isNotEmpty()) {
+                val speakers = minOf(scenario.speakerCount, present.size)
+                speakerIndex = (speakerIndex + 1) % speakers
+                timeline.add(timeMillis to DominantSpeakerChanged(present[speakerIndex].sid))
+            }
+            if (isDue(timeMillis, scenario.networkQualityIntervalMillis)) {
+                val levels = NetworkQualityLevel.values()
+                for (participant in present) {
+                    timeline.add(timeMillis to NetworkQualityLevelChange(participant.sid,
+                            levels[random.nextInt(levels.size)]))
+                }
+            }
+            if (isDue(timeMillis, scenario.statsIntervalMillis)) {
+                timeline.add(timeMillis to StatsUpdate(stats))
+            }
+        }
+        return timeline
+    }
+
+    /* Stub only, the mocks would otherwise record every call the view model makes on them. */
+    private fun fakeParticipant(index: Int): RemoteParticipant = mock(stubOnly = true) {
+        on { sid } doReturn "PA$index"
+        on { identity } doReturn "Participant $index"
+        on { videoTracks } doReturn emptyList()
+        on { audioTracks } doReturn emptyList()
+        on { networkQualityLevel } doReturn NetworkQualityLevel.NETWORK_QUALITY_LEVEL_UNKNOWN
+    }
+}
+
+/*
+ * Diffs every submitted list like the AsyncListDiffer of the [ParticipantAdapter] does, with the
+ * same item callback, and counts the rows it would update. The adapter diffs off the main thread,
+ * here the diff is part of the measured main thread time, which keeps the budget conservative.
+ */
+private class RecordingParticipantList : ListUpdateCallback {
+
+    private val itemCallback = ParticipantAdapter.ParticipantDiffCallback()
+    private var items = emptyList<ParticipantViewState>()
+    var updateCount = 0
+        private set
+
+    fun submit(newItems: List<ParticipantViewState>) {
+        if (newItems === items) return
+        val oldItems = items
+        items = newItems
+        DiffUtil.calculateDiff(object : DiffUtil.Callback() {
+            override fun getOldListSize() = oldItems.size
+
+            override fun getNewListSize() = newItems.size
+
+            override fun areItemsTheSame(oldItemPosition: Int, newItemPosition: Int) =
+                    itemCallback.areItemsTheSame(oldItems[oldItemPosition], newItems[newItemPosition])
+
+            override fun areContentsTheSame(oldItemPosition: Int, newItemPosition: Int) =
+                    itemCallback.areContentsTheSame(oldItems[oldItemPosition], newItems[newItemPosition])
+        }).dispatchUpdatesTo(this)
+    }
+
+    override fun onInserted(position: Int, count: Int) {
+        updateCount += count
+    }
+
+    override fun onRemoved(position: Int, count: Int) {
+        updateCount += count
+    }
+
+    override fun onMoved(fromPosition: Int, toPosition: Int) {
+        updateCount++
+    }
+
+    override fun onChanged(position: Int, count: Int, payload: Any?) {
+        updateCount += count
+    }
+}
+
+/* The CPU time and allocations of the current thread, both are missing on some JVMs. */
+private class ThreadMeasurement {
+
+    private val threadMXBean = ManagementFactory.getThreadMXBean()
+    private val allocationBean = (threadMXBean as? com.sun.management.ThreadMXBean)
+            ?.takeIf { it.isThreadAllocatedMemorySupported }
+            ?.apply { isThreadAllocatedMemoryEnabled = true }
+    private val threadId = Thread.currentThread().id
+    private val startAllocatedBytes = allocationBean?.getThreadAllocatedBytes(threadId) ?: -1
+    private val isCpuTimeSupported = threadMXBean.isCurrentThreadCpuTimeSupported
+    private val startNanos = currentNanos()
+
+    fun allocatedBytes(): Long =
+            allocationBean?.let { it.getThreadAllocatedBytes(threadId) - startAllocatedBytes } ?: -1
+
+    fun cpuMillis(): Long = (currentNanos() - startNanos) / 1_000_000
+
+    private fun currentNanos() =
+            if (isCpuTimeSupported) threadMXBean.currentThreadCpuTime else System.nanoTime()
+}
@@ -0,0 +1,50 @@
+package com.twilio.video.app.ui.room
+
+import com.twilio.video.RemoteVideoTrack
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.participant.ParticipantViewState
+import com.twilio.video.app.sdk.VideoTrackViewState
+import junitparams.JUnitParamsRunner
+import junitparams.Parameters
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.mockito.kotlin.mock
+
+@RunWith(JUnitParamsRunner::class)
+class ParticipantGridControllerTest : BaseUnitTest() {
+
+    @Test
+    @Parameters(value = ["1, 2", "2, 2", "5, 4", "8, 6", "16, 9"])
+    fun `gridPageSize should not exceed the video decoder capacity`(
+        videoDecoderCapacity: Int,
+        expectedPageSize: Int
+    ) {
+        assertThat(gridPageSize(videoDecoderCapacity), equalTo(expectedPageSize))
+    }
+
+    @Test
+    fun `gridPageTracks should only hold the tracks of the given page`() {
+        val videoTracks = List(5) { mock<RemoteVideoTrack>() }
+        val participants = videoTracks.mapIndexed { index, videoTrack ->
+            ParticipantViewState("sid$index", videoTrack = VideoTrackViewState(videoTrack))
+        }
+
+        assertThat(gridPageTracks(participants, pageSize = 2, index = 1), equalTo(videoTracks.subList(2, 4)))
+        assertThat(gridPageTracks(participants, pageSize = 2, index = 2), equalTo(videoTracks.subList(4, 5)))
+        assertThat(gridPageTracks(participants, pageSize = 2, index = 3), equalTo(emptyList()))
+    }
+
+    @Test
+    fun `gridPageTracks should hold the screen track of a participant sharing its screen`() {
+        val videoTrack = mock<RemoteVideoTrack>()
+        val screenTrack = mock<RemoteVideoTrack>()
+        val participants = listOf(
+                ParticipantViewState("sid0"),
+                ParticipantViewState("sid1", videoTrack = VideoTrackViewState(videoTrack),
+                        screenTrack = VideoTrackViewState(screenTrack)))
+
+        assertThat(gridPageTracks(participants, pageSize = 1, index = 1), equalTo(listOf(screenTrack)))
+    }
+}
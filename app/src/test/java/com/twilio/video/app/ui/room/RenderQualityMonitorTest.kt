@@ -0,0 +1,120 @@
+package com.twilio.video.app.ui.room
+
+import android.os.Handler
+import com.twilio.video.RemoteVideoTrack
+import com.twilio.video.VideoTrack
+import com.twilio.video.app.BaseUnitTest
+import java.util.concurrent.TimeUnit
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.any
+import org.mockito.kotlin.doAnswer
+import org.mockito.kotlin.mock
+import tvi.webrtc.VideoFrame
+import tvi.webrtc.VideoSink
+
+class RenderQualityMonitorTest : BaseUnitTest() {
+
+    private val pendingRunnables = mutableListOf<Runnable>()
+    private val handler = mock<Handler> {
+        on { post(any()) } doAnswer { it.getArgument<Runnable>(0).run(); true }
+        on { postDelayed(any(), any()) } doAnswer {
+            pendingRunnables.add(it.getArgument(0))
+            true
+        }
+        on { removeCallbacks(any()) } doAnswer {
+            pendingRunnables.remove(it.getArgument(0))
+            Unit
+        }
+    }
+    private var nowMillis = 0L
+    private val renderQualityMonitor = RenderQualityMonitor(handler) {
+        TimeUnit.MILLISECONDS.toNanos(nowMillis)
+    }.apply {
+        onRenderQualityChanged = { videoTrack, quality -> changes.add(videoTrack to quality) }
+    }
+    private val changes = mutableListOf<Pair<VideoTrack, RenderQuality>>()
+    private val sinks = mutableListOf<VideoSink>()
+    private val videoTrack = mock<RemoteVideoTrack> {
+        on { isEnabled } doAnswer { true }
+        on { addSink(any()) } doAnswer { sinks.add(it.getArgument(0)); Unit }
+    }
+    private val frame = mock<VideoFrame>()
+
+    @Test
+    fun `a track that stops delivering frames should be frozen`() {
+        renderQualityMonitor.start(videoTrack)
+        renderWindow(fps = 30)
+
+        renderWindow(fps = 0)
+        assertThat(changes, equalTo(emptyList()))
+        renderWindow(fps = 0)
+
+        assertThat(changes, equalTo(listOf<Pair<VideoTrack, RenderQuality>>(videoTrack to RenderQuality.FROZEN)))
+    }
+
+    @Test
+    fun `a track should only have a low frame rate after two windows`() {
+        renderQualityMonitor.start(videoTrack)
+        renderWindow(fps = 30)
+
+        renderWindow(fps = 3)
+        assertThat(changes, equalTo(emptyList()))
+        renderWindow(fps = 3)
+        renderWindow(fps = 30)
+        renderWindow(fps = 30)
+
+        assertThat(changes, equalTo(listOf<Pair<VideoTrack, RenderQuality>>(
+                videoTrack to RenderQuality.LOW_FRAME_RATE,
+                videoTrack to RenderQuality.GOOD)))
+    }
+
+    @Test
+    fun `a track should not be judged before its first frame`() {
+        renderQualityMonitor.start(videoTrack)
+
+        repeat(5) { renderWindow(fps = 0) }
+
+        assertThat(changes, equalTo(emptyList()))
+    }
+
+    @Test
+    fun `a switched off track should not be frozen`() {
+        renderQualityMonitor.start(videoTrack)
+        renderWindow(fps = 30)
+
+        renderQualityMonitor.setSwitchedOff(videoTrack, true)
+        repeat(5) { renderWindow(fps = 0) }
+        renderQualityMonitor.setSwitchedOff(videoTrack, false)
+        renderWindow(fps = 0)
+
+        assertThat(changes, equalTo(emptyList()))
+    }
+
+    @Test
+    fun `stop should report a degraded track as good again`() {
+        renderQualityMonitor.start(videoTrack)
+        renderWindow(fps = 30)
+        repeat(2) { renderWindow(fps = 0) }
+
+        renderQualityMonitor.stop(videoTrack)
+
+        assertThat(changes.last(), equalTo<Pair<VideoTrack, RenderQuality>>(videoTrack to RenderQuality.GOOD))
+        assertThat(pendingRunnables, equalTo(emptyList()))
+    }
+
+    /** Delivers [fps] evenly spaced frames over a window and samples it. */
+    private fun renderWindow(fps: Int) {
+        val windowEndMillis = nowMillis + RENDER_QUALITY_WINDOW_MILLIS
+        repeat(fps) {
+            nowMillis += RENDER_QUALITY_WINDOW_MILLIS / fps
+            sinks.forEach { it.onFrame(frame) }
+        }
+        nowMillis = windowEndMillis
+        pendingRunnables.toList().forEach {
+            pendingRunnables.remove(it)
+            it.run()
+        }
+    }
+}
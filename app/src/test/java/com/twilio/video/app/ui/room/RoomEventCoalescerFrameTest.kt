@@ -0,0 +1,87 @@
+package com.twilio.video.app.ui.room
+
+import android.os.Looper
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_ONE
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_TWO
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.ui.room.RoomEvent.RecordingStarted
+import com.twilio.video.app.ui.room.RoomEvent.RecordingStopped
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.NetworkQualityLevelChange
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParticipantDisconnected
+import java.util.concurrent.TimeUnit.MILLISECONDS
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.flow.MutableSharedFlow
+import kotlinx.coroutines.flow.collect
+import kotlinx.coroutines.launch
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.After
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.robolectric.Shadows.shadowOf
+
+/* The Frame pacing waits for Choreographer frames, which Robolectric runs on the main looper. */
+@RunWith(AndroidJUnit4::class)
+class RoomEventCoalescerFrameTest : BaseUnitTest() {
+
+    private val roomEvents = MutableSharedFlow<RoomEvent>(extraBufferCapacity = 16)
+    private val batches = mutableListOf<RoomEventBatch>()
+    private val coalescer = RoomEventCoalescer(RoomEventPacing.Frame)
+    private val scope = CoroutineScope(Dispatchers.Main.immediate)
+
+    @Before
+    fun setUp() {
+        scope.launch { coalescer.coalesce(roomEvents).collect { batches.add(it) } }
+        shadowOf(Looper.getMainLooper()).idle()
+    }
+
+    @After
+    fun tearDown() {
+        scope.cancel()
+    }
+
+    @Test
+    fun `events sent before a frame should be delivered as one batch once it is drawn`() {
+        roomEvents.tryEmit(NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_ONE))
+        roomEvents.tryEmit(RecordingStarted)
+        roomEvents.tryEmit(NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_TWO))
+        drawFrame()
+
+        assertThat(batches, equalTo(listOf(RoomEventBatch(listOf(
+                RecordingStarted,
+                NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_TWO)), mergedCount = 1))))
+    }
+
+    @Test
+    fun `events sent after a frame was drawn should wait for the next frame`() {
+        roomEvents.tryEmit(RecordingStarted)
+        drawFrame()
+        roomEvents.tryEmit(RecordingStopped)
+        drawFrame()
+
+        assertThat(batches, equalTo(listOf(
+                RoomEventBatch(listOf(RecordingStarted)),
+                RoomEventBatch(listOf(RecordingStopped)))))
+    }
+
+    @Test
+    fun `a frame should not deliver the events of a participant that disconnected`() {
+        roomEvents.tryEmit(RemoteParticipantDisconnected("1"))
+        roomEvents.tryEmit(NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_ONE))
+        drawFrame()
+
+        assertThat(batches, equalTo(listOf(RoomEventBatch(listOf(
+                RemoteParticipantDisconnected("1")), mergedCount = 1))))
+        assertThat(coalescer.mergedEventCount, equalTo(1L))
+    }
+
+    private fun drawFrame() = shadowOf(Looper.getMainLooper()).idleFor(FRAME_MILLIS, MILLISECONDS)
+
+    private companion object {
+        const val FRAME_MILLIS = 20L
+    }
+}
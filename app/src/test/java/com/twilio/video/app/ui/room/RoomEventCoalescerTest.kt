@@ -0,0 +1,124 @@
+package com.twilio.video.app.ui.room
+
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_ONE
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_THREE
+import com.twilio.video.NetworkQualityLevel.NETWORK_QUALITY_LEVEL_TWO
+import com.twilio.video.Participant
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.ui.room.RoomEvent.DominantSpeakerChanged
+import com.twilio.video.app.ui.room.RoomEvent.RecordingStarted
+import com.twilio.video.app.ui.room.RoomEvent.RecordingStopped
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.MuteRemoteParticipant
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.NetworkQualityLevelChange
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParticipantConnected
+import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.RemoteParticipantDisconnected
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.flowOf
+import kotlinx.coroutines.flow.toList
+import kotlinx.coroutines.test.runBlockingTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.doReturn
+import org.mockito.kotlin.mock
+
+@ExperimentalCoroutinesApi
+class RoomEventCoalescerTest : BaseUnitTest() {
+
+    private val coalescer = RoomEventCoalescer(RoomEventPacing.Window(16))
+
+    @Test
+    fun `compact should only keep the last NetworkQualityLevelChange of a participant`() {
+        val events = listOf(
+                NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_ONE),
+                NetworkQualityLevelChange("2", NETWORK_QUALITY_LEVEL_ONE),
+                NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_TWO),
+                NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_THREE))
+
+        assertThat(coalescer.compact(events), equalTo(listOf<RoomEvent>(
+                NetworkQualityLevelChange("2", NETWORK_QUALITY_LEVEL_ONE),
+                NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_THREE))))
+    }
+
+    @Test
+    fun `compact should keep events that cannot be superseded in order`() {
+        val events = listOf(
+                MuteRemoteParticipant("1", true),
+                RecordingStarted,
+                MuteRemoteParticipant("2", true),
+                RecordingStopped,
+                MuteRemoteParticipant("1", false))
+
+        assertThat(coalescer.compact(events), equalTo(listOf(
+                RecordingStarted,
+                MuteRemoteParticipant("2", true),
+                RecordingStopped,
+                MuteRemoteParticipant("1", false))))
+    }
+
+    @Test
+    fun `compact should drop the events of a participant that disconnected`() {
+        val events = listOf(
+                MuteRemoteParticipant("1", true),
+                NetworkQualityLevelChange("2", NETWORK_QUALITY_LEVEL_ONE),
+                RemoteParticipantDisconnected("1"),
+                RecordingStarted,
+                MuteRemoteParticipant("1", false),
+                NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_TWO))
+
+        assertThat(coalescer.compact(events), equalTo(listOf(
+                NetworkQualityLevelChange("2", NETWORK_QUALITY_LEVEL_ONE),
+                RemoteParticipantDisconnected("1"),
+                RecordingStarted)))
+    }
+
+    @Test
+    fun `compact should keep the events of a participant that connected again`() {
+        val participant = mock<Participant> { on { sid } doReturn "1" }
+        val events = listOf(
+                MuteRemoteParticipant("1", true),
+                RemoteParticipantDisconnected("1"),
+                MuteRemoteParticipant("1", true),
+                RemoteParticipantConnected(participant),
+                MuteRemoteParticipant("1", false))
+
+        assertThat(coalescer.compact(events), equalTo(listOf(
+                RemoteParticipantDisconnected("1"),
+                RemoteParticipantConnected(participant),
+                MuteRemoteParticipant("1", false))))
+    }
+
+    @Test
+    fun `compact should only keep the last dominant speaker change`() {
+        val events = listOf(
+                DominantSpeakerChanged("1"),
+                DominantSpeakerChanged("2"),
+                DominantSpeakerChanged(null))
+
+        assertThat(coalescer.compact(events), equalTo(listOf<RoomEvent>(DominantSpeakerChanged(null))))
+    }
+
+    @Test
+    fun `coalesce should merge events sent within the window into one batch`() = runBlockingTest {
+        val batches = coalescer.coalesce(flowOf(
+                NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_ONE),
+                NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_TWO),
+                RecordingStarted)).toList()
+
+        assertThat(batches, equalTo(listOf(RoomEventBatch(listOf(
+                NetworkQualityLevelChange("1", NETWORK_QUALITY_LEVEL_TWO),
+                RecordingStarted), mergedCount = 1))))
+        assertThat(coalescer.mergedEventCount, equalTo(1L))
+    }
+
+    @Test
+    fun `coalesce should deliver every event on its own when immediate`() = runBlockingTest {
+        val batches = RoomEventCoalescer(RoomEventPacing.Immediate).coalesce(flowOf(
+                RecordingStarted,
+                DominantSpeakerChanged("1"))).toList()
+
+        assertThat(batches, equalTo(listOf(
+                RoomEventBatch(listOf(RecordingStarted)),
+                RoomEventBatch(listOf(DominantSpeakerChanged("1"))))))
+    }
+}
@@ -0,0 +1,100 @@
+package com.twilio.video.app.ui.room
+
+import androidx.arch.core.executor.testing.InstantTaskExecutorRule
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.util.MainCoroutineScopeRule
+import io.uniflow.test.rule.UniflowTestDispatchersRule
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import net.lachlanmckee.timberjunit.TimberTestRule
+import org.junit.After
+import org.junit.Assert.assertThrows
+import org.junit.Rule
+import org.junit.Test
+
+/*
+ * The state and adapter update counts are deterministic, the allocations and the main thread time
+ * are not. Their budgets are tight enough that a state copy or a diff of the whole room on every
+ * event, instead of once per frame, exceeds them.
+ */
+private const val MAX_ALLOCATED_BYTES_PER_EVENT = 16 * 1024L
+private const val MAX_MAIN_THREAD_MILLIS = 1000L
+
+private val eventStormScenario = FakeRoomScenario(
+        participantCount = 25,
+        durationMillis = 10_000,
+        joinIntervalMillis = 0,
+        dominantSpeakerIntervalMillis = 50,
+        speakerCount = 2,
+        networkQualityIntervalMillis = 100,
+        statsIntervalMillis = 1000)
+
+private val eventStormBudget = StressBudget(
+        maxStateUpdates = 250,
+        maxAdapterUpdates = 3500,
+        maxAllocatedBytesPerEvent = MAX_ALLOCATED_BYTES_PER_EVENT,
+        maxMainThreadMillis = MAX_MAIN_THREAD_MILLIS)
+
+@ExperimentalCoroutinesApi
+class RoomStressTest : BaseUnitTest() {
+
+    @get:Rule
+    val rule = InstantTaskExecutorRule()
+
+    @get:Rule
+    val coroutineScope = MainCoroutineScopeRule()
+
+    @get:Rule
+    val uniflowDispatchers = UniflowTestDispatchersRule(coroutineScope.dispatcher)
+
+    private var driver: FakeRoomDriver? = null
+
+    init {
+        // Thousands of events would flood the test output
+        logAllAlwaysRule = TimberTestRule.logAllWhenTestFails()
+    }
+
+    @After
+    fun tearDown() {
+        driver?.close()
+    }
+
+    @Test
+    fun `participant churn in a large room should stay within the budgets`() {
+        val report = newDriver().run(FakeRoomScenario(
+                participantCount = 50,
+                durationMillis = 30_000,
+                joinIntervalMillis = 20,
+                churnIntervalMillis = 250,
+                dominantSpeakerIntervalMillis = 500,
+                networkQualityIntervalMillis = 1000,
+                statsIntervalMillis = 1000))
+
+        report.assertWithin(StressBudget(
+                maxStateUpdates = 200,
+                maxAdapterUpdates = 2500,
+                maxAllocatedBytesPerEvent = MAX_ALLOCATED_BYTES_PER_EVENT,
+                maxMainThreadMillis = MAX_MAIN_THREAD_MILLIS))
+    }
+
+    @Test
+    fun `an event storm should only update the state once per frame with events`() {
+        val report = newDriver().run(eventStormScenario)
+
+        report.assertWithin(eventStormBudget)
+    }
+
+    /*
+     * Only the deterministic counts are asserted, so that the test neither depends on the machine
+     * nor passes because of it. The storm sends around 2700 events, without pacing the state follows
+     * every one that changes it, which leaves the budget of 250 updates far behind.
+     */
+    @Test
+    fun `the budget should catch a view model that updates the state for every event`() {
+        val report = newDriver(RoomEventPacing.Immediate).run(eventStormScenario)
+
+        assertThrows(AssertionError::class.java) { report.assertCountsWithin(eventStormBudget) }
+    }
+
+    private fun newDriver(pacing: RoomEventPacing = RoomEventPacing.Window(STRESS_FRAME_MILLIS)) =
+            FakeRoomDriver(coroutineScope, pacing).also { driver = it }
+}
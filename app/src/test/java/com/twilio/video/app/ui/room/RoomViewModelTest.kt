@@ -2,30 +2,41 @@ package com.twilio.video.app.ui.room
 
 import android.Manifest
 import androidx.arch.core.executor.testing.InstantTaskExecutorRule
+import com.twilio.audioswitch.AudioSwitch
+import com.twilio.video.LocalParticipant
 import com.twilio.video.RemoteVideoTrack
 import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.data.Settings
 import com.twilio.video.app.participant.ParticipantManager
 import com.twilio.video.app.participant.ParticipantViewState
 import com.twilio.video.app.sdk.LocalParticipantManager
+import com.twilio.video.app.sdk.NativeObjectRegistry
 import com.twilio.video.app.sdk.RoomManager
+import com.twilio.video.app.sdk.StatsHistory
 import com.twilio.video.app.sdk.VideoTrackViewState
 import com.twilio.video.app.ui.room.RoomEvent.ConnectFailure
+import com.twilio.video.app.ui.room.RoomEvent.Connected
 import com.twilio.video.app.ui.room.RoomEvent.MaxParticipantFailure
 import com.twilio.video.app.ui.room.RoomEvent.RecordingStarted
 import com.twilio.video.app.ui.room.RoomEvent.RecordingStopped
 import com.twilio.video.app.ui.room.RoomEvent.RemoteParticipantEvent.TrackSwitchOff
+import com.twilio.video.app.ui.room.RoomEvent.RoomSwitchFailure
 import com.twilio.video.app.ui.room.RoomViewConfiguration.Lobby
 import com.twilio.video.app.ui.room.RoomViewEffect.Disconnected
 import com.twilio.video.app.ui.room.RoomViewEffect.PermissionsDenied
 import com.twilio.video.app.ui.room.RoomViewEffect.ShowConnectFailureDialog
 import com.twilio.video.app.ui.room.RoomViewEffect.ShowMaxParticipantFailureDialog
+import com.twilio.video.app.ui.room.RoomViewEffect.ShowStatsShareSheet
 import com.twilio.video.app.ui.room.RoomViewEvent.Connect
 import com.twilio.video.app.ui.room.RoomViewEvent.OnResume
+import com.twilio.video.app.ui.room.RoomViewEvent.ShareStats
 import com.twilio.video.app.util.PermissionUtil
+import dagger.Lazy
 import io.uniflow.android.test.TestViewObserver
 import io.uniflow.android.test.createTestObserver
 import io.uniflow.test.rule.UniflowTestDispatchersRule
 import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.test.TestCoroutineDispatcher
 import org.hamcrest.CoreMatchers.`is`
 import org.hamcrest.CoreMatchers.equalTo
@@ -34,6 +45,7 @@ import org.hamcrest.MatcherAssert.assertThat
 import org.junit.Before
 import org.junit.Rule
 import org.junit.Test
+import org.mockito.kotlin.doReturn
 import org.mockito.kotlin.mock
 import org.mockito.kotlin.verify
 import org.mockito.kotlin.whenever
@@ -51,7 +63,8 @@ class RoomViewModelTest : BaseUnitTest() {
     val coroutineScope = UniflowTestDispatchersRule(testDispatcher)
 
     private val localParticipantManager = mock<LocalParticipantManager>()
-    private val roomManager = RoomManager(mock(), mock(), mock(), testDispatcher).apply {
+    private val roomManager = RoomManager(mock(), mock(), testDispatcher,
+            settings = MutableStateFlow(Settings()), captureProfileStore = mock(), nativeObjects = NativeObjectRegistry { 0 }).apply {
         localParticipantManager = this@RoomViewModelTest.localParticipantManager
     }
     private val participantViewState = ParticipantViewState(PARTICIPANT_SID, "Test Participant")
@@ -68,9 +81,10 @@ class RoomViewModelTest : BaseUnitTest() {
     fun setUp() {
         viewModel = RoomViewModel(
                 roomManager,
-                mock(),
+                Lazy { mock<AudioSwitch>() },
                 permissionUtil,
-                participantManager)
+                participantManager,
+                roomEventPacing = RoomEventPacing.Immediate)
         testObserver = viewModel.createTestObserver()
     }
 
@@ -118,10 +132,11 @@ class RoomViewModelTest : BaseUnitTest() {
     fun `The OnResume event should set the isCameraEnabled view state property to false if camera permission is denied`() {
         viewModel = RoomViewModel(
                 roomManager,
-                mock(),
+                Lazy { mock<AudioSwitch>() },
                 permissionUtil,
                 participantManager,
-                initialViewState = initialRoomViewState.copy(isCameraEnabled = true))
+                initialViewState = initialRoomViewState.copy(isCameraEnabled = true),
+                roomEventPacing = RoomEventPacing.Immediate)
         whenever(permissionUtil.isPermissionGranted(Manifest.permission.CAMERA))
                 .thenReturn(false)
         val expectedViewState = initialRoomViewState.copy(isCameraEnabled = false)
@@ -148,10 +163,11 @@ class RoomViewModelTest : BaseUnitTest() {
     fun `The OnResume event should set the isMicEnabled view state property to false if camera permission is denied`() {
         viewModel = RoomViewModel(
                 roomManager,
-                mock(),
+                Lazy { mock<AudioSwitch>() },
                 permissionUtil,
                 participantManager,
-                initialViewState = initialRoomViewState.copy(isCameraEnabled = true))
+                initialViewState = initialRoomViewState.copy(isCameraEnabled = true),
+                roomEventPacing = RoomEventPacing.Immediate)
         whenever(permissionUtil.isPermissionGranted(Manifest.permission.RECORD_AUDIO))
                 .thenReturn(false)
         val expectedViewState = initialRoomViewState.copy(isMicEnabled = false)
@@ -205,6 +221,23 @@ class RoomViewModelTest : BaseUnitTest() {
                         participantThumbnails = listOf(localParticipantViewState)))
     }
 
+    @Test
+    fun `The RoomSwitchFailure event should send a ShowConnectFailureDialog ViewEffect and stay in the room`() {
+        connect()
+        roomManager.sendRoomEvent(RoomSwitchFailure("Breakout Room"))
+
+        testObserver.verifySequence(
+                initialRoomViewState.copy(configuration = RoomViewConfiguration.Connecting),
+                ShowConnectFailureDialog)
+    }
+
+    @Test
+    fun `The ShareStats event should send the exported stats in a ShowStatsShareSheet ViewEffect`() {
+        viewModel.processInput(ShareStats)
+
+        testObserver.verifySequence(ShowStatsShareSheet(StatsHistory.EXPORT_HEADER))
+    }
+
     @Test
     fun `The RecordingStarted event should set the isRecording property to true`() {
         connect()
@@ -238,6 +271,16 @@ class RoomViewModelTest : BaseUnitTest() {
         assertThat(viewModel.roomManagerJob!!.isCancelled, equalTo(true))
     }
 
+    @Test
+    fun `The Connected event should keep the switch off control the room was connected with`() {
+        val localParticipant = mock<LocalParticipant> { on { sid } doReturn "local" }
+        connect()
+        roomManager.sendRoomEvent(Connected(listOf(localParticipant), mock(), "Test Room",
+                isManualSwitchOffEnabled = true))
+
+        assertThat((viewModel.getState() as RoomViewState).isManualSwitchOffEnabled, equalTo(true))
+    }
+
     private fun connect() =
         viewModel.processInput(Connect("Test", "Test Room"))
 }
@@ -0,0 +1,66 @@
+package com.twilio.video.app.ui.room
+
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.participant.ParticipantViewState
+import com.twilio.video.app.sdk.QualityLevel
+import com.twilio.video.app.sdk.RoomStats
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+
+class RoomViewSliceTest : BaseUnitTest() {
+
+    private val localParticipant = ParticipantViewState("local", "You", isLocalParticipant = true)
+    private val remoteParticipant = ParticipantViewState("remote", "Remote")
+    private val state = RoomViewState(remoteParticipant,
+            configuration = RoomViewConfiguration.Connected,
+            participantThumbnails = listOf(localParticipant, remoteParticipant))
+
+    @Test
+    fun `changedRoomViewSlices should render every slice without a rendered state`() {
+        assertThat(changedRoomViewSlices(null, state), equalTo(RoomViewSlice.values().toSet()))
+    }
+
+    @Test
+    fun `changedRoomViewSlices should only render the stats on a stats update`() {
+        val roomStats = RoomStats(emptyMap(), emptyMap())
+
+        assertThat(changedRoomViewSlices(state, state.copy(roomStats = roomStats)),
+                equalTo(setOf(RoomViewSlice.STATS)))
+    }
+
+    @Test
+    fun `changedRoomViewSlices should only render the thumbnails when a thumbnail changes`() {
+        val mutedParticipant = remoteParticipant.copy(isMuted = true)
+        val newState = state.copy(participantThumbnails = listOf(localParticipant, mutedParticipant))
+
+        assertThat(changedRoomViewSlices(state, newState), equalTo(setOf(RoomViewSlice.THUMBNAILS)))
+    }
+
+    @Test
+    fun `changedRoomViewSlices should render the stats when the participant count changes`() {
+        val newState = state.copy(participantThumbnails = listOf(localParticipant))
+
+        assertThat(changedRoomViewSlices(state, newState),
+                equalTo(setOf(RoomViewSlice.THUMBNAILS, RoomViewSlice.STATS)))
+    }
+
+    @Test
+    fun `changedRoomViewSlices should render the video slices when the quality level changes`() {
+        val newState = state.copy(qualityLevel = QualityLevel.NO_THUMBNAILS)
+
+        assertThat(changedRoomViewSlices(state, newState),
+                equalTo(setOf(RoomViewSlice.PRIMARY_VIEW, RoomViewSlice.THUMBNAILS)))
+    }
+
+    @Test
+    fun `changedRoomViewSlices should only render the controls when a control changes`() {
+        assertThat(changedRoomViewSlices(state, state.copy(isAudioMuted = true)),
+                equalTo(setOf(RoomViewSlice.CONTROLS)))
+    }
+
+    @Test
+    fun `changedRoomViewSlices should render nothing for an equal state`() {
+        assertThat(changedRoomViewSlices(state, state.copy()), equalTo(emptySet()))
+    }
+}
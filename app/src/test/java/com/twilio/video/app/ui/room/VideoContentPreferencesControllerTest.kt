@@ -0,0 +1,91 @@
+package com.twilio.video.app.ui.room
+
+import android.view.View
+import com.twilio.video.RemoteVideoTrack
+import com.twilio.video.VideoContentPreferences
+import com.twilio.video.app.BaseUnitTest
+import org.junit.Test
+import org.mockito.kotlin.any
+import org.mockito.kotlin.argThat
+import org.mockito.kotlin.argumentCaptor
+import org.mockito.kotlin.doReturn
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.never
+import org.mockito.kotlin.times
+import org.mockito.kotlin.verify
+import org.mockito.kotlin.whenever
+
+class VideoContentPreferencesControllerTest : BaseUnitTest() {
+
+    private val controller = VideoContentPreferencesController().apply {
+        isManualContentPreferencesEnabled = true
+    }
+    private val videoTrack = mock<RemoteVideoTrack>()
+
+    @Test
+    fun `onRenderStarted should prefer the largest size of the rendering views`() {
+        controller.onRenderStarted(videoTrack, mockView(160, 90))
+        controller.onRenderStarted(videoTrack, mockView(1280, 720))
+
+        verify(videoTrack).setContentPreferences(renderDimensions(160, 90))
+        verify(videoTrack).setContentPreferences(renderDimensions(1280, 720))
+    }
+
+    @Test
+    fun `onRenderStopped should fall back to the size of the remaining views`() {
+        val primaryView = mockView(1280, 720)
+        controller.onRenderStarted(videoTrack, mockView(160, 90))
+        controller.onRenderStarted(videoTrack, primaryView)
+
+        controller.onRenderStopped(videoTrack, primaryView)
+
+        verify(videoTrack, times(2)).setContentPreferences(renderDimensions(160, 90))
+    }
+
+    @Test
+    fun `a layout change should update the content preferences`() {
+        val view = mockView(0, 0)
+        controller.onRenderStarted(videoTrack, view)
+        verify(videoTrack, never()).setContentPreferences(any())
+
+        val layoutListener = argumentCaptor<View.OnLayoutChangeListener>()
+        verify(view).addOnLayoutChangeListener(layoutListener.capture())
+        mockSize(view, 720, 1280)
+        layoutListener.firstValue.onLayoutChange(view, 0, 0, 720, 1280, 0, 0, 0, 0)
+
+        verify(videoTrack).setContentPreferences(renderDimensions(720, 1280))
+    }
+
+    @Test
+    fun `a prefetched track should prefer the lowest layer until it is rendered`() {
+        val view = mockView(1280, 720)
+        controller.onPrefetchStarted(videoTrack)
+        controller.onRenderStarted(videoTrack, view)
+
+        controller.onRenderStopped(videoTrack, view)
+
+        verify(videoTrack, times(2)).setContentPreferences(
+                renderDimensions(PREFETCH_VIDEO_DIMENSIONS.width, PREFETCH_VIDEO_DIMENSIONS.height))
+        verify(videoTrack).setContentPreferences(renderDimensions(1280, 720))
+    }
+
+    @Test
+    fun `content preferences should not be sent without manual content preferences mode`() {
+        controller.isManualContentPreferencesEnabled = false
+
+        controller.onRenderStarted(videoTrack, mockView(160, 90))
+
+        verify(videoTrack, never()).setContentPreferences(any())
+    }
+
+    private fun renderDimensions(width: Int, height: Int) = argThat<VideoContentPreferences> {
+        renderDimensions?.width == width && renderDimensions?.height == height
+    }
+
+    private fun mockView(width: Int, height: Int): View = mock<View>().also { mockSize(it, width, height) }
+
+    private fun mockSize(view: View, width: Int, height: Int) {
+        whenever(view.width) doReturn width
+        whenever(view.height) doReturn height
+    }
+}
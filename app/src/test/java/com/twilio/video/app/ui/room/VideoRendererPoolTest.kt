@@ -0,0 +1,84 @@
+package com.twilio.video.app.ui.room
+
+import android.content.Context
+import com.twilio.video.VideoTextureView
+import com.twilio.video.VideoTrack
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.CoreMatchers.nullValue
+import org.hamcrest.CoreMatchers.sameInstance
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.any
+import org.mockito.kotlin.doAnswer
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.verify
+
+class VideoRendererPoolTest : BaseUnitTest() {
+
+    private val parking = mock<VideoRendererLayout>()
+    private var createdRendererCount = 0
+    private val rendererPool = VideoRendererPool(parking, maxRenderers = 2, maxIdleRenderers = 2) {
+        createdRendererCount++
+        mock()
+    }
+    private val videoTrack1 = mock<VideoTrack>()
+    private val videoTrack2 = mock<VideoTrack>()
+
+    @Test
+    fun `acquire should lend the idle renderer that last rendered the track`() {
+        val renderer1 = rendererPool.acquire(mockParticipantView(), videoTrack1)!!
+        val renderer2 = rendererPool.acquire(mockParticipantView(), videoTrack2)!!
+        release(renderer1, videoTrack1)
+        release(renderer2, videoTrack2)
+
+        assertThat(rendererPool.acquire(mockParticipantView(), videoTrack1), sameInstance(renderer1))
+        assertThat(createdRendererCount, equalTo(2))
+    }
+
+    @Test
+    fun `acquire should keep the renderer of a view`() {
+        val view = mockParticipantView()
+        val renderer = rendererPool.acquire(view, videoTrack1)
+
+        assertThat(rendererPool.acquire(view, videoTrack2), sameInstance(renderer))
+        assertThat(createdRendererCount, equalTo(1))
+    }
+
+    @Test
+    fun `acquire should not lend more than the maximum number of renderers`() {
+        rendererPool.acquire(mockParticipantView(), videoTrack1)
+        rendererPool.acquire(mockParticipantView(), videoTrack2)
+
+        assertThat(rendererPool.acquire(mockParticipantView(), videoTrack1), nullValue())
+    }
+
+    @Test
+    fun `release should drop the least recently released renderer beyond the idle maximum`() {
+        val rendererPool = VideoRendererPool(parking, maxIdleRenderers = 1) { mock() }
+        val renderer1 = rendererPool.acquire(mockParticipantView(), videoTrack1)!!
+        val renderer2 = rendererPool.acquire(mockParticipantView(), videoTrack2)!!
+
+        rendererPool.release(mockParticipantView(renderer1), videoTrack1)
+        rendererPool.release(mockParticipantView(renderer2), videoTrack2)
+
+        verify(parking).adopt(renderer2)
+        verify(parking).removeView(renderer1)
+    }
+
+    private fun release(renderer: VideoTextureView, videoTrack: VideoTrack) =
+            rendererPool.release(mockParticipantView(renderer), videoTrack)
+
+    private fun mockParticipantView(renderer: VideoTextureView? = null): ParticipantView {
+        var videoTextureView = renderer
+        val context = mock<Context>()
+        return mock {
+            on { getContext() } doAnswer { context }
+            on { this.videoTextureView } doAnswer { videoTextureView }
+            on { attachVideoTextureView(any()) } doAnswer {
+                videoTextureView = it.getArgument(0)
+                Unit
+            }
+        }
+    }
+}
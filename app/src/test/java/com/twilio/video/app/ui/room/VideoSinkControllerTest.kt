@@ -0,0 +1,197 @@
+package com.twilio.video.app.ui.room
+
+import android.os.Handler
+import com.twilio.video.RemoteVideoTrack
+import com.twilio.video.VideoTextureView
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.CoreMatchers.notNullValue
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.any
+import org.mockito.kotlin.anyOrNull
+import org.mockito.kotlin.doAnswer
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.never
+import org.mockito.kotlin.times
+import org.mockito.kotlin.verify
+import org.mockito.kotlin.whenever
+import tvi.webrtc.VideoSink
+
+class VideoSinkControllerTest : BaseUnitTest() {
+
+    private val pendingRunnables = mutableListOf<Runnable>()
+    private val handler = mock<Handler> {
+        on { postDelayed(any(), any()) } doAnswer {
+            pendingRunnables.add(it.getArgument(0))
+            true
+        }
+        on { removeCallbacks(any()) } doAnswer {
+            pendingRunnables.remove(it.getArgument(0))
+            Unit
+        }
+    }
+    private val rendererPool = mock<VideoRendererPool> {
+        on { acquire(any(), any()) } doAnswer { it.getArgument<ParticipantView>(0).videoTextureView }
+    }
+    private val videoSinkController = VideoSinkController(rendererPool, handler).apply {
+        isManualSwitchOffEnabled = true
+    }
+    private val sinks = mutableListOf<VideoSink>()
+    private val videoTrack = mock<RemoteVideoTrack> {
+        on { isEnabled } doAnswer { true }
+        on { sinks } doAnswer { sinks }
+    }
+    private val primaryView = mockParticipantView()
+    private val thumbView = mockParticipantView()
+    private val lentRenderers = HashMap<ParticipantView, VideoTextureView>()
+
+    init {
+        whenever(videoTrack.addSink(any())).doAnswer { sinks.add(it.getArgument(0)); Unit }
+        whenever(videoTrack.removeSink(any())).doAnswer { sinks.remove(it.getArgument(0)); Unit }
+    }
+
+    @Test
+    fun `removeSink should switch off a track once no view renders it`() {
+        videoSinkController.addSink(videoTrack, primaryView)
+        videoSinkController.addSink(videoTrack, thumbView)
+
+        videoSinkController.removeSink(videoTrack, thumbView)
+        runPendingRunnables()
+        verify(videoTrack, never()).switchOff()
+
+        videoSinkController.removeSink(videoTrack, primaryView)
+        runPendingRunnables()
+        verify(videoTrack).switchOff()
+    }
+
+    @Test
+    fun `addSink should cancel a pending switch off`() {
+        videoSinkController.addSink(videoTrack, thumbView)
+        videoSinkController.removeSink(videoTrack, thumbView)
+        videoSinkController.addSink(videoTrack, thumbView)
+        runPendingRunnables()
+
+        verify(videoTrack, never()).switchOff()
+        verify(videoTrack, never()).switchOn()
+    }
+
+    @Test
+    fun `addSink should switch a switched off track back on`() {
+        videoSinkController.retainTracks(setOf(videoTrack))
+        runPendingRunnables()
+        verify(videoTrack).switchOff()
+
+        videoSinkController.addSink(videoTrack, thumbView)
+
+        verify(videoTrack).switchOn()
+    }
+
+    @Test
+    fun `removeSink should return the renderer of the view to the pool`() {
+        videoSinkController.addSink(videoTrack, thumbView)
+
+        videoSinkController.removeSink(videoTrack, thumbView)
+
+        verify(rendererPool).release(thumbView, videoTrack)
+    }
+
+    @Test
+    fun `removeSink should keep the renderer of a view that renders another track`() {
+        videoSinkController.addSink(videoTrack, primaryView)
+
+        videoSinkController.removeSink(videoTrack, primaryView, keepRenderer = true)
+
+        verify(videoTrack).removeSink(primaryView.videoTextureView!!)
+        verify(rendererPool, never()).release(any(), anyOrNull())
+    }
+
+    @Test
+    fun `addSink should take the renderer of a view that is not shown once every renderer is lent`() {
+        val videoSinkController = VideoSinkController(lendingPool(rendererCount = 1), handler)
+        val hiddenView = lendingView(isShown = false)
+        val shownView = lendingView()
+        videoSinkController.addSink(videoTrack, hiddenView)
+
+        videoSinkController.addSink(videoTrack, shownView)
+
+        assertThat(shownView.videoTextureView, notNullValue())
+        verify(hiddenView).setState(ParticipantView.State.SWITCHED_OFF)
+        assertThat(videoSinkController.isWaitingForRenderer(hiddenView), equalTo(true))
+    }
+
+    @Test
+    fun `addSink should show the stub until a renderer is returned`() {
+        val videoSinkController = VideoSinkController(lendingPool(rendererCount = 1), handler)
+        val firstView = lendingView()
+        val secondView = lendingView()
+        videoSinkController.addSink(videoTrack, firstView)
+        videoSinkController.addSink(videoTrack, secondView)
+        verify(secondView).setState(ParticipantView.State.SWITCHED_OFF)
+
+        videoSinkController.removeSink(videoTrack, firstView)
+
+        verify(secondView).setState(ParticipantView.State.VIDEO)
+        assertThat(sinks, equalTo(listOf<VideoSink>(secondView.videoTextureView!!)))
+        assertThat(videoSinkController.isWaitingForRenderer(secondView), equalTo(false))
+    }
+
+    @Test
+    fun `prefetchTracks should keep a track switched on until the prefetch stops`() {
+        videoSinkController.retainTracks(setOf(videoTrack))
+        runPendingRunnables()
+        videoSinkController.prefetchTracks(setOf(videoTrack))
+        verify(videoTrack).switchOn()
+
+        videoSinkController.retainTracks(setOf(videoTrack))
+        runPendingRunnables()
+        verify(videoTrack).switchOff()
+
+        videoSinkController.prefetchTracks(emptySet())
+        runPendingRunnables()
+        verify(videoTrack, times(2)).switchOff()
+    }
+
+    @Test
+    fun `tracks should not be switched off without manual switch off control`() {
+        videoSinkController.isManualSwitchOffEnabled = false
+
+        videoSinkController.addSink(videoTrack, thumbView)
+        videoSinkController.removeSink(videoTrack, thumbView)
+        videoSinkController.retainTracks(setOf(videoTrack))
+        runPendingRunnables()
+
+        verify(videoTrack, never()).switchOff()
+    }
+
+    private fun runPendingRunnables() {
+        pendingRunnables.toList().forEach { it.run() }
+        pendingRunnables.clear()
+    }
+
+    private fun lendingPool(rendererCount: Int): VideoRendererPool {
+        val idleRenderers = MutableList(rendererCount) { mock<VideoTextureView>() }
+        return mock {
+            on { acquire(any(), any()) } doAnswer {
+                val view = it.getArgument<ParticipantView>(0)
+                lentRenderers[view] ?: idleRenderers.removeLastOrNull()?.also { renderer ->
+                    lentRenderers[view] = renderer
+                }
+            }
+            on { release(any(), anyOrNull()) } doAnswer {
+                lentRenderers.remove(it.getArgument(0))?.let { renderer -> idleRenderers.add(renderer) }
+                Unit
+            }
+        }
+    }
+
+    private fun lendingView(isShown: Boolean = true): ParticipantView = mock {
+        on { videoTextureView } doAnswer { lentRenderers[it.mock as ParticipantView] }
+        on { this.isShown } doAnswer { isShown }
+    }
+
+    private fun mockParticipantView(): ParticipantView {
+        val textureView = mock<VideoTextureView>()
+        return mock { on { videoTextureView } doAnswer { textureView } }
+    }
+}
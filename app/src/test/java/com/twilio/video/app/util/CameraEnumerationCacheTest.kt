@@ -0,0 +1,64 @@
+package com.twilio.video.app.util
+
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.CoreMatchers.nullValue
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+
+class CameraEnumerationCacheTest : BaseUnitTest() {
+
+    private val cache = CameraEnumerationCache()
+    private var enumerationCount = 0
+
+    @Test
+    fun `a complete enumeration should be reused`() {
+        enumerate(CameraEnumeration("1" to "0", isComplete = true))
+        val cameraIds = enumerate(CameraEnumeration("2" to "3", isComplete = true))
+
+        assertThat(cameraIds, equalTo("1" to "0"))
+        assertThat(enumerationCount, equalTo(1))
+    }
+
+    @Test
+    fun `each camera API should be enumerated on its own`() {
+        enumerate(CameraEnumeration("1" to "0", isComplete = true))
+        val cameraIds = enumerate(CameraEnumeration("1" to null, isComplete = true), isCamera2 = false)
+
+        assertThat(cameraIds, equalTo("1" to null))
+        assertThat(enumerationCount, equalTo(2))
+    }
+
+    @Test
+    fun `an enumeration that failed to read a camera should be repeated`() {
+        val firstCameraIds = enumerate(CameraEnumeration(null to "0", isComplete = false))
+        val cameraIds = enumerate(CameraEnumeration("1" to "0", isComplete = true))
+
+        assertThat(firstCameraIds, equalTo(null to "0"))
+        assertThat(cameraIds, equalTo("1" to "0"))
+        assertThat(enumerationCount, equalTo(2))
+    }
+
+    @Test
+    fun `an enumeration without cameras should be repeated`() {
+        val firstCameraIds = enumerate(CameraEnumeration(null, isComplete = true))
+        val cameraIds = enumerate(CameraEnumeration("1" to "0", isComplete = true))
+
+        assertThat(firstCameraIds, nullValue())
+        assertThat(cameraIds, equalTo("1" to "0"))
+        assertThat(enumerationCount, equalTo(2))
+    }
+
+    @Test
+    fun `only a supported Camera2 should be remembered`() {
+        var checkCount = 0
+
+        assertThat(cache.isCamera2Supported { checkCount++; false }, equalTo(false))
+        assertThat(cache.isCamera2Supported { checkCount++; true }, equalTo(true))
+        assertThat(cache.isCamera2Supported { checkCount++; false }, equalTo(true))
+        assertThat(checkCount, equalTo(2))
+    }
+
+    private fun enumerate(enumeration: CameraEnumeration, isCamera2: Boolean = true) =
+            cache.getFrontAndBackCameraIds(isCamera2) { enumeration.also { enumerationCount++ } }
+}
@@ -0,0 +1,144 @@
+package com.twilio.video.app.util
+
+import android.os.Handler
+import com.twilio.video.app.BaseUnitTest
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.any
+import org.mockito.kotlin.doAnswer
+import org.mockito.kotlin.doReturn
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.never
+import org.mockito.kotlin.verify
+import org.mockito.kotlin.verifyZeroInteractions
+import tvi.webrtc.CapturerObserver
+import tvi.webrtc.SurfaceTextureHelper
+import tvi.webrtc.VideoFrame
+
+class FrameProcessorPipelineTest : BaseUnitTest() {
+
+    private val downstream: CapturerObserver = mock()
+    private val cameraFrame: VideoFrame = mock()
+    private val processedFrame: VideoFrame = mock()
+    private val nowNanos = LongArray(1)
+    private var isTextureThreadAlive = true
+    private val textureHandler: Handler = mock {
+        on { post(any()) } doAnswer { invocation ->
+            if (isTextureThreadAlive) invocation.getArgument<Runnable>(0).run()
+            isTextureThreadAlive
+        }
+    }
+
+    @Test
+    fun `onFrameCaptured should pass unchanged frames to the downstream observer`() {
+        val pipeline = newPipeline(TestProcessor("first") { it }, TestProcessor("second") { it })
+
+        pipeline.onFrameCaptured(cameraFrame)
+
+        verify(downstream).onFrameCaptured(cameraFrame)
+        verifyZeroInteractions(cameraFrame)
+    }
+
+    @Test
+    fun `onFrameCaptured should release the frames created by the stages once they are consumed`() {
+        val blurredFrame: VideoFrame = mock()
+        val pipeline = newPipeline(
+                TestProcessor("blur") { blurredFrame },
+                TestProcessor("overlay") { processedFrame })
+
+        pipeline.onFrameCaptured(cameraFrame)
+
+        verify(downstream).onFrameCaptured(processedFrame)
+        verify(blurredFrame).release()
+        verify(processedFrame).release()
+        verify(cameraFrame, never()).release()
+    }
+
+    @Test
+    fun `onFrameCaptured should stop at a stage that drops the frame`() {
+        val lastProcessor = TestProcessor("overlay") { it }
+        val pipeline = newPipeline(TestProcessor("throttle") { null }, lastProcessor)
+
+        pipeline.onFrameCaptured(cameraFrame)
+
+        verify(downstream, never()).onFrameCaptured(cameraFrame)
+        assertThat(lastProcessor.processedFrames, equalTo(0))
+    }
+
+    @Test
+    fun `latestStats should report the latency of every stage per interval`() {
+        val pipeline = newPipeline(
+                TestProcessor("blur") { nowNanos[0] += 4_000_000; it },
+                TestProcessor("overlay") { it })
+
+        repeat(FRAME_PROCESSOR_STATS_INTERVAL_FRAMES - 1) { pipeline.onFrameCaptured(cameraFrame) }
+        assertThat(pipeline.latestStats, equalTo(emptyList()))
+
+        pipeline.onFrameCaptured(cameraFrame)
+        assertThat(pipeline.latestStats, equalTo(listOf(
+                FrameProcessorStats("blur", 4.0, 4.0),
+                FrameProcessorStats("overlay", 0.0, 0.0))))
+    }
+
+    @Test
+    fun `onFrameCaptured should initialize every stage once`() {
+        val processor = TestProcessor("blur") { it }
+        val pipeline = newPipeline(processor)
+
+        pipeline.onFrameCaptured(cameraFrame)
+        pipeline.onFrameCaptured(cameraFrame)
+
+        assertThat(processor.initializeCount, equalTo(1))
+    }
+
+    @Test
+    fun `release should release the initialized stages before it returns`() {
+        val processor = TestProcessor("blur") { it }
+        val pipeline = newPipeline(processor)
+        pipeline.onFrameCaptured(cameraFrame)
+
+        pipeline.release()
+
+        assertThat(processor.releaseCount, equalTo(1))
+    }
+
+    @Test
+    fun `release should skip the stages once the texture thread is gone`() {
+        val processor = TestProcessor("blur") { it }
+        val pipeline = newPipeline(processor)
+        pipeline.onFrameCaptured(cameraFrame)
+        isTextureThreadAlive = false
+
+        pipeline.release()
+
+        assertThat(processor.releaseCount, equalTo(0))
+    }
+
+    private fun newPipeline(vararg processors: FrameProcessor): FrameProcessorPipeline {
+        val surfaceTextureHelper: SurfaceTextureHelper = mock { on { handler } doReturn textureHandler }
+        return FrameProcessorPipeline(surfaceTextureHelper, processors.toList(), downstream) { nowNanos[0] }
+    }
+
+    private class TestProcessor(
+        override val name: String,
+        private val process: (VideoFrame) -> VideoFrame?
+    ) : FrameProcessor {
+        var initializeCount = 0
+        var processedFrames = 0
+        var releaseCount = 0
+
+        override fun initialize(texturePool: TextureFramePool) {
+            initializeCount++
+        }
+
+        override fun process(frame: VideoFrame): VideoFrame? {
+            processedFrames++
+            return process.invoke(frame)
+        }
+
+        override fun release() {
+            releaseCount++
+        }
+    }
+}
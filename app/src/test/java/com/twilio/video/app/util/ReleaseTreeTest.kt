@@ -0,0 +1,101 @@
+package com.twilio.video.app.util
+
+import android.util.Log
+import com.twilio.video.app.BaseUnitTest
+import java.text.SimpleDateFormat
+import java.util.Date
+import java.util.Locale
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.inOrder
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.verify
+import org.mockito.kotlin.verifyNoInteractions
+
+class ReleaseTreeTest : BaseUnitTest() {
+
+    private val treeRanger = mock<TreeRanger>()
+    private val ringBuffer = LogRingBuffer(capacity = 2, clock = { 0 })
+    private val tree = ReleaseTree(treeRanger, ringBuffer)
+
+    @Test
+    fun `debug logs should be dropped before they are formatted`() {
+        var formatCount = 0
+        val argument = object : Any() {
+            override fun toString() = "participant".also { formatCount++ }
+        }
+
+        tree.d("Participant: %s", argument)
+        tree.v("Participant: %s", argument)
+
+        assertThat(formatCount, equalTo(0))
+        verifyNoInteractions(treeRanger)
+        assertThat(ringBuffer.size, equalTo(0))
+    }
+
+    @Test
+    fun `info and warn logs should only be kept in the ring buffer`() {
+        tree.i("Connected")
+        tree.w("Reconnecting")
+
+        verifyNoInteractions(treeRanger)
+        assertThat(ringBuffer.size, equalTo(2))
+    }
+
+    @Test
+    fun `errors should flush the latest events to the ranger before the alert`() {
+        val error = IllegalStateException()
+        tree.i("Connecting")
+        tree.i("Connected")
+        tree.w("Reconnecting")
+
+        tree.e(error, "Failed")
+
+        inOrder(treeRanger) {
+            verify(treeRanger).inform(timestamped("Connected"))
+            verify(treeRanger).caution(timestamped("Reconnecting"))
+            verify(treeRanger).alert(error)
+            verifyNoMoreInteractions()
+        }
+        assertThat(ringBuffer.size, equalTo(0))
+    }
+
+    @Test
+    fun `uncaught exceptions should flush the latest events before the previous handler`() {
+        val crash = IllegalStateException()
+        val previousHandler = mock<Thread.UncaughtExceptionHandler>()
+        val defaultHandler = Thread.getDefaultUncaughtExceptionHandler()
+        Thread.setDefaultUncaughtExceptionHandler(previousHandler)
+        try {
+            tree.installUncaughtExceptionHandler()
+            tree.w("Reconnecting")
+
+            Thread.getDefaultUncaughtExceptionHandler()!!.uncaughtException(Thread.currentThread(), crash)
+
+            inOrder(treeRanger, previousHandler) {
+                verify(treeRanger).caution(timestamped("Reconnecting"))
+                verify(previousHandler).uncaughtException(Thread.currentThread(), crash)
+                verifyNoMoreInteractions()
+            }
+        } finally {
+            Thread.setDefaultUncaughtExceptionHandler(defaultHandler)
+        }
+    }
+
+    @Test
+    fun `drain should return the events from the oldest to the newest`() {
+        ringBuffer.add(Log.INFO, "first")
+        ringBuffer.add(Log.WARN, "second")
+        ringBuffer.add(Log.INFO, "third")
+
+        val snapshot = ringBuffer.drain()
+
+        assertThat(snapshot.size, equalTo(2))
+        assertThat(snapshot.priority(0), equalTo(Log.WARN))
+        assertThat(snapshot.line(1), equalTo(timestamped("third")))
+    }
+
+    private fun timestamped(message: String) =
+            "${SimpleDateFormat("HH:mm:ss.SSS", Locale.US).format(Date(0))} $message"
+}
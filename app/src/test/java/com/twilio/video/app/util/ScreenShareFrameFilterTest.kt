@@ -0,0 +1,128 @@
+package com.twilio.video.app.util
+
+import android.os.Handler
+import com.twilio.video.VideoDimensions
+import com.twilio.video.app.BaseUnitTest
+import com.twilio.video.app.sdk.ScreenShareProfile
+import org.hamcrest.CoreMatchers.equalTo
+import org.hamcrest.MatcherAssert.assertThat
+import org.junit.Test
+import org.mockito.kotlin.any
+import org.mockito.kotlin.argumentCaptor
+import org.mockito.kotlin.doReturn
+import org.mockito.kotlin.eq
+import org.mockito.kotlin.mock
+import org.mockito.kotlin.never
+import org.mockito.kotlin.times
+import org.mockito.kotlin.verify
+import tvi.webrtc.CapturerObserver
+import tvi.webrtc.VideoFrame
+
+class ScreenShareFrameFilterTest : BaseUnitTest() {
+
+    private val handler: Handler = mock()
+    private val downstream: CapturerObserver = mock()
+    private var nowNanos = 0L
+    private val motionProfile = ScreenShareProfile(1280, 720, 10, 0)
+
+    @Test
+    fun `targetDimensions should fit the screen into the profile without upscaling`() {
+        assertThat(ScreenShareProfile.TEXT.targetDimensions(1440, 3200), equalTo(VideoDimensions(864, 1920)))
+        assertThat(ScreenShareProfile.MOTION.targetDimensions(2560, 1440), equalTo(VideoDimensions(1280, 720)))
+        assertThat(ScreenShareProfile.MOTION.targetDimensions(640, 360), equalTo(VideoDimensions(640, 360)))
+    }
+
+    @Test
+    fun `onFrameCaptured should send a frame right away once its slot is due`() {
+        val filter = ScreenShareFrameFilter(handler, motionProfile, downstream) { nowNanos }
+        val firstFrame = newFrame()
+        val secondFrame = newFrame()
+
+        filter.onFrameCaptured(firstFrame)
+        nowNanos = 100_000_000
+        filter.onFrameCaptured(secondFrame)
+
+        verify(downstream).onFrameCaptured(firstFrame)
+        verify(downstream).onFrameCaptured(secondFrame)
+        verify(handler, never()).postDelayed(any(), any())
+    }
+
+    @Test
+    fun `onFrameCaptured should hold an early frame until its slot and drop superseded ones`() {
+        val filter = ScreenShareFrameFilter(handler, motionProfile, downstream) { nowNanos }
+        val supersededFrame = newFrame()
+        val latestFrame = newFrame()
+        filter.onFrameCaptured(newFrame())
+
+        nowNanos = 40_000_000
+        filter.onFrameCaptured(supersededFrame)
+        nowNanos = 60_000_000
+        filter.onFrameCaptured(latestFrame)
+        verify(downstream, never()).onFrameCaptured(latestFrame)
+        verify(supersededFrame).release()
+
+        val runnable = argumentCaptor<Runnable>()
+        verify(handler).postDelayed(runnable.capture(), eq(61L))
+        nowNanos = 100_000_000
+        runnable.firstValue.run()
+
+        verify(downstream, never()).onFrameCaptured(supersededFrame)
+        verify(downstream).onFrameCaptured(latestFrame)
+        verify(latestFrame).retain()
+        verify(latestFrame).release()
+    }
+
+    @Test
+    fun `keep-alive should send the last frame again with a later timestamp`() {
+        val profile = motionProfile.copy(keepAliveMillis = 2_000)
+        val filter = ScreenShareFrameFilter(handler, profile, downstream) { nowNanos }
+        val frame = newFrame()
+        filter.onFrameCaptured(frame)
+
+        val runnable = argumentCaptor<Runnable>()
+        verify(handler).postDelayed(runnable.capture(), eq(2_000L))
+        nowNanos = 2_000_000_000
+        runnable.firstValue.run()
+
+        val frames = argumentCaptor<VideoFrame>()
+        verify(downstream, times(2)).onFrameCaptured(frames.capture())
+        assertThat(frames.secondValue.buffer, equalTo(frame.buffer))
+        assertThat(frames.secondValue.timestampNs, equalTo(frames.firstValue.timestampNs + 2_000_000_000))
+        verify(frame.buffer, never()).toI420()
+    }
+
+    @Test
+    fun `keep-alive should send a copy of the last texture frame without reading it back`() {
+        val textureBuffer: VideoFrame.TextureBuffer = mock { on { width } doReturn 640; on { height } doReturn 360 }
+        val frame: VideoFrame = mock { on { buffer } doReturn textureBuffer }
+        val copiedBuffer: VideoFrame.TextureBuffer = mock()
+        val copiedFrame: VideoFrame = mock { on { buffer } doReturn copiedBuffer }
+        val texturePool: TextureFramePool = mock { on { copy(frame) } doReturn copiedFrame }
+        val profile = motionProfile.copy(keepAliveMillis = 2_000)
+        val filter = ScreenShareFrameFilter(handler, profile, downstream, { texturePool }) { nowNanos }
+        filter.onFrameCaptured(frame)
+
+        val runnable = argumentCaptor<Runnable>()
+        verify(handler).postDelayed(runnable.capture(), eq(2_000L))
+        runnable.firstValue.run()
+        filter.onCapturerStopped()
+
+        val frames = argumentCaptor<VideoFrame>()
+        verify(downstream, times(2)).onFrameCaptured(frames.capture())
+        assertThat(frames.secondValue.buffer, equalTo(copiedBuffer as VideoFrame.Buffer))
+        verify(textureBuffer, never()).toI420()
+        verify(copiedFrame).release()
+        verify(texturePool).release()
+    }
+
+    private fun newFrame(): VideoFrame {
+        val buffer: VideoFrame.Buffer = mock {
+            on { width } doReturn 640
+            on { height } doReturn 360
+        }
+        return mock {
+            on { this.buffer } doReturn buffer
+            on { timestampNs } doReturn 1_000L
+        }
+    }
+}
@@ -10,6 +10,7 @@ import dagger.Module
 import dagger.Provides
 import dagger.hilt.components.SingletonComponent
 import dagger.hilt.testing.TestInstallIn
+import javax.inject.Provider
 import kotlinx.coroutines.Dispatchers
 
 @Module
@@ -22,8 +23,8 @@ class MockCommunityAuthModule {
     fun providesCommunityAuthenticator(
         preferences: SharedPreferences,
         securePreferences: SecurePreferences,
-        tokenService: TokenService
+        tokenService: Provider<TokenService>
     ): Authenticator {
-        return CommunityAuthenticator(preferences, securePreferences, tokenService, Dispatchers.Main)
+        return CommunityAuthenticator(preferences, securePreferences, lazy { tokenService.get() }, Dispatchers.Main)
     }
 }
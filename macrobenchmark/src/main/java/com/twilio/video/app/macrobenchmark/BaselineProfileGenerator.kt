@@ -0,0 +1,48 @@
+package com.twilio.video.app.macrobenchmark
+
+import androidx.benchmark.macro.ExperimentalBaselineProfilesApi
+import androidx.benchmark.macro.junit4.BaselineProfileRule
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import androidx.test.platform.app.InstrumentationRegistry
+import androidx.test.uiautomator.UiDevice
+import org.junit.Assume.assumeTrue
+import org.junit.Before
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * Generates the Baseline Profile of the splash screen, the lobby and joining [benchmarkRoomName].
+ * Collecting a profile needs root, so the generator is skipped unless adb runs as root, e.g. on an
+ * emulator image without Google Play. The profile is pulled from the device into the build outputs.
+ * The app does not ship it yet, packaging a profile needs AGP 7.1 and the profile installer.
+ */
+@OptIn(ExperimentalBaselineProfilesApi::class)
+@RunWith(AndroidJUnit4::class)
+@LargeTest
+class BaselineProfileGenerator {
+
+    @get:Rule
+    val baselineProfileRule = BaselineProfileRule()
+
+    @Before
+    fun setUp() {
+        val device = UiDevice.getInstance(InstrumentationRegistry.getInstrumentation())
+        assumeTrue("Generating a Baseline Profile requires adb root",
+                device.executeShellCommand("id -u").trim() == "0")
+        device.prepareApp()
+    }
+
+    @Test
+    fun splashToRoom() {
+        val roomName = benchmarkRoomName
+        baselineProfileRule.collectBaselineProfile(packageName = TARGET_PACKAGE) {
+            pressHome()
+            startActivityAndWait()
+            enterRoomName(roomName)
+            joinRoom()
+            leaveRoom()
+        }
+    }
+}
@@ -0,0 +1,79 @@
+package com.twilio.video.app.macrobenchmark
+
+import androidx.benchmark.macro.MacrobenchmarkScope
+import androidx.test.platform.app.InstrumentationRegistry
+import androidx.test.uiautomator.By
+import androidx.test.uiautomator.UiDevice
+import androidx.test.uiautomator.UiObject2
+import androidx.test.uiautomator.Until
+import java.util.UUID
+import org.junit.Assume.assumeTrue
+
+const val TARGET_PACKAGE = "com.twilio.video.app.community"
+private const val SPLASH_ACTIVITY = "$TARGET_PACKAGE/com.twilio.video.app.ui.splash.SplashActivity"
+private const val UI_TIMEOUT_MILLIS = 10_000L
+private const val CONNECT_TIMEOUT_MILLIS = 30_000L
+
+private val arguments get() = InstrumentationRegistry.getArguments()
+
+/** The room to join, which needs remote participants publishing video for the join benchmarks. */
+val benchmarkRoomName: String
+    get() = arguments.getString("roomName")
+            .also { assumeTrue("The roomName instrumentation argument is required", it != null) }!!
+
+/**
+ * Grants the runtime permissions and logs in with the passcode instrumentation argument once, so
+ * that every measured start lands in the lobby. Must be called before the first iteration because
+ * it leaves the app process running.
+ */
+fun UiDevice.prepareApp() {
+    listOf("android.permission.CAMERA", "android.permission.RECORD_AUDIO").forEach {
+        executeShellCommand("pm grant $TARGET_PACKAGE $it")
+    }
+    executeShellCommand("am start -W -n $SPLASH_ACTIVITY")
+    val name = wait(Until.findObject(By.res(TARGET_PACKAGE, "name")), UI_TIMEOUT_MILLIS)
+    if (name != null) {
+        val passcode = arguments.getString("passcode")
+        assumeTrue("The passcode instrumentation argument is required", passcode != null)
+        name.text = "Benchmark ${UUID.randomUUID().toString().take(8)}"
+        findObject(By.res(TARGET_PACKAGE, "passcode")).text = passcode
+        findObject(By.res(TARGET_PACKAGE, "login")).click()
+    }
+    waitForLobby()
+    pressHome()
+}
+
+fun UiDevice.waitForLobby(): UiObject2 =
+        checkNotNull(wait(Until.findObject(By.res(TARGET_PACKAGE, "room_name")), UI_TIMEOUT_MILLIS)) {
+            "The lobby was not displayed"
+        }
+
+fun MacrobenchmarkScope.enterRoomName(roomName: String) {
+    device.waitForLobby().text = roomName
+}
+
+/** Joins the room entered in the lobby and waits for the thumbnail of a remote participant. */
+fun MacrobenchmarkScope.joinRoom() {
+    device.findObject(By.res(TARGET_PACKAGE, "connect")).click()
+    val thumbnails = checkNotNull(device.wait(
+            Until.findObject(By.res(TARGET_PACKAGE, "remote_video_thumbnails")),
+            CONNECT_TIMEOUT_MILLIS)) { "The room was not joined" }
+    // The local participant always has the first thumbnail
+    check(thumbnails.waitUntil({ it.childCount > 1 }, CONNECT_TIMEOUT_MILLIS)) {
+        "No remote participant joined"
+    }
+}
+
+fun MacrobenchmarkScope.leaveRoom() {
+    device.findObject(By.res(TARGET_PACKAGE, "disconnect"))?.click()
+    device.waitForLobby()
+}
+
+private fun UiObject2.waitUntil(condition: (UiObject2) -> Boolean, timeoutMillis: Long): Boolean {
+    val endMillis = System.currentTimeMillis() + timeoutMillis
+    while (!condition(this)) {
+        if (System.currentTimeMillis() >= endMillis) return false
+        Thread.sleep(100)
+    }
+    return true
+}
@@ -0,0 +1,64 @@
+package com.twilio.video.app.macrobenchmark
+
+import androidx.benchmark.macro.ExperimentalMetricApi
+import androidx.benchmark.macro.FrameTimingMetric
+import androidx.benchmark.macro.TraceSectionMetric
+import androidx.benchmark.macro.junit4.MacrobenchmarkRule
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import androidx.test.platform.app.InstrumentationRegistry
+import androidx.test.uiautomator.UiDevice
+import org.junit.Before
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * The async sections the JoinTracer of the app traces for a join, the whole join up to the first
+ * remote frame and every phase between two of its milestones.
+ */
+private val joinSectionNames = listOf("Join") + listOf(
+        "JOIN_REQUESTED",
+        "CONNECT_OPTIONS_REQUESTED",
+        "CONNECT_OPTIONS_CREATED",
+        "ROOM_CONNECTED",
+        "LOCAL_TRACKS_PUBLISHING",
+        "LOCAL_TRACK_PUBLISHED",
+        "REMOTE_VIDEO_TRACK_SUBSCRIBED"
+).map { milestone -> "Join after $milestone" }
+
+/**
+ * Measures joining [benchmarkRoomName] from the lobby until a remote participant is rendered. The
+ * frame timing of the join is reported along with the duration of the join and of every one of its
+ * phases, from the sections the JoinTracer of the app traces.
+ */
+@OptIn(ExperimentalMetricApi::class)
+@RunWith(AndroidJUnit4::class)
+@LargeTest
+class JoinBenchmark {
+
+    @get:Rule
+    val benchmarkRule = MacrobenchmarkRule()
+
+    @Before
+    fun setUp() {
+        UiDevice.getInstance(InstrumentationRegistry.getInstrumentation()).prepareApp()
+    }
+
+    @Test
+    fun joinToFirstRemoteFrame() {
+        val roomName = benchmarkRoomName
+        benchmarkRule.measureRepeated(
+                packageName = TARGET_PACKAGE,
+                metrics = listOf(FrameTimingMetric()) + joinSectionNames.map { TraceSectionMetric(it) },
+                iterations = 5,
+                setupBlock = {
+                    startActivityAndWait()
+                    enterRoomName(roomName)
+                }
+        ) {
+            joinRoom()
+            leaveRoom()
+        }
+    }
+}
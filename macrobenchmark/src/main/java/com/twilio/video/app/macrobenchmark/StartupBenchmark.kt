@@ -0,0 +1,39 @@
+package com.twilio.video.app.macrobenchmark
+
+import androidx.benchmark.macro.StartupMode
+import androidx.benchmark.macro.StartupTimingMetric
+import androidx.benchmark.macro.junit4.MacrobenchmarkRule
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import androidx.test.platform.app.InstrumentationRegistry
+import androidx.test.uiautomator.UiDevice
+import org.junit.Before
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/** Measures a cold start from the launcher through SplashActivity until the lobby is displayed. */
+@RunWith(AndroidJUnit4::class)
+@LargeTest
+class StartupBenchmark {
+
+    @get:Rule
+    val benchmarkRule = MacrobenchmarkRule()
+
+    @Before
+    fun setUp() {
+        UiDevice.getInstance(InstrumentationRegistry.getInstrumentation()).prepareApp()
+    }
+
+    @Test
+    fun coldStartToLobby() = benchmarkRule.measureRepeated(
+            packageName = TARGET_PACKAGE,
+            metrics = listOf(StartupTimingMetric()),
+            iterations = 10,
+            startupMode = StartupMode.COLD,
+            setupBlock = { pressHome() }
+    ) {
+        startActivityAndWait()
+        device.waitForLobby()
+    }
+}
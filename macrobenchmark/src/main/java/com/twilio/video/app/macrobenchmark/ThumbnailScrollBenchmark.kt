@@ -0,0 +1,57 @@
+package com.twilio.video.app.macrobenchmark
+
+import androidx.benchmark.macro.FrameTimingMetric
+import androidx.benchmark.macro.junit4.MacrobenchmarkRule
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import androidx.test.platform.app.InstrumentationRegistry
+import androidx.test.uiautomator.By
+import androidx.test.uiautomator.Direction
+import androidx.test.uiautomator.UiDevice
+import org.junit.Before
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * Measures the frame timing of flinging through the participant thumbnails of
+ * [benchmarkRoomName], which needs more remote participants than fit on the screen.
+ */
+@RunWith(AndroidJUnit4::class)
+@LargeTest
+class ThumbnailScrollBenchmark {
+
+    @get:Rule
+    val benchmarkRule = MacrobenchmarkRule()
+
+    @Before
+    fun setUp() {
+        UiDevice.getInstance(InstrumentationRegistry.getInstrumentation()).prepareApp()
+    }
+
+    @Test
+    fun scrollThumbnails() {
+        val roomName = benchmarkRoomName
+        benchmarkRule.measureRepeated(
+                packageName = TARGET_PACKAGE,
+                metrics = listOf(FrameTimingMetric()),
+                iterations = 5,
+                setupBlock = {
+                    startActivityAndWait()
+                    enterRoomName(roomName)
+                    joinRoom()
+                }
+        ) {
+            val thumbnails = device.findObject(By.res(TARGET_PACKAGE, "remote_video_thumbnails"))
+            // Keeps the fling from starting at the edge of the screen, which opens the drawer
+            thumbnails.setGestureMargin(device.displayWidth / 10)
+            repeat(2) {
+                thumbnails.fling(Direction.RIGHT)
+                device.waitForIdle()
+                thumbnails.fling(Direction.LEFT)
+                device.waitForIdle()
+            }
+            leaveRoom()
+        }
+    }
+}